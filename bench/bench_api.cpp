@@ -0,0 +1,132 @@
+// This program measures how quickly a C++ program that embeds brex receives
+// the terms of an expansion, for each of:
+//
+// - `std::ostream`: expanding into a `std::ostringstream` and then splitting
+//   its contents back into terms, which is what an embedding program had to
+//   do before `terms.h` existed,
+// - `forEach`: the visitor callback of `brex::Expansion`,
+// - `iterator`: the iterators of `brex::Expansion`.
+//
+// Each term is "consumed" by folding its bytes into a checksum, so that the
+// compiler can't skip the work.  The expression can be given as the first
+// command line argument.  By default, it's one having ten million terms.
+
+#include <brex/odometer.h>
+#include <brex/parse.h>
+#include <brex/terms.h>
+
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <cstdio>   // printf
+#include <cstring>  // memchr
+#include <iostream>
+#include <sstream>  // ostringstream
+#include <string>
+
+namespace {
+
+// `Consumer` stands in for whatever an embedding program does with a term.
+struct Consumer {
+    std::uint64_t checksum = 0;
+    std::uint64_t terms    = 0;
+
+    void operator()(const char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            checksum = checksum * 31 + static_cast<unsigned char>(data[i]);
+        }
+        ++terms;
+    }
+};
+
+Consumer viaOstream(brex::Expansion& expansion) {
+    std::ostringstream stream;
+    expansion.odometer().reset();
+    brex::expand(stream, expansion.odometer(), "\n");
+
+    Consumer          consumer;
+    const std::string output = stream.str();
+    const char*       begin  = output.data();
+    const char* const end    = begin + output.size();
+    for (;;) {
+        const void* const found = std::memchr(begin, '\n', end - begin);
+        const char* const stop =
+            found ? static_cast<const char*>(found) : end;
+        consumer(begin, stop - begin);
+        if (!found) {
+            break;
+        }
+        begin = stop + 1;
+    }
+    return consumer;
+}
+
+Consumer viaForEach(brex::Expansion& expansion) {
+    Consumer consumer;
+    expansion.forEach([&consumer](const char* data, std::size_t size) {
+        consumer(data, size);
+        return true;
+    });
+    return consumer;
+}
+
+Consumer viaIterator(brex::Expansion& expansion) {
+    Consumer consumer;
+    for (const brex::Term term : expansion) {
+        consumer(term.data, term.size);
+    }
+    return consumer;
+}
+
+// Run the specified `method` on the specified `expansion` a few times, and
+// print a line of results labeled with the specified `name`.
+template <typename Method>
+void measure(const char* name, Method method, brex::Expansion& expansion) {
+    const int runs    = 3;
+    double    seconds = 0;
+    Consumer  consumer;
+
+    for (int i = 0; i < runs; ++i) {
+        const auto before = std::chrono::steady_clock::now();
+        consumer          = method(expansion);
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - before;
+        if (i == 0 || elapsed.count() < seconds) {
+            seconds = elapsed.count();
+        }
+    }
+
+    std::printf("%-13s %11llu %8.3f %13.0f %016llx\n",
+                name,
+                static_cast<unsigned long long>(consumer.terms),
+                seconds,
+                consumer.terms / seconds,
+                static_cast<unsigned long long>(consumer.checksum));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string expression =
+        argc > 1 ? argv[1]
+                 : "x{a,b,c,d,e,f,g,h,i,j}{k,l,m,n,o,p,q,r,s,t}"
+                   "{A,B,C,D,E,F,G,H,I,J}{K,L,M,N,O,P,Q,R,S,T}"
+                   "{u,v,w,x,y,z,U,V,W,X}{foo,bar,baz,bam,ban,bat,bay,bad,"
+                   "bag,bah}{ZZ,YY,XX,WW,VV,UU,TT,SS,RR,QQ}";
+
+    brex::Expansion expansion;
+    if (expansion.assign(expression, &std::cerr) !=
+        brex::ParseResult::SUCCESS) {
+        return 1;
+    }
+
+    std::printf("%-13s %11s %8s %13s %16s\n",
+                "method",
+                "terms",
+                "seconds",
+                "terms/s",
+                "checksum");
+    measure("std::ostream", viaOstream, expansion);
+    measure("forEach", viaForEach, expansion);
+    measure("iterator", viaIterator, expansion);
+}
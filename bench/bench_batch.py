@@ -0,0 +1,65 @@
+#!/usr/bin/env python3.7
+"""Measure how many expressions per second brex expands when given many
+small expressions at once with `--batch`, compared to running brex once per
+expression.  The number of expressions in the batch can be given as the
+first command line argument (default 1000000).
+
+Output is written to /dev/null, so what is measured is the cost of producing
+the output rather than the cost of consuming it.
+"""
+
+import common
+
+import os
+import random
+import sys
+
+
+def template(rng):
+    """Return a random expression typical of a template: a few fixed parts
+    and a few small alternations, having a few dozen terms.
+    """
+    def word():
+        length = rng.randint(2, 8)
+        return ''.join(rng.choice('abcdefghij') for _ in range(length))
+
+    parts = []
+    for _ in range(rng.randint(2, 4)):
+        parts.append(word())
+        options = [word() for _ in range(rng.randint(2, 4))]
+        parts.append('{' + ','.join(options) + '}')
+    return ''.join(parts)
+
+
+def main():
+    count = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+    rng = random.Random(1)
+    expressions = [template(rng) for _ in range(count)]
+
+    runs = 3
+    print(f'{"mode":<22} {"expressions":>11} {"seconds":>8} '
+          f'{"expressions/s":>13}')
+
+    path = common.input_file('\n'.join(expressions))
+    try:
+        seconds = common.best_of(runs, path, ['--batch'])
+        print(f'{"--batch":<22} {count:>11} {seconds:>8.3f} '
+              f'{count / seconds:>13.0f}')
+    finally:
+        os.remove(path)
+
+    # Running a process per expression is much slower, so time fewer.
+    sample = expressions[:min(count, 1000)]
+    seconds = 0
+    for expression in sample:
+        path = common.input_file(expression)
+        try:
+            seconds += common.run(path, ['--lines'])[0]
+        finally:
+            os.remove(path)
+    print(f'{"process per expression":<22} {len(sample):>11} {seconds:>8.3f} '
+          f'{len(sample) / seconds:>13.0f}')
+
+
+if __name__ == '__main__':
+    main()
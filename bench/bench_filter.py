@@ -0,0 +1,48 @@
+#!/usr/bin/env python3.7
+"""Compare filtering an expansion with `--prefix` or `--glob` against
+expanding all of it (`--lines`), for filters of varying selectivity.
+
+Output is written to /dev/null.  Where the filter constrains the beginning of
+the terms, the time should follow the number of terms that match, not the
+number of terms in the expansion.  Where it constrains only the end, nothing
+can be skipped: every term is built and checked, though only the matching
+terms are written.
+"""
+
+import common
+
+import os
+
+
+# 10**8 terms of 8 bytes each
+expression = '{a,b,c,d,e,f,g,h,i,j}' * 8
+terms = 10**8
+
+# Each workload is a (flags, matching terms) pair.
+workloads = [
+    (['--lines'], terms),
+    (['--prefix', 'a'], terms // 10),
+    (['--prefix', 'abc'], terms // 1000),
+    (['--prefix', 'abcdef'], terms // 10**6),
+    (['--glob', 'a?c*'], terms // 100),
+    (['--glob', '[a-e][!a-e]*'], terms // 4),
+    (['--glob', '*j'], terms // 10),
+]
+
+
+def main():
+    runs = 3
+    path = common.input_file(expression)
+    try:
+        print(f'{"flags":<24} {"matches":>10} {"seconds":>8} '
+              f'{"Mterms/s":>9}')
+        for flags, matches in workloads:
+            seconds = common.best_of(runs, path, flags)
+            print(f'{" ".join(flags):<24} {matches:>10} {seconds:>8.3f} '
+                  f'{matches / seconds / 1e6:>9.1f}')
+    finally:
+        os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
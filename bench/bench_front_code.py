@@ -0,0 +1,61 @@
+#!/usr/bin/env python3.7
+"""Compare front coded output (`--front-code`) with plain text output
+(`--lines`): the size of each, how quickly brex produces each, and how quickly
+`--decode` turns front coded output back into text.
+
+Output that is timed is written to /dev/null, so what is measured is the cost
+of producing the output rather than the cost of consuming it.  Throughput is
+in millions of terms per second.
+"""
+
+import common
+
+import os
+import tempfile
+
+
+# Each workload is a (name, expression, terms) triple.
+workloads = [
+    # many short terms
+    ('short terms', '{a,b,c,d,e,f,g,h,i,j}' * 7, 10**7),
+    # long shared prefixes, as when expanding paths or host names
+    ('long prefix', 'x' * 100 + '{a,b,c,d,e,f,g,h,i,j}' * 6, 10**6),
+    # terms that differ in many places
+    ('nested', '{a,b{c,d{e,f}}}' * 8, 4**8),
+]
+
+
+def main():
+    runs = 3
+    print(f'{"workload":<12} {"format":<13} {"MB":>9} {"ratio":>6} '
+          f'{"seconds":>8} {"Mterms/s":>9}')
+
+    for name, expression, terms in workloads:
+        path = common.input_file(expression)
+        fd, encoded_path = tempfile.mkstemp(prefix='brex-bench-',
+                                            suffix='.bin')
+        os.close(fd)
+        try:
+            plain_size = common.output_size(path, ['--lines'])
+            common.run(path, ['--front-code'], output_path=encoded_path)
+            encoded_size = os.path.getsize(encoded_path)
+
+            rows = [
+                ('--lines', plain_size,
+                 common.best_of(runs, path, ['--lines'])),
+                ('--front-code', encoded_size,
+                 common.best_of(runs, path, ['--front-code'])),
+                ('--decode', plain_size,
+                 common.best_of(runs, encoded_path, ['--decode', '--lines'])),
+            ]
+            for format, size, seconds in rows:
+                print(f'{name:<12} {format:<13} {size / 1e6:>9.1f} '
+                      f'{size / plain_size:>6.3f} {seconds:>8.3f} '
+                      f'{terms / seconds / 1e6:>9.1f}')
+        finally:
+            os.remove(path)
+            os.remove(encoded_path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3.7
+"""Measure the time and peak memory that brex takes to read and parse a large
+expression, read from standard input and read with `--input`, which maps the
+file rather than copying it.  `--limit 1` is given, so that only the first
+term is expanded.  The size of the expressions, in megabytes, can be given as
+the first command line argument (default 200).
+"""
+
+import common
+
+import os
+import sys
+
+
+def workloads(megabytes):
+    """Return a list of (name, expression) pairs, each expression having
+    about the specified `megabytes` number of megabytes.
+    """
+    size = megabytes << 20
+
+    # one alternation with many options
+    options = ['w' + ''.join(chr(ord('a') + int(digit)) for digit in str(i))
+               for i in range(size // 9)]
+    wide = '{' + ','.join(options) + '}'
+
+    # long literals separated by small alternations
+    part = 'x' * (64 << 10) + '{ab,cd}'
+    long = part * (size // len(part))
+
+    return [('wide', wide[:size].rsplit(',', 1)[0] + '}'), ('long', long)]
+
+
+def main():
+    megabytes = int(sys.argv[1]) if len(sys.argv) > 1 else 200
+    runs = 3
+
+    print(f'{"workload":<10} {"input":<10} {"seconds":>8} {"peak MB":>8}')
+    for name, expression in workloads(megabytes):
+        path = common.input_file(expression)
+        try:
+            for label, input_path, flags in [
+                    ('stdin', path, ['--limit', '1']),
+                    ('--input', os.devnull,
+                     ['--limit', '1', '--input', path])]:
+                results = [common.run(input_path, flags) for _ in range(runs)]
+                assert all(status == 0 for _, _, status in results)
+                seconds = min(seconds for seconds, _, _ in results)
+                peak = min(peak for _, peak, _ in results)
+                print(f'{name:<10} {label:<10} {seconds:>8.3f} '
+                      f'{peak / 1024:>8.1f}')
+        finally:
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,125 @@
+// This program measures how quickly `brex::Automaton` (see `match.h`) tests
+// candidate strings for membership in an expansion, and how long it takes to
+// build the automaton.
+//
+// The candidates are a mix of terms of the expansion and near misses: terms
+// with one letter changed, dropped, or doubled.  The expression can be given
+// as the first command line argument and the number of candidates as the
+// second.  By default, the expression has four million terms, and there are
+// ten million candidates.
+
+#include <brex/arena.h>
+#include <brex/compile.h>
+#include <brex/match.h>
+#include <brex/odometer.h>
+#include <brex/parse.h>
+#include <brex/rank.h>
+
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <cstdio>   // printf
+#include <cstdlib>  // strtoull
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Return the number of seconds elapsed since the specified `before`.
+double secondsSince(std::chrono::steady_clock::time_point before) {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - before;
+    return elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string expression =
+        argc > 1 ? argv[1]
+                 : "{user,admin,guest,service}{alpha,beta,gamma,delta,"
+                   "epsilon}{north,south,east,west,central}{one,two,three,"
+                   "four,five,six,seven,eight,nine,ten}{red,green,blue,cyan,"
+                   "magenta,yellow,black,white}{a,b,c,d,e,f,g,h,i,j}{x,y,z,"
+                   "xx,yy,zz,xy,yx,xz,zx}{app,web,db,cache,queue}";
+    const std::size_t count =
+        argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+
+    brex::Arena         arena;
+    brex::ParseTreeNode tree;
+    if (brex::parse(tree, arena, expression, &std::cerr) !=
+        brex::ParseResult::SUCCESS) {
+        return 1;
+    }
+
+    auto            before = std::chrono::steady_clock::now();
+    brex::Automaton automaton;
+    if (brex::automaton(automaton, tree)) {
+        std::cerr << "Too many automaton states.\n";
+        return 1;
+    }
+    const double buildSeconds = secondsSince(before);
+
+    // Pick some terms at random using the ranking, and then make the
+    // candidates from them, about half of them near misses.  Seeking is much
+    // slower than matching, so it's done at most a hundred thousand times.
+    brex::Program program;
+    brex::compile(program, tree);
+    brex::Ranking  ranking(program);
+    brex::Odometer odometer(program);
+
+    std::mt19937_64          rng(1);
+    std::vector<std::string> sample;
+    const std::uint64_t      terms = ranking.terms().toUint64();
+    for (std::size_t i = 0; i < count && i < 100000; ++i) {
+        odometer.seek(ranking, brex::BigUnsigned(rng() % terms));
+        sample.push_back(odometer.current());
+    }
+
+    std::vector<std::string> candidates;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string       candidate = sample[rng() % sample.size()];
+        const std::size_t position  = rng() % candidate.size();
+        switch (rng() % 8) {
+            case 0:
+                candidate[position] = 'Q';
+                break;
+            case 1:
+                candidate.erase(position, 1);
+                break;
+            case 2:
+                candidate.insert(position, 1, candidate[position]);
+                break;
+            case 3:
+                candidate.push_back('s');
+                break;
+        }
+        candidates.push_back(candidate);
+    }
+
+    std::uint64_t matches = 0;
+    before                = std::chrono::steady_clock::now();
+    for (const std::string& candidate : candidates) {
+        matches += automaton.accepts(candidate.data(), candidate.size());
+    }
+    const double matchSeconds = secondsSince(before);
+
+    std::printf("expression terms:     %llu\n"
+                "automaton states:     %d\n"
+                "automaton columns:    %d\n"
+                "build seconds:        %.6f\n"
+                "candidates:           %llu\n"
+                "matches:              %llu\n"
+                "match seconds:        %.3f\n"
+                "candidates/s:         %.0f\n",
+                static_cast<unsigned long long>(terms),
+                automaton.states(),
+                automaton.columns,
+                buildSeconds,
+                static_cast<unsigned long long>(candidates.size()),
+                static_cast<unsigned long long>(matches),
+                matchSeconds,
+                candidates.size() / matchSeconds);
+}
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3.7
+"""Measure the output throughput of brex, in gigabytes per second, for each
+of its output paths:
+
+- `--tree`: the original tree of expanders, writing through `std::cout`,
+- `--ostream`: the compiled engine, writing through `std::cout`,
+- the default: the compiled engine, writing through a `Sink`, using several
+  buffer sizes,
+- `-0` and `--length-prefixed`: the same, in the record formats meant for
+  other programs to read.
+
+Output is written to /dev/null, so what is measured is the cost of producing
+the output rather than the cost of consuming it.  Throughput is computed
+from the size of the default output, which a length prefix of more than one
+byte makes slightly smaller than the real thing.
+"""
+
+import common
+
+import os
+
+
+# Each workload is a (name, expression) pair.
+workloads = [
+    # many short terms
+    ('short terms', '{a,b,c,d,e,f,g,h,i,j}' * 7),
+    # fewer, longer terms
+    ('long terms', 'x' * 200 + '{a,b,c,d,e,f,g,h,i,j}' * 5 + 'y' * 200),
+    # terms that differ in many places
+    ('nested', '{a,b{c,d{e,f}}}' * 8),
+]
+
+configurations = [
+    ('--tree', ['--tree']),
+    ('--ostream', ['--ostream']),
+    ('sink 64 KiB', ['--buffer-size', str(64 << 10)]),
+    ('sink 1 MiB (default)', []),
+    ('sink 16 MiB', ['--buffer-size', str(16 << 20)]),
+    ('-0', ['-0']),
+    ('--length-prefixed', ['--length-prefixed']),
+]
+
+
+def main():
+    runs = 3
+    print(f'{"workload":<14} {"configuration":<22} {"seconds":>8} '
+          f'{"GB/s":>7}')
+
+    for name, expression in workloads:
+        path = common.input_file(expression)
+        try:
+            size = common.output_size(path)
+            for configuration, flags in configurations:
+                seconds = common.best_of(runs, path, flags)
+                print(f'{name:<14} {configuration:<22} {seconds:>8.3f} '
+                      f'{size / seconds / 1e9:>7.3f}')
+        finally:
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3.7
+"""Measure the throughput of brex, in gigabytes per second, writing an
+expansion to a file on disk:
+
+- `stdout`: standard output redirected to the file, as with `brex > FILE`,
+- `--output`: the file allocated up front and written through a memory
+  mapping, using one thread and then several.
+
+The file is written in the directory given as the first command line
+argument, or in the system's temporary directory by default, and is deleted
+after each run.  What is measured includes the cost of the file system
+accepting the output into its cache, but not of writing that cache to the
+disk.  The thread counts measured go up to the number of processors.
+"""
+
+import common
+
+import os
+import sys
+import tempfile
+
+
+workloads = [
+    # many short terms
+    ('short terms', '{a,b,c,d,e,f,g,h,i,j}' * 8),
+    # fewer, longer terms
+    ('long terms', 'x' * 200 + '{a,b,c,d,e,f,g,h,i,j}' * 6 + 'y' * 200),
+]
+
+
+def main():
+    directory = sys.argv[1] if len(sys.argv) > 1 else tempfile.gettempdir()
+    output_path = os.path.join(directory, f'brex-bench-{os.getpid()}.out')
+
+    max_threads = os.cpu_count() or 1
+    thread_counts = sorted(set([1, 4, max_threads]))
+    configurations = [('stdout', None)] + [
+        (f'--output, {threads} thread{"s" if threads > 1 else ""}',
+         ['--output', output_path, '--threads', str(threads)])
+        for threads in thread_counts]
+
+    runs = 3
+    print(f'{"workload":<12} {"configuration":<22} {"seconds":>8} '
+          f'{"GB/s":>7}')
+
+    for name, expression in workloads:
+        path = common.input_file(expression)
+        try:
+            size = common.output_size(path)
+            for configuration, flags in configurations:
+                best = None
+                for _ in range(runs):
+                    if flags is None:
+                        seconds, _, _ = common.run(path,
+                                                   output_path=output_path)
+                    else:
+                        seconds, _, _ = common.run(path, flags)
+                    assert os.path.getsize(output_path) == size
+                    os.remove(output_path)
+                    best = min(best or seconds, seconds)
+                print(f'{name:<12} {configuration:<22} {best:>8.3f} '
+                      f'{size / best / 1e9:>7.3f}')
+        finally:
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3.7
+"""Measure the time and peak memory that brex spends parsing a large
+expression and building its expansion machinery, for each of:
+
+- `--tree`: the parse tree and the tree of expanders built from it,
+- the default: the parse tree and the program compiled from it.
+
+Only the first term is printed (`--limit 1`), so what is measured is almost
+entirely the cost of parsing and building.  The size of the generated input,
+in megabytes, can be given as the first command line argument (default 100).
+
+To compare against another build of brex (e.g. one built from an earlier
+commit), set the "BREX_BASELINE" environment variable to the path of its
+binary.
+"""
+
+import common
+
+import os
+import sys
+
+
+# Each input is a (name, unit) pair.  The generated expression repeats the
+# unit until it is large enough.
+inputs = [
+    # many parse tree nodes per byte of input
+    ('small nodes', 'ab{cd,e{f,gh},i}jk{l,m}'),
+    # long strings, where the cost is mostly that of scanning letters
+    ('long strings', '{' + 'abcdefghijKLMNOPQRST' * 10 + ',' +
+                     'xyz' * 50 + '}' + 'Q' * 300),
+]
+
+
+def generate(unit, size):
+    """Return an expression of at least the specified `size` bytes that
+    repeats the specified `unit`.
+    """
+    return unit * (size // len(unit) + 1)
+
+
+configurations = [
+    ('--tree', ['--tree', '--limit', '1']),
+    ('compiled', ['--limit', '1']),
+]
+
+
+def main():
+    megabytes = int(sys.argv[1]) if len(sys.argv) > 1 else 100
+    executables = [('current', common.brex_path())]
+    if 'BREX_BASELINE' in os.environ:
+        executables.append(('baseline', os.environ['BREX_BASELINE']))
+
+    runs = 3
+    print(f'{"input":<13} {"binary":<9} {"configuration":<14} '
+          f'{"seconds":>8} {"peak RSS MB":>11}')
+
+    for name, unit in inputs:
+        path = common.input_file(generate(unit, megabytes * 1000000))
+        try:
+            for configuration, flags in configurations:
+                for binary, executable in executables:
+                    results = [common.run(path, flags, executable)
+                               for _ in range(runs)]
+                    seconds = min(elapsed for elapsed, _, _ in results)
+                    kilobytes = min(maxrss for _, maxrss, _ in results)
+                    print(f'{name:<13} {binary:<9} {configuration:<14} '
+                          f'{seconds:>8.3f} {kilobytes / 1000:>11.1f}')
+        finally:
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3.7
+"""Measure how long `--sample` takes to draw terms from expansions of very
+different sizes, with and without `--distinct`.
+
+Each term is found directly from its index, so the time should depend on the
+number of terms drawn and on the size of the expression, but not on the
+number of terms in the expansion, except that larger counts take more
+arithmetic to divide up.  The expressions below have the same number of
+alternations, but their expansions range from about a million terms to
+10^60.
+"""
+
+import common
+
+import os
+
+
+# Each workload is a (name, expression) pair.  Each expression has 60
+# alternations.
+workloads = [
+    ('2^20 terms', '{a,b}' * 20 + '{a}' * 40),
+    ('10^20 terms', '{a,b,c,d,e,f,g,h,i,j}' * 10 + '{a}' * 50),
+    ('10^60 terms', '{a,b,c,d,e,f,g,h,i,j}' * 60),
+]
+
+
+def main():
+    runs = 3
+    count = 10**5
+    print(f'{"expansion":<12} {"flags":<11} {"seconds":>8} {"kterms/s":>9}')
+
+    for name, expression in workloads:
+        path = common.input_file(expression)
+        try:
+            for flags in [[], ['--distinct']]:
+                sample = ['--sample', str(count), '--seed', '1']
+                seconds = common.best_of(runs, path, sample + flags)
+                print(f'{name:<12} {" ".join(flags):<11} {seconds:>8.3f} '
+                      f'{count / seconds / 1e3:>9.1f}')
+        finally:
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,278 @@
+// This program is a load generator for `brex --serve` (see `serve.h`).  It
+// measures the latency of requests, and how many requests per second the
+// server answers, when a number of clients each send one expression at a
+// time and wait for its record before sending the next.
+//
+// The expressions are drawn at random from a few thousand templates: a few
+// fixed parts and a few small alternations, having a few dozen terms each.
+//
+// The number of clients can be given as the first command line argument
+// (default 8), and the number of seconds to run as the second (default 2).
+// If the path to the socket of a running server is given as the third, then
+// that server is measured.  Otherwise, a `brex::Server` is started within
+// this program, and measured first with its `ProgramCache` and then without.
+
+#include <brex/serve.h>
+
+#include <algorithm>  // nth_element
+#include <atomic>
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <cstdio>   // printf
+#include <cstdlib>  // strtod, strtoul
+#include <cstring>  // memcpy
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdlib.h>      // mkdtemp
+#include <sys/socket.h>  // connect, recv, send, socket
+#include <sys/un.h>      // sockaddr_un
+#include <unistd.h>      // close, rmdir
+
+namespace {
+
+// how many distinct expressions the clients send
+const int TEMPLATES = 2000;
+
+// Return a random expression typical of a template, generated using the
+// specified `rng`.
+std::string makeTemplate(std::mt19937_64& rng) {
+    const auto word = [&] {
+        std::string result(2 + rng() % 7, 'a');
+        for (char& letter : result) {
+            letter = char('a' + rng() % 10);
+        }
+        return result;
+    };
+
+    std::string result;
+    for (int parts = 2 + rng() % 3; parts; --parts) {
+        result += word() + "{";
+        for (int options = 2 + rng() % 3; options; --options) {
+            result += word() + (options > 1 ? "," : "}");
+        }
+    }
+    return result;
+}
+
+// Return a socket connected to the server listening at the specified `path`,
+// or -1 if the connection fails.
+int connectTo(const std::string& path) {
+    struct sockaddr_un address = {};
+    address.sun_family         = AF_UNIX;
+    if (path.size() >= sizeof address.sun_path) {
+        return -1;
+    }
+    std::memcpy(address.sun_path, path.data(), path.size());
+
+    const int fileDescriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fileDescriptor != -1 &&
+        ::connect(fileDescriptor,
+                  reinterpret_cast<const struct sockaddr*>(&address),
+                  sizeof address)) {
+        ::close(fileDescriptor);
+        return -1;
+    }
+    return fileDescriptor;
+}
+
+// Return the length of the record at the beginning of the specified
+// `received` bytes, or zero if the record is incomplete.  See `batch.h`.
+std::size_t recordLength(const std::string& received) {
+    const std::size_t status = received.find('\n');
+    if (status == std::string::npos || status + 1 == received.size()) {
+        return 0;
+    }
+    if (received.compare(0, status, "0") != 0) {
+        return status + 2;  // an invalid expression has no terms
+    }
+    const std::size_t end = received.find("\n\n", status + 1);
+    return end == std::string::npos ? 0 : end + 2;
+}
+
+// `Client` is one connection's requests and their latencies.
+struct Client {
+    std::vector<double> latencies;  // in seconds
+    bool                failed;
+};
+
+// Send requests on a new connection to the server at the specified `path`
+// until the specified `done` is set, choosing each from the specified
+// `templates` using a generator seeded with the specified `seed`, and record
+// into the specified `client` the latency of each.
+void runClient(Client&                         client,
+               const std::string&              path,
+               const std::vector<std::string>& templates,
+               std::uint64_t                   seed,
+               const std::atomic<bool>&        done) {
+    client.failed = true;
+
+    const int fileDescriptor = connectTo(path);
+    if (fileDescriptor == -1) {
+        return;
+    }
+
+    std::mt19937_64 rng(seed);
+    std::string     received;
+    char            buffer[1 << 16];
+
+    while (!done) {
+        const std::string request = templates[rng() % templates.size()] + "\n";
+        const auto        before  = std::chrono::steady_clock::now();
+
+        if (::send(fileDescriptor, request.data(), request.size(), 0) !=
+            ssize_t(request.size())) {
+            ::close(fileDescriptor);
+            return;
+        }
+
+        received.clear();
+        while (recordLength(received) == 0) {
+            const ssize_t count =
+                ::recv(fileDescriptor, buffer, sizeof buffer, 0);
+            if (count <= 0) {
+                ::close(fileDescriptor);
+                return;
+            }
+            received.append(buffer, count);
+        }
+
+        const std::chrono::duration<double> latency =
+            std::chrono::steady_clock::now() - before;
+        client.latencies.push_back(latency.count());
+    }
+
+    ::close(fileDescriptor);
+    client.failed = false;
+}
+
+// Return the specified `fraction` quantile of the specified `values`, which
+// are reordered.  The behavior is undefined if `values` is empty.
+double quantile(std::vector<double>& values, double fraction) {
+    const auto position =
+        values.begin() + std::size_t(fraction * (values.size() - 1));
+    std::nth_element(values.begin(), position, values.end());
+    return *position;
+}
+
+// Run the specified `clients` number of clients against the server at the
+// specified `path` for the specified `seconds`, sending the specified
+// `templates`, and print a line of results labeled with the specified
+// `label`.  Return zero on success or a nonzero value if a client failed.
+int measure(const char*                     label,
+            const std::string&              path,
+            const std::vector<std::string>& templates,
+            int                             clients,
+            double                          seconds) {
+    std::atomic<bool>        done(false);
+    std::vector<Client>      results(clients);
+    std::vector<std::thread> threads;
+
+    const auto before = std::chrono::steady_clock::now();
+    for (int i = 0; i < clients; ++i) {
+        threads.emplace_back(runClient,
+                             std::ref(results[i]),
+                             std::cref(path),
+                             std::cref(templates),
+                             std::uint64_t(i + 1),
+                             std::cref(done));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    done = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - before;
+
+    std::vector<double> latencies;
+    for (const Client& client : results) {
+        if (client.failed) {
+            std::cerr << "A client was unable to talk to the server at "
+                      << path << ".\n";
+            return 1;
+        }
+        latencies.insert(
+            latencies.end(), client.latencies.begin(), client.latencies.end());
+    }
+    if (latencies.empty()) {
+        std::cerr << "No requests completed.\n";
+        return 1;
+    }
+
+    std::printf("%-10s %7d %10zu %12.0f %10.1f %10.1f\n",
+                label,
+                clients,
+                latencies.size(),
+                latencies.size() / elapsed.count(),
+                quantile(latencies, 0.5) * 1e6,
+                quantile(latencies, 0.99) * 1e6);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int    clients = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    const double seconds = argc > 2 ? std::strtod(argv[2], nullptr) : 2;
+
+    std::mt19937_64          rng(1);
+    std::vector<std::string> templates;
+    for (int i = 0; i < TEMPLATES; ++i) {
+        templates.push_back(makeTemplate(rng));
+    }
+
+    std::printf("%-10s %7s %10s %12s %10s %10s\n",
+                "server",
+                "clients",
+                "requests",
+                "requests/s",
+                "p50 us",
+                "p99 us");
+
+    if (argc > 3) {
+        return measure("external", argv[3], templates, clients, seconds);
+    }
+
+    char directory[] = "/tmp/brex-bench-XXXXXX";
+    if (!::mkdtemp(directory)) {
+        std::cerr << "Unable to create a temporary directory.\n";
+        return 1;
+    }
+    const std::string path = std::string(directory) + "/brex.sock";
+
+    int status = 0;
+    for (const bool cached : {true, false}) {
+        brex::ProgramCache cache(cached ? brex::ProgramCache::DEFAULT_CAPACITY
+                                        : 0);
+        brex::Server       server(
+            cache, std::uint64_t(-1), brex::Server::DEFAULT_BUFFER_SIZE);
+        if (server.open(path, &std::cerr)) {
+            status = 1;
+            break;
+        }
+
+        const unsigned processors = std::thread::hardware_concurrency();
+        std::thread    serving(
+            &brex::Server::run, &server, processors ? int(processors) : 1);
+
+        status = measure(cached ? "cached" : "uncached",
+                         path,
+                         templates,
+                         clients,
+                         seconds);
+
+        server.stop();
+        serving.join();
+        if (status) {
+            break;
+        }
+    }
+
+    ::rmdir(directory);
+    return status;
+}
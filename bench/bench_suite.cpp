@@ -0,0 +1,346 @@
+// This program measures each stage of brex on a set of generated workloads,
+// and prints the results as JSON to standard output, so that the results of
+// one build can be saved and compared with those of another (see
+// `bench/compare.py`).
+//
+// The stages are:
+//
+// - `parse`: parsing the expression into a parse tree,
+// - `toJson`: printing the parse tree as JSON, as `brex --parse` does,
+// - `expander`: assembling a tree of `Expander` objects from the parse tree,
+// - `expand`: expanding that tree into a `std::ostream`, as `brex --tree`
+//   does,
+// - `compile`: compiling the parse tree into a `Program`,
+// - `readImage`: loading that `Program` from its image, as `brex --load`
+//   does once the image is mapped,
+// - `odometer`: expanding the program, as `brex` does by default.
+//
+// The expansion stages stop after `EXPAND_TERMS` terms, or after about
+// `EXPAND_BYTES` bytes, so that a workload with a huge expansion measures
+// throughput rather than patience.  Output is written to a stream that only
+// counts bytes.
+//
+// Each stage is run in batches of iterations, where the batch size is
+// doubled until a batch takes at least `MIN_BATCH_SECONDS`.  The reported
+// time per iteration is that of the fastest of `BATCHES` batches.
+//
+// If a command line argument is given, then only the benchmarks whose
+// "workload/stage" name contains the argument are run.
+
+#include <brex/arena.h>
+#include <brex/compile.h>
+#include <brex/expand.h>
+#include <brex/image.h>
+#include <brex/odometer.h>
+#include <brex/parse.h>
+#include <brex/terms.h>
+
+#include <algorithm>  // count, max, min
+#include <chrono>
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <cstdio>   // printf
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+// the most terms that an expansion stage produces per iteration
+const std::uint64_t EXPAND_TERMS = 1000000;
+
+// roughly the most bytes that an expansion stage produces per iteration,
+// judging by the length of the first term
+const std::uint64_t EXPAND_BYTES = 8 << 20;
+
+// the least time that a batch of iterations takes, once calibrated
+const double MIN_BATCH_SECONDS = 0.05;
+
+// how many calibrated batches of each benchmark are run
+const int BATCHES = 3;
+
+// `CountingBuffer` is a stream buffer that discards its output, and counts
+// how many bytes, and how many newlines, it has discarded.
+class CountingBuffer : public std::streambuf {
+    std::uint64_t byteCount;
+    std::uint64_t newlineCount;
+
+  protected:
+    int_type overflow(int_type character) override {
+        if (!traits_type::eq_int_type(character, traits_type::eof())) {
+            ++byteCount;
+            newlineCount += character == '\n';
+        }
+        return traits_type::not_eof(character);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize size) override {
+        byteCount += size;
+        newlineCount += std::count(data, data + size, '\n');
+        return size;
+    }
+
+  public:
+    CountingBuffer()
+    : byteCount(0)
+    , newlineCount(0) {
+    }
+
+    std::uint64_t bytes() const {
+        return byteCount;
+    }
+
+    std::uint64_t newlines() const {
+        return newlineCount;
+    }
+};
+
+// `Work` is what one iteration of a benchmark did.
+struct Work {
+    std::uint64_t items;  // e.g. terms expanded, or zero if not applicable
+    std::uint64_t bytes;  // e.g. bytes parsed or written
+};
+
+// `Workload` is a named expression.
+struct Workload {
+    const char* name;
+    std::string expression;
+};
+
+// Return a distinct nonempty string of letters for each of the specified
+// `index`.
+std::string word(int index) {
+    std::string result;
+    do {
+        result += char('a' + index % 26);
+        index /= 26;
+    } while (index);
+    return result;
+}
+
+std::vector<Workload> workloads() {
+    std::vector<Workload> result;
+
+    // one alternation with many options
+    std::string wide = "{";
+    for (int i = 0; i < 100000; ++i) {
+        wide += (i ? "," : "") + word(i);
+    }
+    wide += "}";
+    result.push_back({"wide", wide});
+
+    // alternations nested within alternations, as deep as `--tree` allows
+    const int   depth = brex::MAX_EXPANDER_DEPTH / 3;
+    std::string deep;
+    for (int i = 0; i < depth; ++i) {
+        deep += "{" + word(i) + ",";
+    }
+    deep += "x" + std::string(depth, '}');
+    result.push_back({"deep", deep});
+
+    // few terms, each several kilobytes long
+    std::string longLiterals;
+    for (int i = 0; i < 4; ++i) {
+        longLiterals += "{";
+        for (int j = 0; j < 4; ++j) {
+            longLiterals += (j ? "," : "") + std::string(1000, 'a' + i + j);
+        }
+        longLiterals += "}";
+    }
+    result.push_back({"long literals", longLiterals});
+
+    // ten million short terms
+    std::string crossProduct;
+    for (int i = 0; i < 7; ++i) {
+        crossProduct += "{a,b,c,d,e,f,g,h,i,j}";
+    }
+    result.push_back({"cross product", crossProduct});
+
+    // ten million numbered terms, most of which differ from the one before
+    // only in their last digit or two
+    result.push_back({"ranges", "host{0000..9999}x{1..1000}"});
+
+    // 2^20000 terms, each passing through twenty thousand slots
+    std::string manySlots;
+    for (int i = 0; i < 20000; ++i) {
+        manySlots += "{a,b}";
+    }
+    result.push_back({"many slots", manySlots});
+
+    // alternations having only one option, nested, where every node of the
+    // parse tree does nothing
+    result.push_back({"singletons",
+                      std::string(depth, '{') + "a" +
+                          std::string(depth, '}')});
+
+    return result;
+}
+
+// Run the specified `operation` in calibrated batches, and print a JSON
+// object describing the fastest, named by the specified `workload` and
+// `stage`, preceded by the specified `separator`.
+template <typename Operation>
+void measure(const char* separator,
+             const char* workload,
+             const char* stage,
+             Operation   operation) {
+    typedef std::chrono::steady_clock Clock;
+
+    long   iterations = 1;
+    double best       = 0;
+    Work   work       = {0, 0};
+
+    for (int batch = 0; batch < BATCHES;) {
+        const Clock::time_point before = Clock::now();
+        for (long i = 0; i < iterations; ++i) {
+            work = operation();
+        }
+        const std::chrono::duration<double> elapsed = Clock::now() - before;
+
+        if (elapsed.count() < MIN_BATCH_SECONDS && batch == 0) {
+            iterations *= 2;  // still calibrating
+            continue;
+        }
+
+        const double seconds = elapsed.count() / iterations;
+        if (batch == 0 || seconds < best) {
+            best = seconds;
+        }
+        ++batch;
+    }
+
+    std::printf("%s\n    {\"workload\": \"%s\", \"stage\": \"%s\", "
+                "\"iterations\": %ld, \"seconds\": %.9g, \"items\": %llu, "
+                "\"bytes\": %llu, \"items_per_second\": %.6g, "
+                "\"bytes_per_second\": %.6g}",
+                separator,
+                workload,
+                stage,
+                iterations,
+                best,
+                static_cast<unsigned long long>(work.items),
+                static_cast<unsigned long long>(work.bytes),
+                work.items / best,
+                work.bytes / best);
+    std::fflush(stdout);
+}
+
+// `Runner` runs the benchmarks of one workload that aren't filtered out,
+// printing a separator between each.
+struct Runner {
+    const Workload*    workload;
+    const std::string* filter;
+    const char*        separator;
+
+    // Run the benchmark of the specified `stage` using the specified
+    // `operation`, unless its name doesn't contain `filter`.
+    template <typename Operation>
+    void operator()(const char* stage, Operation operation) {
+        const std::string name = std::string(workload->name) + "/" + stage;
+        if (name.find(*filter) != std::string::npos) {
+            measure(separator, workload->name, stage, operation);
+            separator = ",";
+        }
+    }
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string filter = argc > 1 ? argv[1] : "";
+    Runner            run    = {nullptr, &filter, ""};
+
+    std::printf("{\"benchmarks\": [");
+
+    for (const Workload& workload : workloads()) {
+        const std::string& expression = workload.expression;
+
+        brex::Arena         arena;
+        brex::ParseTreeNode tree;
+        if (brex::parse(tree, arena, expression, &std::cerr) !=
+            brex::ParseResult::SUCCESS) {
+            return 1;
+        }
+
+        brex::Program program;
+        brex::compile(program, tree);
+        brex::Expander& expander = brex::expander(arena, tree);
+        brex::Odometer  odometer(program);
+
+        std::string image;
+        brex::writeImage(image, program, brex::cardinality(tree));
+
+        const std::uint64_t limit = std::max<std::uint64_t>(
+            1,
+            std::min(EXPAND_TERMS,
+                     EXPAND_BYTES / (odometer.current().size() + 1)));
+
+        run.workload = &workload;
+
+        run("parse", [&]() {
+            brex::Arena         scratch;
+            brex::ParseTreeNode output;
+            brex::parse(output, scratch, expression);
+            return Work{0, expression.size()};
+        });
+
+        run("toJson", [&]() {
+            CountingBuffer buffer;
+            std::ostream   stream(&buffer);
+            brex::toJson(stream, tree);
+            return Work{0, buffer.bytes()};
+        });
+
+        run("expander", [&]() {
+            brex::Arena scratch;
+            brex::expander(scratch, tree);
+            return Work{0, 0};
+        });
+
+        // Each iteration of `expand` and of `odometer` picks up after the
+        // last term of the previous one, and starts over after the last term
+        // of the expansion.
+        run("expand", [&]() {
+            CountingBuffer buffer;
+            std::ostream   stream(&buffer);
+            brex::expand(stream, expander, "\n", limit);
+            const std::uint64_t terms = buffer.newlines() + 1;
+            if (terms == limit) {
+                expander.advance();
+            }
+            return Work{terms, buffer.bytes() + 1};  // and a newline
+        });
+
+        run("compile", [&]() {
+            brex::Program output;
+            brex::compile(output, tree);
+            return Work{0, 0};
+        });
+
+        run("readImage", [&]() {
+            brex::Program     output;
+            brex::Cardinality cardinality;
+            brex::readImage(
+                output, cardinality, image.data(), image.size(), nullptr);
+            return Work{0, image.size()};
+        });
+
+        run("odometer", [&]() {
+            std::uint64_t bytes     = 0;
+            std::uint64_t remaining = limit;
+            const std::uint64_t terms = brex::forEachTerm(
+                odometer, [&](const char*, std::size_t size) {
+                    bytes += size + 1;  // and a separator or newline
+                    return --remaining != 0;
+                });
+            if (terms == limit) {
+                odometer.advance();
+            }
+            return Work{terms, bytes};
+        });
+    }
+
+    std::printf("\n]}\n");
+}
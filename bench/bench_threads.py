@@ -0,0 +1,55 @@
+#!/usr/bin/env python3.7
+"""Measure how the expansion throughput of brex scales with the number of
+threads given by `--threads`.  By default, thread counts from one up to the
+number of processors are measured.  A different maximum can be given as the
+first command line argument.
+
+Output is written to /dev/null, so what is measured is the cost of producing
+the output rather than the cost of consuming it.
+"""
+
+import common
+
+import os
+import sys
+
+
+workloads = [
+    # many short terms
+    ('short terms', '{a,b,c,d,e,f,g,h,i,j}' * 8),
+    # fewer, longer terms
+    ('long terms', 'x' * 500 + '{a,b,c,d,e,f,g,h,i,j}' * 6 + 'y' * 500),
+]
+
+
+def main():
+    if len(sys.argv) > 1:
+        max_threads = int(sys.argv[1])
+    else:
+        max_threads = os.cpu_count() or 1
+
+    thread_counts = sorted(set([1, 2, 4, 8, 16, 32, 64, max_threads]))
+    thread_counts = [count for count in thread_counts if count <= max_threads]
+
+    runs = 3
+    print(f'{"workload":<12} {"threads":>7} {"seconds":>8} {"GB/s":>7} '
+          f'{"speedup":>7}')
+
+    for name, expression in workloads:
+        path = common.input_file(expression)
+        try:
+            size = common.output_size(path)
+            baseline = None
+            for threads in thread_counts:
+                seconds = common.best_of(runs, path,
+                                         ['--threads', str(threads)])
+                baseline = baseline or seconds
+                print(f'{name:<12} {threads:>7} {seconds:>8.3f} '
+                      f'{size / seconds / 1e9:>7.3f} '
+                      f'{baseline / seconds:>7.2f}')
+        finally:
+            os.remove(path)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,76 @@
+# This is code shared by the benchmark drivers.  It is meant to be imported
+# as a python module, not to be executed as a script.
+
+import os
+import subprocess
+import tempfile
+import time
+
+
+def brex_path():
+    """Return the path to the brex command line tool.  Use the value of the
+    "BREX" environment variable, if present, and otherwise use "./brex".
+    """
+    return os.environ.get('BREX', './brex')
+
+
+def input_file(expression):
+    """Return the path to a new temporary file containing the specified
+    `expression` followed by a newline.  The caller is responsible for
+    deleting the file.
+    """
+    fd, path = tempfile.mkstemp(prefix='brex-bench-', suffix='.txt')
+    with os.fdopen(fd, 'w') as file:
+        file.write(expression)
+        file.write('\n')
+    return path
+
+
+def run(input_path, flags=[], executable_path=None, output_path=os.devnull):
+    """Run brex once with standard input read from the file at the specified
+    `input_path` and with the specified command line `flags`, writing
+    standard output to the file at the optionally specified `output_path`.
+    Use the optionally specified `executable_path` or, if it's `None`, the
+    result of `brex_path()`.  Return a tuple having three elements:
+
+    - the elapsed wall time in seconds,
+    - the peak resident set size of the process in kilobytes,
+    - the integer status code returned by the process.
+    """
+    path = executable_path or brex_path()
+    with open(input_path, 'rb') as stdin, open(output_path, 'wb') as stdout:
+        before = time.perf_counter()
+        process = subprocess.Popen([path] + flags, stdin=stdin, stdout=stdout)
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - before
+
+    if os.WIFEXITED(status):
+        code = os.WEXITSTATUS(status)
+    else:
+        code = -os.WTERMSIG(status)
+    process.returncode = code  # so that `process` knows it was reaped
+
+    return elapsed, usage.ru_maxrss, code
+
+
+def best_of(count, input_path, flags=[], executable_path=None):
+    """Return the smallest elapsed wall time, in seconds, of the specified
+    `count` runs of brex having the specified `input_path`, command line
+    `flags`, and `executable_path`.  See `run`.
+    """
+    return min(run(input_path, flags, executable_path)[0]
+               for _ in range(count))
+
+
+def output_size(input_path, flags=[], executable_path=None):
+    """Return the number of bytes that brex writes to standard output given
+    the specified `input_path`, command line `flags`, and `executable_path`.
+    See `run`.
+    """
+    fd, path = tempfile.mkstemp(prefix='brex-bench-', suffix='.out')
+    os.close(fd)
+    try:
+        run(input_path, flags, executable_path, output_path=path)
+        return os.path.getsize(path)
+    finally:
+        os.remove(path)
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3.7
+"""Compare two results files written by `bench/bench_suite`, e.g. those of
+the previous release and of the current build:
+
+    $ ./bench/bench_suite >new.json
+    $ python3.7 bench/compare.py old.json new.json
+
+For each benchmark in both files, print the time per iteration in each and
+the ratio of the new time to the old.  Exit with status 1 if any benchmark is
+slower by more than the threshold (10% unless `--threshold` is given).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """Return a dict mapping (workload, stage) to the time per iteration in
+    seconds, read from the bench_suite results file at the specified `path`.
+    """
+    with open(path) as file:
+        results = json.load(file)
+    return {(benchmark['workload'], benchmark['stage']): benchmark['seconds']
+            for benchmark in results['benchmarks']}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('old')
+    parser.add_argument('new')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='largest tolerated slowdown, as a fraction')
+    options = parser.parse_args()
+
+    old = load(options.old)
+    new = load(options.new)
+
+    print(f'{"benchmark":<26} {"old s":>11} {"new s":>11} {"new/old":>8}')
+    regressions = 0
+    for key in sorted(old.keys() & new.keys()):
+        ratio = new[key] / old[key]
+        slower = ratio > 1 + options.threshold
+        regressions += slower
+        print(f'{"/".join(key):<26} {old[key]:>11.6f} {new[key]:>11.6f} '
+              f'{ratio:>8.3f}{"  slower" if slower else ""}')
+
+    for key in sorted(old.keys() ^ new.keys()):
+        print(f'{"/".join(key):<26} only in '
+              f'{options.old if key in old else options.new}')
+
+    if regressions:
+        print(f'{regressions} benchmark(s) slower by more than '
+              f'{options.threshold:.0%}.')
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,67 @@
+#include <brex/arena.h>
+
+#include <algorithm>  // max
+
+namespace brex {
+namespace {
+
+// the size of the first block that an arena allocates
+const std::size_t INITIAL_BLOCK_SIZE = 4096;
+
+}  // namespace
+
+// class Arena
+// -----------
+
+Arena::Arena()
+: blockSize(0)
+, cursor(nullptr)
+, limit(nullptr)
+, reserved(0) {
+}
+
+Arena::~Arena() {
+    for (char* block : blocks) {
+        delete[] block;
+    }
+}
+
+void Arena::grow(std::size_t size) {
+    // Double the block size each time, so that the number of blocks is
+    // logarithmic in the total allocated.
+    blockSize = std::max(std::max(INITIAL_BLOCK_SIZE, 2 * blockSize), size);
+
+    char* const block = new char[blockSize];
+    blocks.push_back(block);
+    cursor = block;
+    limit  = block + blockSize;
+    reserved += blockSize;
+}
+
+void Arena::reset() {
+    if (blocks.empty()) {
+        return;
+    }
+
+    // The most recent block is also the largest.
+    char* const largest = blocks.back();
+    blocks.pop_back();
+    for (char* block : blocks) {
+        delete[] block;
+    }
+
+    blocks.assign(1, largest);
+    cursor   = largest;
+    limit    = largest + blockSize;
+    reserved = blockSize;
+}
+
+std::size_t Arena::blockCount() const {
+    return blocks.size();
+}
+
+std::size_t Arena::bytesReserved() const {
+    return reserved;
+}
+
+}  // namespace brex
@@ -0,0 +1,96 @@
+#ifndef INCLUDED_BREX_ARENA
+#define INCLUDED_BREX_ARENA
+
+#include <cstddef>  // size_t
+#include <new>      // placement new
+#include <utility>  // forward
+#include <vector>
+
+namespace brex {
+
+// `Arena` is a monotonic allocator.  Memory is carved sequentially out of
+// large blocks, and is freed all at once when the arena is reset or
+// destroyed, rather than object by object.  This makes allocation cheap and
+// keeps objects allocated together close together in memory.
+//
+// The objects created in an arena are never destroyed.  Only create objects
+// whose destructors do nothing.
+class Arena {
+    std::vector<char*> blocks;     // all blocks, most recently allocated last
+    std::size_t        blockSize;  // size of the most recent block
+    char*              cursor;     // next free byte in the most recent block
+    char*              limit;      // end of the most recent block
+    std::size_t        reserved;   // total size of all blocks
+
+    // Allocate a new block having room for at least the specified `size`
+    // bytes, and make it the current block.
+    void grow(std::size_t size);
+
+  public:
+    // Create an empty arena.
+    Arena();
+
+    // Free all memory allocated by this arena.
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Return a pointer to the specified `size` bytes of storage aligned to
+    // the specified `alignment`, which must be a power of two.
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    // Return a pointer to a new object of the specified type `T` constructed
+    // using the specified `arguments`.
+    template <typename T, typename... Arguments>
+    T* create(Arguments&&... arguments);
+
+    // Return a pointer to uninitialized storage for the specified `count`
+    // objects of the specified type `T`.
+    template <typename T>
+    T* allocateArray(std::size_t count);
+
+    // Make all of the memory allocated by this arena available for reuse, and
+    // free all but the largest block.  Any pointers previously returned by
+    // this arena are invalidated.
+    void reset();
+
+    // Return the number of blocks that this arena holds.
+    std::size_t blockCount() const;
+
+    // Return the total size, in bytes, of the blocks that this arena holds.
+    std::size_t bytesReserved() const;
+};
+
+// inline definitions
+// ------------------
+
+inline void* Arena::allocate(std::size_t size, std::size_t alignment) {
+    const std::size_t misalignment =
+        reinterpret_cast<std::size_t>(cursor) & (alignment - 1);
+    const std::size_t padding = misalignment ? alignment - misalignment : 0;
+
+    if (cursor == nullptr || std::size_t(limit - cursor) < padding + size) {
+        grow(size + alignment);
+        return allocate(size, alignment);
+    }
+
+    void* const result = cursor + padding;
+    cursor += padding + size;
+    return result;
+}
+
+template <typename T, typename... Arguments>
+T* Arena::create(Arguments&&... arguments) {
+    return new (allocate(sizeof(T), alignof(T)))
+        T(std::forward<Arguments>(arguments)...);
+}
+
+template <typename T>
+T* Arena::allocateArray(std::size_t count) {
+    return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+}
+
+}  // namespace brex
+
+#endif
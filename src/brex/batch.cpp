@@ -0,0 +1,55 @@
+#include <brex/batch.h>
+#include <brex/odometer.h>
+#include <brex/parse.h>
+#include <brex/sink.h>
+#include <brex/terms.h>
+
+#include <istream>
+#include <sstream>  // ostringstream
+#include <string>
+
+namespace brex {
+
+void expandBatch(Sink&         sink,
+                 std::istream& input,
+                 std::uint64_t limit,
+                 std::ostream* errors) {
+    const std::string separator("\n");
+
+    // All of these are reused from one record to the next.
+    std::string        line;
+    Expansion          expansion;
+    std::ostringstream diagnostic;
+    std::uint64_t      lineNumber = 0;
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+
+        const ParseResult result =
+            expansion.assign(line, errors ? &diagnostic : nullptr);
+
+        sink.write(std::to_string(int(result)));
+        sink.write("\n", 1);
+
+        if (result == ParseResult::SUCCESS) {
+            expand(sink, expansion.odometer(), separator, limit);
+            sink.write("\n", 1);
+        }
+        else if (errors) {
+            *errors << "Line " << lineNumber << ": " << diagnostic.str();
+            diagnostic.str("");
+        }
+
+        sink.write("\n", 1);
+
+        if (input.rdbuf()->in_avail() <= 0) {
+            sink.flush();
+        }
+
+        if (sink.error()) {
+            return;
+        }
+    }
+}
+
+}  // namespace brex
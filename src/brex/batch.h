@@ -0,0 +1,39 @@
+#ifndef INCLUDED_BREX_BATCH
+#define INCLUDED_BREX_BATCH
+
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // istream&, ostream&
+
+namespace brex {
+
+class Sink;
+
+// Read shell brace expressions from the specified `input`, one per line, until
+// the end of `input`, and append to the specified `sink` a record for each.
+// A record consists of
+//
+// - a line containing the decimal `ParseResult` (see `parse.h`) of the
+//   expression, which is zero if the expression is valid,
+// - if the expression is valid, each term of its expansion on a line of its
+//   own, stopping after the specified `limit` number of terms,
+// - an empty line.
+//
+// Since no term is empty, the empty line unambiguously ends the record.  An
+// invalid expression does not stop the batch.  If an expression is invalid
+// and the specified `errors` is not null, then write a diagnostic to
+// `errors`, prefixed by the expression's line number.  Stop early if writing
+// to `sink` fails.  The output is flushed whenever `input` has no more
+// buffered characters, so that a program that writes one expression and then
+// waits for its record does not wait forever.
+//
+// The storage used to parse, compile, and expand each expression is reused
+// for the next, so that the cost of each record is little more than that of
+// its expansion.
+void expandBatch(Sink&         sink,
+                 std::istream& input,
+                 std::uint64_t limit,
+                 std::ostream* errors);
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,398 @@
+#include <brex/bigunsigned.h>
+
+#include <algorithm>  // max, reverse
+#include <cassert>
+#include <ostream>
+#include <utility>  // move
+
+namespace brex {
+namespace {
+
+const std::uint64_t BASE = std::uint64_t(1) << 32;
+
+// Return the number of leading zero bits in the specified `value`.
+int leadingZeros(std::uint32_t value) {
+    int count = 0;
+    for (std::uint32_t mask = 0x80000000u; mask && !(value & mask);
+         mask >>= 1) {
+        ++count;
+    }
+    return count;
+}
+
+// Multiply the number whose limbs are the specified `limbs` by the specified
+// `multiplier` and add the specified `addend`, in place.
+void multiplyAdd(std::vector<std::uint32_t>& limbs,
+                 std::uint32_t               multiplier,
+                 std::uint32_t               addend) {
+    std::uint64_t carry = addend;
+    for (auto& limb : limbs) {
+        const std::uint64_t product = std::uint64_t(limb) * multiplier + carry;
+        limb                        = std::uint32_t(product);
+        carry                       = product >> 32;
+    }
+    if (carry) {
+        limbs.push_back(std::uint32_t(carry));
+    }
+}
+
+// Divide the number whose limbs are the specified `limbs` by the specified
+// nonzero `divisor`, in place.  Return the remainder.  Note that the result
+// might have most significant zero limbs.
+std::uint32_t divideSmall(std::vector<std::uint32_t>& limbs,
+                          std::uint32_t               divisor) {
+    std::uint64_t remainder = 0;
+    for (auto iter = limbs.rbegin(); iter != limbs.rend(); ++iter) {
+        const std::uint64_t current = (remainder << 32) | *iter;
+        *iter                       = std::uint32_t(current / divisor);
+        remainder                   = current % divisor;
+    }
+    return std::uint32_t(remainder);
+}
+
+}  // namespace
+
+// class BigUnsigned
+// -----------------
+
+void BigUnsigned::trim() {
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+}
+
+BigUnsigned::BigUnsigned() {
+}
+
+BigUnsigned::BigUnsigned(std::uint64_t value) {
+    while (value) {
+        limbs.push_back(std::uint32_t(value));
+        value >>= 32;
+    }
+}
+
+int BigUnsigned::fromDecimal(BigUnsigned& output, const std::string& text) {
+    if (text.empty()) {
+        return 1;
+    }
+
+    BigUnsigned result;
+    for (const char ch : text) {
+        if (ch < '0' || ch > '9') {
+            return 1;
+        }
+        multiplyAdd(result.limbs, 10, ch - '0');
+    }
+
+    result.trim();
+    output = std::move(result);
+    return 0;
+}
+
+void BigUnsigned::fromLimbs(BigUnsigned&         output,
+                            const std::uint32_t* limbs,
+                            std::size_t          count) {
+    output.limbs.assign(limbs, limbs + count);
+    output.trim();
+}
+
+bool BigUnsigned::isZero() const {
+    return limbs.empty();
+}
+
+bool BigUnsigned::fitsUint64() const {
+    return limbs.size() <= 2;
+}
+
+std::uint64_t BigUnsigned::toUint64() const {
+    assert(fitsUint64());
+    return (std::uint64_t(limb(1)) << 32) | limb(0);
+}
+
+int BigUnsigned::bitLength() const {
+    if (limbs.empty()) {
+        return 0;
+    }
+    return int(limbs.size()) * 32 - leadingZeros(limbs.back());
+}
+
+std::uint32_t BigUnsigned::limb(int index) const {
+    return index < int(limbs.size()) ? limbs[index] : 0;
+}
+
+std::string BigUnsigned::toDecimal() const {
+    if (limbs.empty()) {
+        return "0";
+    }
+
+    // Peel off nine decimal digits at a time, least significant first.
+    std::vector<std::uint32_t> remaining(limbs);
+    std::string                result;
+
+    while (!remaining.empty()) {
+        std::uint32_t chunk = divideSmall(remaining, 1000000000);
+        while (!remaining.empty() && remaining.back() == 0) {
+            remaining.pop_back();
+        }
+
+        for (int i = 0; i < 9 && (chunk || !remaining.empty()); ++i) {
+            result.push_back(char('0' + chunk % 10));
+            chunk /= 10;
+        }
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+BigUnsigned& BigUnsigned::operator+=(const BigUnsigned& other) {
+    const std::size_t size = std::max(limbs.size(), other.limbs.size());
+    limbs.resize(size);
+
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const std::uint64_t sum =
+            std::uint64_t(limbs[i]) + other.limb(int(i)) + carry;
+        limbs[i] = std::uint32_t(sum);
+        carry    = sum >> 32;
+    }
+    if (carry) {
+        limbs.push_back(std::uint32_t(carry));
+    }
+
+    return *this;
+}
+
+BigUnsigned& BigUnsigned::operator-=(const BigUnsigned& other) {
+    assert(compare(*this, other) >= 0);
+
+    std::uint64_t borrow = 0;
+    for (std::size_t i = 0; i < limbs.size(); ++i) {
+        const std::uint64_t difference =
+            std::uint64_t(limbs[i]) - other.limb(int(i)) - borrow;
+        limbs[i] = std::uint32_t(difference);
+        borrow   = difference >> 63;
+    }
+    assert(borrow == 0);
+
+    trim();
+    return *this;
+}
+
+BigUnsigned& BigUnsigned::operator*=(const BigUnsigned& other) {
+    if (limbs.empty() || other.limbs.empty()) {
+        limbs.clear();
+        return *this;
+    }
+
+    if (other.limbs.size() == 1) {
+        multiplyAdd(limbs, other.limbs[0], 0);
+        return *this;
+    }
+
+    std::vector<std::uint32_t> product(limbs.size() + other.limbs.size());
+    for (std::size_t i = 0; i < limbs.size(); ++i) {
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j < other.limbs.size(); ++j) {
+            const std::uint64_t current =
+                std::uint64_t(limbs[i]) * other.limbs[j] + product[i + j] +
+                carry;
+            product[i + j] = std::uint32_t(current);
+            carry          = current >> 32;
+        }
+        product[i + other.limbs.size()] = std::uint32_t(carry);
+    }
+
+    limbs.swap(product);
+    trim();
+    return *this;
+}
+
+void BigUnsigned::divide(BigUnsigned&       quotient,
+                         BigUnsigned&       remainder,
+                         const BigUnsigned& dividend,
+                         const BigUnsigned& divisor) {
+    assert(&quotient != &remainder);
+    assert(!divisor.isZero());
+
+    if (compare(dividend, divisor) < 0) {
+        remainder = dividend;
+        quotient  = BigUnsigned();
+        return;
+    }
+
+    if (divisor.limbs.size() == 1) {
+        std::vector<std::uint32_t> limbs(dividend.limbs);
+        const std::uint32_t        rest = divideSmall(limbs, divisor.limbs[0]);
+
+        quotient.limbs.swap(limbs);
+        quotient.trim();
+        remainder = BigUnsigned(rest);
+        return;
+    }
+
+    // This is Algorithm D from section 4.3.1 of Knuth's "The Art of Computer
+    // Programming," as presented in "Hacker's Delight."  First, normalize
+    // both operands so that the divisor's most significant limb has its high
+    // bit set.  That keeps each estimated quotient digit within two of its
+    // true value.
+    const int m     = dividend.limbs.size();
+    const int n     = divisor.limbs.size();
+    const int shift = leadingZeros(divisor.limbs.back());
+
+    std::vector<std::uint32_t> v(n);
+    std::vector<std::uint32_t> u(m + 1);
+
+    for (int i = n - 1; i > 0; --i) {
+        v[i] = std::uint32_t((std::uint64_t(divisor.limbs[i]) << shift) |
+                             (std::uint64_t(divisor.limbs[i - 1]) >>
+                              (32 - shift)));
+    }
+    v[0] = std::uint32_t(std::uint64_t(divisor.limbs[0]) << shift);
+
+    u[m] = std::uint32_t(std::uint64_t(dividend.limbs[m - 1]) >> (32 - shift));
+    for (int i = m - 1; i > 0; --i) {
+        u[i] = std::uint32_t((std::uint64_t(dividend.limbs[i]) << shift) |
+                             (std::uint64_t(dividend.limbs[i - 1]) >>
+                              (32 - shift)));
+    }
+    u[0] = std::uint32_t(std::uint64_t(dividend.limbs[0]) << shift);
+
+    std::vector<std::uint32_t> q(m - n + 1);
+
+    for (int j = m - n; j >= 0; --j) {
+        // Estimate the quotient digit from the top two limbs of the current
+        // remainder and the top limb of the divisor, and then refine the
+        // estimate using the divisor's second limb.
+        const std::uint64_t top =
+            (std::uint64_t(u[j + n]) << 32) | u[j + n - 1];
+        std::uint64_t qhat = top / v[n - 1];
+        std::uint64_t rhat = top % v[n - 1];
+
+        while (qhat >= BASE ||
+               qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2])) {
+            --qhat;
+            rhat += v[n - 1];
+            if (rhat >= BASE) {
+                break;
+            }
+        }
+
+        // Multiply and subtract.
+        std::uint64_t borrow = 0;
+        std::uint64_t carry  = 0;
+        for (int i = 0; i < n; ++i) {
+            const std::uint64_t product = qhat * v[i] + carry;
+            carry                       = product >> 32;
+
+            const std::uint64_t difference =
+                std::uint64_t(u[i + j]) - (product & 0xFFFFFFFFu) - borrow;
+            u[i + j] = std::uint32_t(difference);
+            borrow   = difference >> 63;
+        }
+        const std::uint64_t difference =
+            std::uint64_t(u[j + n]) - carry - borrow;
+        u[j + n] = std::uint32_t(difference);
+
+        if (difference >> 63) {
+            // The estimate was one too large.  Add the divisor back.
+            --qhat;
+            std::uint64_t sumCarry = 0;
+            for (int i = 0; i < n; ++i) {
+                const std::uint64_t sum =
+                    std::uint64_t(u[i + j]) + v[i] + sumCarry;
+                u[i + j] = std::uint32_t(sum);
+                sumCarry = sum >> 32;
+            }
+            u[j + n] += std::uint32_t(sumCarry);
+        }
+
+        q[j] = std::uint32_t(qhat);
+    }
+
+    // Unnormalize the remainder.
+    std::vector<std::uint32_t> r(n);
+    for (int i = 0; i < n; ++i) {
+        r[i] = std::uint32_t((std::uint64_t(u[i]) >> shift) |
+                             (std::uint64_t(u[i + 1]) << (32 - shift)));
+    }
+
+    quotient.limbs.swap(q);
+    quotient.trim();
+    remainder.limbs.swap(r);
+    remainder.trim();
+}
+
+int BigUnsigned::compare(const BigUnsigned& left, const BigUnsigned& right) {
+    if (left.limbs.size() != right.limbs.size()) {
+        return left.limbs.size() < right.limbs.size() ? -1 : 1;
+    }
+
+    for (int i = int(left.limbs.size()) - 1; i >= 0; --i) {
+        if (left.limbs[i] != right.limbs[i]) {
+            return left.limbs[i] < right.limbs[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+// free functions
+// --------------
+
+BigUnsigned operator+(BigUnsigned left, const BigUnsigned& right) {
+    return left += right;
+}
+
+BigUnsigned operator-(BigUnsigned left, const BigUnsigned& right) {
+    return left -= right;
+}
+
+BigUnsigned operator*(const BigUnsigned& left, const BigUnsigned& right) {
+    BigUnsigned result(left);
+    return result *= right;
+}
+
+BigUnsigned operator/(const BigUnsigned& left, const BigUnsigned& right) {
+    BigUnsigned quotient;
+    BigUnsigned remainder;
+    BigUnsigned::divide(quotient, remainder, left, right);
+    return quotient;
+}
+
+BigUnsigned operator%(const BigUnsigned& left, const BigUnsigned& right) {
+    BigUnsigned quotient;
+    BigUnsigned remainder;
+    BigUnsigned::divide(quotient, remainder, left, right);
+    return remainder;
+}
+
+bool operator==(const BigUnsigned& left, const BigUnsigned& right) {
+    return BigUnsigned::compare(left, right) == 0;
+}
+
+bool operator!=(const BigUnsigned& left, const BigUnsigned& right) {
+    return BigUnsigned::compare(left, right) != 0;
+}
+
+bool operator<(const BigUnsigned& left, const BigUnsigned& right) {
+    return BigUnsigned::compare(left, right) < 0;
+}
+
+bool operator<=(const BigUnsigned& left, const BigUnsigned& right) {
+    return BigUnsigned::compare(left, right) <= 0;
+}
+
+bool operator>(const BigUnsigned& left, const BigUnsigned& right) {
+    return BigUnsigned::compare(left, right) > 0;
+}
+
+bool operator>=(const BigUnsigned& left, const BigUnsigned& right) {
+    return BigUnsigned::compare(left, right) >= 0;
+}
+
+std::ostream& operator<<(std::ostream& stream, const BigUnsigned& value) {
+    return stream << value.toDecimal();
+}
+
+}  // namespace brex
@@ -0,0 +1,108 @@
+#ifndef INCLUDED_BREX_BIGUNSIGNED
+#define INCLUDED_BREX_BIGUNSIGNED
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t, uint64_t
+#include <iosfwd>   // ostream&
+#include <string>
+#include <vector>
+
+namespace brex {
+
+// `BigUnsigned` is an arbitrary-precision non-negative integer.  It supports
+// the arithmetic needed to count, rank, and unrank the terms of an expansion,
+// which can easily number more than 2^64.
+class BigUnsigned {
+    // base 2^32 digits, least significant first, with no trailing zeros
+    std::vector<std::uint32_t> limbs;
+
+    // Remove any most significant zero limbs.
+    void trim();
+
+  public:
+    // Create an object having the value zero.
+    BigUnsigned();
+
+    // Create an object having the specified `value`.
+    BigUnsigned(std::uint64_t value);  // implicit
+
+    // Load into the specified `output` the integer represented in decimal by
+    // the specified `text`.  Return zero on success or a nonzero value if
+    // `text` is empty or contains anything other than decimal digits.  If an
+    // error occurs, `output` is not modified.
+    static int fromDecimal(BigUnsigned& output, const std::string& text);
+
+    // Load into the specified `output` the integer whose base 2^32 digits,
+    // least significant first, are the specified `count` elements of the
+    // specified `limbs`, as `limb` returns them.
+    static void fromLimbs(BigUnsigned&         output,
+                          const std::uint32_t* limbs,
+                          std::size_t          count);
+
+    // Return whether this object has the value zero.
+    bool isZero() const;
+
+    // Return whether the value of this object is representable as a
+    // `std::uint64_t`.
+    bool fitsUint64() const;
+
+    // Return the value of this object as a `std::uint64_t`.  The behavior is
+    // undefined unless `fitsUint64()`.
+    std::uint64_t toUint64() const;
+
+    // Return the number of significant bits in the value of this object, i.e.
+    // zero for zero, and otherwise one more than the base two logarithm of the
+    // value, rounded down.
+    int bitLength() const;
+
+    // Return the specified `index`th base 2^32 digit of this object, least
+    // significant first.  Return zero if `index` is beyond the most
+    // significant digit.
+    std::uint32_t limb(int index) const;
+
+    // Return a decimal representation of this object.
+    std::string toDecimal() const;
+
+    BigUnsigned& operator+=(const BigUnsigned& other);
+
+    // The behavior is undefined if `other` is greater than this object.
+    BigUnsigned& operator-=(const BigUnsigned& other);
+
+    BigUnsigned& operator*=(const BigUnsigned& other);
+
+    // Load into the specified `quotient` and `remainder` the result of
+    // dividing the specified `dividend` by the specified `divisor`.  The
+    // behavior is undefined if `divisor` is zero.  `quotient` and `remainder`
+    // may refer to the same objects as `dividend` and `divisor`, but not to
+    // each other.
+    static void divide(BigUnsigned&       quotient,
+                       BigUnsigned&       remainder,
+                       const BigUnsigned& dividend,
+                       const BigUnsigned& divisor);
+
+    // Return negative, zero, or positive if the specified `left` is less
+    // than, equal to, or greater than the specified `right`, respectively.
+    static int compare(const BigUnsigned& left, const BigUnsigned& right);
+};
+
+BigUnsigned operator+(BigUnsigned left, const BigUnsigned& right);
+BigUnsigned operator-(BigUnsigned left, const BigUnsigned& right);
+BigUnsigned operator*(const BigUnsigned& left, const BigUnsigned& right);
+BigUnsigned operator/(const BigUnsigned& left, const BigUnsigned& right);
+BigUnsigned operator%(const BigUnsigned& left, const BigUnsigned& right);
+
+bool operator==(const BigUnsigned& left, const BigUnsigned& right);
+bool operator!=(const BigUnsigned& left, const BigUnsigned& right);
+bool operator<(const BigUnsigned& left, const BigUnsigned& right);
+bool operator<=(const BigUnsigned& left, const BigUnsigned& right);
+bool operator>(const BigUnsigned& left, const BigUnsigned& right);
+bool operator>=(const BigUnsigned& left, const BigUnsigned& right);
+
+// Insert into the specified `stream` a decimal representation of the
+// specified `value`.  Return a reference providing modifiable access to
+// `stream`.
+std::ostream& operator<<(std::ostream& stream, const BigUnsigned& value);
+
+}  // namespace brex
+
+#endif
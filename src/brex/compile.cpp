@@ -0,0 +1,281 @@
+#include <brex/compile.h>
+#include <brex/interner.h>
+#include <brex/parse.h>
+
+#include <algorithm>  // max
+#include <cassert>
+#include <cstdint>  // uint64_t
+#include <vector>
+
+namespace brex {
+
+// `Interner` (see `interner.h`) finds these by argument dependent lookup,
+// which does not look within unnamed namespaces, so they are `static`
+// instead.
+static void mixElement(std::uint64_t&              hash,
+                       const Program::Instruction& element) {
+    mix(hash, unsigned(element.opcode));
+    mix(hash, unsigned(element.first));
+    mix(hash, unsigned(element.count));
+}
+
+static bool sameElement(const Program::Instruction& left,
+                        const Program::Instruction& right) {
+    return left.opcode == right.opcode && left.first == right.first &&
+           left.count == right.count;
+}
+
+static void mixElement(std::uint64_t& hash, const Range& element) {
+    mix(hash, std::uint64_t(element.start));
+    mix(hash, std::uint64_t(element.end));
+    mix(hash, std::uint64_t(element.step));
+    mix(hash, unsigned(element.width));
+    mix(hash, unsigned(element.letters));
+}
+
+static bool sameElement(const Range& left, const Range& right) {
+    return left.start == right.start && left.end == right.end &&
+           left.step == right.step && left.width == right.width &&
+           left.letters == right.letters;
+}
+
+namespace {
+
+// `Compiler` holds the state of a single invocation of `compile`.  The parse
+// tree is walked with an explicit stack, and each chain is emitted once all
+// of the alternations within it have been, so that the chains of a slot's
+// branches are always emitted before the slot.  This is what allows
+// identical literals, chains, and branches to be found as they are emitted:
+// everything that a chain refers to is already interned, so two chains are
+// identical exactly when their instructions are.
+class Compiler {
+    // A `Frame` is a node whose parts or children are being visited.  A chain
+    // frame is a node from which a chain is emitted: the root, or an option
+    // of an alternation.  Any other frame is an alternation.
+    struct Frame {
+        const ParseTreeNode* node;
+        bool                 isChain;
+        int                  next;  // index of the next part or child to visit
+        int                  mark;  // chain: index into `building`
+                                    // alternation: index into `entries`
+    };
+
+    Program&                                    program;
+    Interner<std::string>                       literals;
+    Interner<std::vector<Range>>                ranges;
+    Interner<std::vector<int>>                  branches;
+    Interner<std::vector<Program::Instruction>> chains;
+
+    std::vector<Frame> frames;
+
+    // the instructions of the chains being emitted, not including their
+    // `RETURN` instructions
+    std::vector<Program::Instruction> building;
+
+    // the instruction indices of the chains emitted for the options of the
+    // alternations being emitted
+    std::vector<int> entries;
+
+    // Return a `LITERAL` instruction for the specified `string` node.
+    Program::Instruction literal(const ParseTreeNode& string);
+
+    // Return a `RANGE` instruction for the specified `range` node.
+    Program::Instruction range(const ParseTreeNode& range);
+
+    // Emit the chain whose instructions are the elements of `building` at and
+    // after the specified `mark`, and remove them from `building`.  Return
+    // the index of the chain's first instruction.  Reuse an identical chain
+    // emitted earlier only if the specified `shared` is `true`.
+    int finishChain(int mark, bool shared);
+
+    // Emit the branches of the alternation whose options' chains are the
+    // elements of `entries` at and after the specified `mark`, and remove
+    // them from `entries`.  Return a `SLOT` instruction for the alternation.
+    Program::Instruction finishSlot(int mark);
+
+  public:
+    // Create a compiler that emits into the specified `program`.
+    explicit Compiler(Program& program);
+
+    // Emit into this object's program the chains of all alternations
+    // reachable from the specified `root`, followed by the chain for `root`.
+    void run(const ParseTreeNode& root);
+};
+
+Compiler::Compiler(Program& program)
+: program(program)
+, literals(program.literals)
+, ranges(program.ranges)
+, branches(program.branches)
+, chains(program.instructions) {
+}
+
+Program::Instruction Compiler::literal(const ParseTreeNode& string) {
+    assert(string.type == ParseTreeNode::Type::STRING);
+
+    program.literals.append(string.sourceBegin(), string.byteLength);
+
+    Program::Instruction instruction;
+    instruction.opcode = Program::Opcode::LITERAL;
+    instruction.first  = literals.offset(literals.intern(string.byteLength));
+    instruction.count  = string.byteLength;
+    return instruction;
+}
+
+Program::Instruction Compiler::range(const ParseTreeNode& range) {
+    assert(range.type == ParseTreeNode::Type::RANGE);
+
+    program.ranges.push_back(*range.range);
+
+    Program::Instruction instruction;
+    instruction.opcode = Program::Opcode::RANGE;
+    instruction.first  = ranges.offset(ranges.intern(1));
+    instruction.count  = range.range->count();
+    return instruction;
+}
+
+int Compiler::finishChain(int mark, bool shared) {
+    const int length = int(building.size()) - mark;
+    const int offset = int(program.instructions.size());
+
+    program.instructions.insert(
+        program.instructions.end(), building.begin() + mark, building.end());
+    building.resize(mark);
+
+    Program::Instruction instruction;
+    instruction.opcode = Program::Opcode::RETURN;
+    instruction.first  = 0;
+    instruction.count  = 0;
+    program.instructions.push_back(instruction);
+
+    return shared ? chains.offset(chains.intern(length + 1)) : offset;
+}
+
+Program::Instruction Compiler::finishSlot(int mark) {
+    const int count = int(entries.size()) - mark;
+
+    program.branches.insert(
+        program.branches.end(), entries.begin() + mark, entries.end());
+    entries.resize(mark);
+
+    Program::Instruction instruction;
+    instruction.opcode = Program::Opcode::SLOT;
+    instruction.first  = branches.offset(branches.intern(count));
+    instruction.count  = count;
+    return instruction;
+}
+
+void Compiler::run(const ParseTreeNode& root) {
+    frames.push_back(Frame{&root, true, 0, 0});
+
+    while (!frames.empty()) {
+        Frame&               frame = frames.back();
+        const ParseTreeNode& node  = *frame.node;
+
+        if (frame.isChain) {
+            // The parts of a chain are the children of a sequence, or else
+            // the node itself.
+            const bool isSequence = node.type == ParseTreeNode::Type::SEQUENCE;
+            const int  parts      = isSequence ? node.childCount : 1;
+
+            if (frame.next == parts) {
+                // The root's chain is the only chain that cannot be shared,
+                // so it isn't worth hashing.
+                const bool shared = frames.size() > 1;
+                const int  entry  = finishChain(frame.mark, shared);
+                frames.pop_back();
+                entries.push_back(entry);
+                continue;
+            }
+
+            const ParseTreeNode& part =
+                isSequence ? node.children[frame.next] : node;
+            ++frame.next;
+
+            if (part.type == ParseTreeNode::Type::STRING) {
+                building.push_back(literal(part));
+            }
+            else if (part.type == ParseTreeNode::Type::RANGE) {
+                building.push_back(range(part));
+            }
+            else {
+                assert(part.type == ParseTreeNode::Type::ALTERNATION);
+                frames.push_back(Frame{&part, false, 0, int(entries.size())});
+            }
+        }
+        else if (frame.next == node.childCount) {
+            const Program::Instruction slot = finishSlot(frame.mark);
+            frames.pop_back();
+            building.push_back(slot);
+        }
+        else {
+            const ParseTreeNode& option = node.children[frame.next++];
+            frames.push_back(Frame{&option, true, 0, int(building.size())});
+        }
+    }
+
+    assert(entries.size() == 1);
+    assert(building.empty());
+    program.root = entries.back();
+}
+
+}  // namespace
+
+void compile(Program& output, const ParseTreeNode& root) {
+    output.instructions.clear();
+    output.branches.clear();
+    output.literals.clear();
+    output.ranges.clear();
+
+    Compiler(output).run(root);
+}
+
+std::uint64_t longestValue(const Program& program) {
+    const auto& instructions = program.instructions;
+    const int   size         = instructions.size();
+
+    // Every chain comes before any slot that refers to it, so walking the
+    // instructions forwards finds each chain's longest value before it's
+    // needed.  `chainLengths` is indexed by the instruction index at which a
+    // chain begins.
+    std::vector<std::uint64_t> chainLengths(size);
+    std::uint64_t              length     = 0;  // of the chain so far
+    int                        chainBegin = 0;
+
+    for (int pc = 0; pc < size; ++pc) {
+        const Program::Instruction& instruction = instructions[pc];
+
+        switch (instruction.opcode) {
+            case Program::Opcode::LITERAL:
+                length += instruction.count;
+                break;
+            case Program::Opcode::SLOT: {
+                std::uint64_t longest = 0;
+                for (int i = 0; i < instruction.count; ++i) {
+                    const int chain = program.branches[instruction.first + i];
+                    longest = std::max(longest, chainLengths[chain]);
+                }
+                length += longest;
+            } break;
+            case Program::Opcode::RANGE: {
+                // The values are in order, so the longest text belongs to
+                // the first or the last of them.
+                const Range&      range = program.ranges[instruction.first];
+                const int         end   = range.count() - 1;
+                std::vector<char> text(range.maxLength());
+                const int         first = range.format(text.data(), 0);
+                const int         last  = range.format(text.data(), end);
+                length += std::max(first, last);
+            } break;
+            default:
+                assert(instruction.opcode == Program::Opcode::RETURN);
+                chainLengths[chainBegin] = length;
+                length                   = 0;
+                chainBegin               = pc + 1;
+        }
+    }
+
+    return chainLengths[program.root];
+}
+
+}  // namespace brex
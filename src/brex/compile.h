@@ -0,0 +1,68 @@
+#ifndef INCLUDED_BREX_COMPILE
+#define INCLUDED_BREX_COMPILE
+
+#include <brex/range.h>
+
+#include <cstdint>  // uint64_t
+#include <string>
+#include <vector>
+
+namespace brex {
+
+struct ParseTreeNode;
+
+// `Program` is a parse tree lowered into flat, contiguous arrays.  A program
+// is a set of "chains," where each chain is a run of instructions terminated
+// by a `RETURN` instruction.  The chain beginning at instruction `root` is the
+// whole expression.  A `LITERAL` instruction refers to a span of `literals`.
+// A `SLOT` instruction is a digit whose radix is the number of options in an
+// alternation.  Its `first` member is the offset into `branches` of the
+// instruction index of the chain for each option.  A `RANGE` instruction is a
+// digit whose radix is the number of values of one of the `ranges`.  Unlike a
+// slot, a range has no branches: each of its values is text produced by the
+// range itself.
+//
+// Sequences do not appear in a program at all: their children are simply
+// laid out one after another within the same chain.
+//
+// A program is a directed acyclic graph rather than a tree: identical
+// literals, identical ranges, identical chains, and identical runs of
+// `branches` appear only once, however many times they occur in the
+// expression.  Every chain comes after the chains of the branches of its
+// slots, so the root chain is last.
+//
+// A `Program` holds no cursor state, so any number of `Odometer` objects
+// (see `odometer.h`) may share one, and an `Odometer` passing through the same
+// chain at several positions keeps separate state for each.
+struct Program {
+    enum class Opcode { LITERAL, SLOT, RANGE, RETURN };
+
+    struct Instruction {
+        Opcode opcode;
+        int    first;  // `LITERAL`: offset into `literals`
+                       // `SLOT`: offset into `branches`
+                       // `RANGE`: index into `ranges`
+        int    count;  // `LITERAL`: length of the literal in bytes
+                       // `SLOT`: radix, i.e. how many branches
+                       // `RANGE`: radix, i.e. how many values
+    };
+
+    std::vector<Instruction> instructions;
+    std::vector<int>         branches;
+    std::string              literals;
+    std::vector<Range>       ranges;
+    int                      root;  // index of the whole expression's chain
+};
+
+// Load into the specified `output` a `Program` compiled from the specified
+// parse tree `root`.  Any previous contents of `output` are discarded.
+void compile(Program& output, const ParseTreeNode& root);
+
+// Return the length of the longest value of the specified `program`.  This
+// takes time proportional to the size of `program`, not to the number of its
+// values.
+std::uint64_t longestValue(const Program& program);
+
+}  // namespace brex
+
+#endif
@@ -1,8 +1,12 @@
+#include <brex/arena.h>
 #include <brex/expand.h>
 #include <brex/parse.h>  // for use in `expander(ParseTreeNode)`
+#include <brex/range.h>
 
 #include <cassert>
-#include <utility>  // move
+#include <ostream>
+#include <utility>  // move, pair
+#include <vector>
 
 namespace brex {
 
@@ -20,8 +24,9 @@ std::ostream& operator<<(std::ostream& stream, const Expander& expander) {
 // class String
 // ------------
 
-String::String(const std::string& value)
-: value(value) {
+String::String(const char* data, int length)
+: data(data)
+, length(length) {
 }
 
 AdvanceResult String::advance() {
@@ -29,20 +34,21 @@ AdvanceResult String::advance() {
 }
 
 void String::printCurrent(std::ostream& stream) const {
-    stream << value;
+    stream.write(data, length);
 }
 
 // class Sequence
 // --------------
 
-void Sequence::appendChild(std::unique_ptr<Expander> child) {
-    children.push_back(std::move(child));
+Sequence::Sequence(Expander* const* children, int childCount)
+: children(children)
+, childCount(childCount) {
 }
 
 AdvanceResult Sequence::advance() {
-    auto iter = children.rbegin();
+    int i = childCount - 1;
 
-    if (iter == children.rend()) {
+    if (i < 0) {
         // An empty sequence always has its initial value.
         return AdvanceResult::CARRY;
     }
@@ -50,20 +56,18 @@ AdvanceResult Sequence::advance() {
     AdvanceResult result;
 
     do {
-        assert(*iter);  // each `unique_ptr<Expander>` is never null
-        Expander& child = **iter;
-
-        result = child.advance();
-        ++iter;
-    } while (result == AdvanceResult::CARRY && iter != children.rend());
+        assert(children[i]);
+        result = children[i]->advance();
+        --i;
+    } while (result == AdvanceResult::CARRY && i >= 0);
 
     return result;
 }
 
 void Sequence::printCurrent(std::ostream& stream) const {
-    for (const auto& child : children) {
-        assert(child);
-        child->printCurrent(stream);
+    for (int i = 0; i < childCount; ++i) {
+        assert(children[i]);
+        children[i]->printCurrent(stream);
     }
 }
 
@@ -73,23 +77,17 @@ void Sequence::printCurrent(std::ostream& stream) const {
 Expander& Alternation::currentChild() const {
     assert(currentIndex >= 0);
 
-    const auto& childPointer = children[currentIndex];
-    assert(childPointer);  // none of the `unique_ptr<Expander>` is null
+    Expander* const child = children[currentIndex];
+    assert(child);
 
-    return *childPointer;
+    return *child;
 }
 
-Alternation::Alternation()
+Alternation::Alternation(Expander* const* children, int childCount)
+: children(children)
+, childCount(childCount)
 // `-1` is the special value meaning "there are no children."
-: currentIndex(-1) {
-}
-
-void Alternation::appendChild(std::unique_ptr<Expander> child) {
-    children.push_back(std::move(child));
-
-    if (currentIndex == -1) {
-        currentIndex = 0;
-    }
+, currentIndex(childCount == 0 ? -1 : 0) {
 }
 
 AdvanceResult Alternation::advance() {
@@ -108,7 +106,7 @@ AdvanceResult Alternation::advance() {
     // Advancing the current child carried over, so we either need to go to the
     // next child, or if we're already at the last child, go back to the first
     // and carry.
-    if (++currentIndex == int(children.size())) {
+    if (++currentIndex == childCount) {
         currentIndex = 0;
         return AdvanceResult::CARRY;
     }
@@ -127,47 +125,202 @@ void Alternation::printCurrent(std::ostream& stream) const {
     currentChild().printCurrent(stream);
 }
 
+// class Progression
+// -----------------
+
+Progression::Progression(const Range& range, char* buffer)
+: range(&range)
+, count(range.count())
+, index(0)
+, text(buffer)
+, length(range.format(buffer, 0)) {
+}
+
+AdvanceResult Progression::advance() {
+    if (++index == count) {
+        index  = 0;
+        length = range->format(text, 0);
+        return AdvanceResult::CARRY;
+    }
+
+    range->increment(text, length, index);
+    return AdvanceResult::NO_CARRY;
+}
+
+void Progression::printCurrent(std::ostream& stream) const {
+    stream.write(text, length);
+}
+
 // free functions
 // --------------
 
+Expander& expander(Arena& arena, const ParseTreeNode& root) {
+    // Build the expanders from the top down using an explicit stack, so that
+    // deeply nested trees don't overflow the call stack.  A parent is created
+    // before its children, and its array of children is filled in as they
+    // are created.  Each pending element is a node together with where to
+    // store a pointer to the node's expander.
+    Expander*                                                result = nullptr;
+    std::vector<std::pair<const ParseTreeNode*, Expander**>> pending;
+    pending.emplace_back(&root, &result);
+
+    while (!pending.empty()) {
+        const ParseTreeNode& node        = *pending.back().first;
+        Expander** const     destination = pending.back().second;
+        pending.pop_back();
+
+        if (node.type == ParseTreeNode::Type::STRING) {
+            *destination =
+                arena.create<String>(node.sourceBegin(), node.byteLength);
+            continue;
+        }
+
+        if (node.type == ParseTreeNode::Type::RANGE) {
+            const Range& range  = *node.range;
+            char* const  buffer = arena.allocateArray<char>(range.maxLength());
+            *destination        = arena.create<Progression>(range, buffer);
+            continue;
+        }
+
+        Expander** const children =
+            arena.allocateArray<Expander*>(node.childCount);
+
+        if (node.type == ParseTreeNode::Type::SEQUENCE) {
+            *destination = arena.create<Sequence>(children, node.childCount);
+        }
+        else {
+            assert(node.type == ParseTreeNode::Type::ALTERNATION);
+            *destination =
+                arena.create<Alternation>(children, node.childCount);
+        }
+
+        for (int i = 0; i < node.childCount; ++i) {
+            pending.emplace_back(&node.children[i], &children[i]);
+        }
+    }
+
+    assert(result);
+    return *result;
+}
+
 namespace {
 
-// The two cases for converting into an `Expander` a `ParseTreeNode` of type
-// `SEQUENCE` or `ALTERNATION` share some code, so `withChildren` is the
-// generic case, parameterized by either the output type `Sequence` or
-// `Alternation`.
-template <typename ExpanderParent>
-std::unique_ptr<ExpanderParent> withChildren(const ParseTreeNode& node) {
-    std::unique_ptr<ExpanderParent> result(new ExpanderParent);
-
-    for (const auto& childNodePointer : node.children) {
-        assert(childNodePointer);
-        result->appendChild(expander(*childNodePointer));
+// Return the cardinality of the specified `node` considered as though it had
+// no children.
+Cardinality leafCardinality(const ParseTreeNode& node) {
+    Cardinality result;
+
+    switch (node.type) {
+        case ParseTreeNode::Type::STRING:
+            result.terms = 1;
+            result.bytes = node.byteLength;
+            break;
+        case ParseTreeNode::Type::SEQUENCE:
+            result.terms = 1;
+            break;
+        case ParseTreeNode::Type::RANGE:
+            result.terms = node.range->count();
+            result.bytes = node.range->totalLength();
+            break;
+        default:
+            assert(node.type == ParseTreeNode::Type::ALTERNATION);
     }
 
     return result;
 }
 
+// Return the cardinality of a sequence whose children have the specified
+// `factors` cardinalities, which are left unspecified.  Each term of a child
+// appears once for every combination of the terms of the other children.
+// Folding the children in one at a time would multiply an ever larger
+// product by each child, which takes time quadratic in the number of
+// children, so instead they're multiplied in pairs, and then the pairs in
+// pairs, and so on, keeping the operands of each multiplication of similar
+// size.
+Cardinality product(std::vector<Cardinality>& factors) {
+    if (factors.empty()) {
+        return Cardinality{1, 0};
+    }
+
+    while (factors.size() > 1) {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < factors.size(); i += 2) {
+            if (i + 1 == factors.size()) {
+                factors[count++] = std::move(factors[i]);
+                break;
+            }
+
+            const Cardinality& left  = factors[i];
+            const Cardinality& right = factors[i + 1];
+            Cardinality        result;
+            result.bytes       = left.bytes * right.terms;
+            result.bytes      += left.terms * right.bytes;
+            result.terms       = left.terms * right.terms;
+            factors[count++]   = std::move(result);
+        }
+        factors.resize(count);
+    }
+
+    return std::move(factors[0]);
+}
+
 }  // namespace
 
-std::unique_ptr<Expander> expander(const ParseTreeNode& root) {
-    switch (root.type) {
-        case ParseTreeNode::Type::STRING:
-            return std::unique_ptr<Expander>(new String(root.source));
-        case ParseTreeNode::Type::SEQUENCE:
-            return withChildren<Sequence>(root);
-        default:
-            assert(root.type == ParseTreeNode::Type::ALTERNATION);
-            return withChildren<Alternation>(root);
+Cardinality cardinality(const ParseTreeNode& root) {
+    // Walk the tree using an explicit stack, so that deeply nested trees don't
+    // overflow the call stack.  Each frame is a node, the index of its next
+    // child to visit, and the cardinality of its children visited so far:
+    // their sum for an alternation, or each of them for a sequence.
+    struct Frame {
+        const ParseTreeNode*     node;
+        int                      next;
+        Cardinality              result;
+        std::vector<Cardinality> factors;
+    };
+
+    std::vector<Frame> stack;
+    stack.push_back(Frame{&root, 0, leafCardinality(root), {}});
+
+    for (;;) {
+        Frame& top = stack.back();
+
+        if (top.next < top.node->childCount) {
+            const ParseTreeNode& child = top.node->children[top.next++];
+            stack.push_back(Frame{&child, 0, leafCardinality(child), {}});
+            continue;
+        }
+
+        Cardinality result = top.node->type == ParseTreeNode::Type::SEQUENCE
+                                 ? product(top.factors)
+                                 : std::move(top.result);
+        stack.pop_back();
+        if (stack.empty()) {
+            return result;
+        }
+
+        Frame& parent = stack.back();
+        if (parent.node->type == ParseTreeNode::Type::SEQUENCE) {
+            parent.factors.push_back(std::move(result));
+        }
+        else {
+            assert(parent.node->type == ParseTreeNode::Type::ALTERNATION);
+            parent.result.terms += result.terms;
+            parent.result.bytes += result.bytes;
+        }
     }
 }
 
 void expand(std::ostream&      stream,
             Expander&          expander,
-            const std::string& separator) {
+            const std::string& separator,
+            std::uint64_t      limit) {
+    if (limit == 0) {
+        return;
+    }
+
     stream << expander;
 
-    while (expander.advance() == AdvanceResult::NO_CARRY) {
+    while (--limit && expander.advance() == AdvanceResult::NO_CARRY) {
         stream << separator << expander;
     }
 }
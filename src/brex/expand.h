@@ -1,25 +1,28 @@
 #ifndef INCLUDED_BREX_EXPAND
 #define INCLUDED_BREX_EXPAND
 
-#include <iosfwd>  // ostream&
-#include <memory>  // unique_ptr
+#include <brex/bigunsigned.h>
+
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // ostream&
 #include <string>
-#include <vector>
 
 namespace brex {
 
+class Arena;
 struct ParseTreeNode;
+struct Range;
 
 // `Expander::advance()` returns a value indicating either that the advancement
 // "carried over," (`CARRY`) or that it didn't (`NO_CARRY`).
 enum class AdvanceResult { CARRY, NO_CARRY };
 
-// `Expander` is the abstact base class of `String`, `Sequence`, and
-// `Alternation`.  An `Expander` is a stateful emitter of values expanded from
-// a parsed shell brace expression.  Its interface is that of a cursor that
-// iterates over all values implied by a shell brace (sub)expression.  When
-// it has exhausted all of its values, `advance` returns `CARRY`, and the
-// `Expander` is restored to its initial state.
+// `Expander` is the abstact base class of `String`, `Sequence`,
+// `Alternation`, and `Progression`.  An `Expander` is a stateful emitter of
+// values expanded from a parsed shell brace expression.  Its interface is
+// that of a cursor that iterates over all values implied by a shell brace
+// (sub)expression.  When it has exhausted all of its values, `advance`
+// returns `CARRY`, and the `Expander` is restored to its initial state.
 class Expander {
   public:
     virtual ~Expander();
@@ -40,11 +43,15 @@ class Expander {
 std::ostream& operator<<(std::ostream& stream, const Expander& expander);
 
 class String : public Expander {
-    std::string value;
+    const char* data;
+    int         length;
 
   public:
-    // Create an object having the specified `value`.
-    explicit String(const std::string& value);
+    // Create an object whose value is the specified `length` bytes beginning
+    // at the specified `data`.  The object does not copy the value, so the
+    // behavior is undefined if the value is modified or destroyed while this
+    // object is in use.
+    String(const char* data, int length);
 
     // Return `AdvanceResult::CARRY`.  Since a string only ever has a single
     // value, to advance it is always to "roll over" to its initial value.
@@ -55,11 +62,15 @@ class String : public Expander {
 };
 
 class Sequence : public Expander {
-    std::vector<std::unique_ptr<Expander>> children;
+    Expander* const* children;
+    int              childCount;
 
   public:
-    // Add the specified `child` to the end of this object's list of children.
-    void appendChild(std::unique_ptr<Expander> child);
+    // Create an object having the specified `childCount` children in the
+    // array at the specified `children`.  The object does not own the array
+    // or the children, so the behavior is undefined unless they outlive this
+    // object.
+    Sequence(Expander* const* children, int childCount);
 
     // Increment this object by incrementing lexicographically the sequence of
     // its children, least significant first, where the last child is the least
@@ -69,25 +80,25 @@ class Sequence : public Expander {
     AdvanceResult advance() override;
 
     // Insert into the specified `stream` the concatenation of the current
-    // values of each of this object's children, in the order in which they
-    // were added.
+    // values of each of this object's children, in order.
     void printCurrent(std::ostream& stream) const override;
 };
 
 class Alternation : public Expander {
-    std::vector<std::unique_ptr<Expander>> children;
-    int                                    currentIndex;
+    Expander* const* children;
+    int              childCount;
+    int              currentIndex;
 
     // Return a reference providing modifiable access to the currently selected
     // child.  The behavior is undefined if this object has no children.
     Expander& currentChild() const;
 
   public:
-    // Create an object having no children.
-    Alternation();
-
-    // Add the specified `child` to the end of this object's list of children.
-    void appendChild(std::unique_ptr<Expander> child);
+    // Create an object having the specified `childCount` children in the
+    // array at the specified `children`, with the first child selected.  The
+    // object does not own the array or the children, so the behavior is
+    // undefined unless they outlive this object.
+    Alternation(Expander* const* children, int childCount);
 
     // Increment this object by incrementing the currently selected child.  If
     // doing so "rolls over," then change the selection to the following child.
@@ -100,16 +111,68 @@ class Alternation : public Expander {
     void printCurrent(std::ostream& stream) const override;
 };
 
-// Return an `Expander` assembled using the specified parse tree `root`.  The
-// returned value will not be null.
-std::unique_ptr<Expander> expander(const ParseTreeNode& root);
+class Progression : public Expander {
+    const Range* range;
+    int          count;   // how many values `range` has
+    int          index;   // of the current value within `range`
+    char*        text;    // of the current value
+    int          length;  // of `text`
+
+  public:
+    // Create an object whose values are those of the specified `range`,
+    // starting with the first, whose text is kept in the specified `buffer`.
+    // `buffer` must have room for `range.maxLength()` bytes.  The object
+    // does not own `range` or `buffer`, so the behavior is undefined unless
+    // they outlive this object.
+    Progression(const Range& range, char* buffer);
+
+    // Increment this object to the next value of its range by adding the
+    // range's step to the digits of the current value in place (see
+    // `Range::increment`).  If there are no more values, then reset to the
+    // first and return `AdvanceResult::CARRY`.  Otherwise, return
+    // `AdvanceResult::NO_CARRY`.
+    AdvanceResult advance() override;
+
+    // Insert this object's current value into the specified `stream`.
+    void printCurrent(std::ostream& stream) const override;
+};
+
+// `MAX_EXPANDER_DEPTH` is the depth (see `treeDepth` in `parse.h`) of the
+// deepest parse tree from which an `Expander` may be assembled.  The
+// `advance` and `printCurrent` member functions recurse once per level of the
+// tree, so an `Expander` assembled from a deeper tree could overflow the call
+// stack.
+const int MAX_EXPANDER_DEPTH = 10000;
+
+// Return a reference to an `Expander` assembled using the specified parse tree
+// `root`, where the `Expander` and all of its parts are allocated from the
+// specified `arena`.  The behavior is undefined if the returned object is
+// used after `arena` is reset or destroyed, or after the input of `root` is
+// modified or destroyed.  The behavior of the returned object is undefined if
+// the depth of `root` is greater than `MAX_EXPANDER_DEPTH`.
+Expander& expander(Arena& arena, const ParseTreeNode& root);
+
+// `Cardinality` describes the size of the expansion of a parse tree.
+struct Cardinality {
+    BigUnsigned terms;  // how many terms the expansion has
+    BigUnsigned bytes;  // the sum of the lengths of the terms, in bytes
+};
+
+// Return the cardinality of the expansion of the specified parse tree `root`,
+// computed from the tree alone, without expanding it.  The number of terms of
+// an alternation is the sum of those of its children, and the number of terms
+// of a sequence is the product of those of its children.  The size of a range
+// is computed from its bounds, without visiting its values.
+Cardinality cardinality(const ParseTreeNode& root);
 
 // Insert into the specified `stream` all of the values produced by the
 // specified `expander`, where each inserted value is separated from the next
-// by the specified `separator`.
+// by the specified `separator`.  Stop after the optionally specified `limit`
+// number of values, if the expansion has that many.
 void expand(std::ostream&      stream,
             Expander&          expander,
-            const std::string& separator);
+            const std::string& separator,
+            std::uint64_t      limit = std::uint64_t(-1));
 
 }  // namespace brex
 
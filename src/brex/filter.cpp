@@ -0,0 +1,187 @@
+#include <brex/compile.h>
+#include <brex/filter.h>
+#include <brex/pattern.h>
+#include <brex/range.h>
+#include <brex/sink.h>
+
+#include <cassert>
+
+namespace brex {
+
+// class FilteredOdometer
+// ----------------------
+
+bool FilteredOdometer::descend(int pc, int parent, int state) {
+    const auto&       instructions = program->instructions;
+    const char* const literals     = program->literals.data();
+
+    for (;;) {
+        assert(pc >= 0);
+        assert(pc < int(instructions.size()));
+
+        const Program::Instruction& instruction = instructions[pc];
+
+        switch (instruction.opcode) {
+            case Program::Opcode::LITERAL: {
+                const char* const begin = literals + instruction.first;
+                const char* const end   = begin + instruction.count;
+                for (const char* byte = begin; byte != end; ++byte) {
+                    state = pattern->step(state, *byte);
+                    if (state == Pattern::DEAD) {
+                        return false;
+                    }
+                }
+                value.append(begin, end);
+                ++pc;
+            } break;
+            case Program::Opcode::SLOT: {
+                Wheel wheel;
+                wheel.instruction = pc;
+                wheel.digit       = 0;
+                wheel.resume      = pc + 1;
+                wheel.parent      = parent;
+                wheel.offset      = value.size();
+                wheel.state       = state;
+
+                parent = wheels.size();
+                wheels.push_back(wheel);
+                pc = program->branches[instruction.first];
+            } break;
+            case Program::Opcode::RANGE: {
+                Wheel wheel;
+                wheel.instruction = pc;
+                wheel.digit       = 0;
+                wheel.resume      = pc + 1;
+                wheel.parent      = parent;
+                wheel.offset      = value.size();
+                wheel.state       = state;
+
+                wheels.push_back(wheel);
+                state = appendRange(wheels.back());
+                if (state == Pattern::DEAD) {
+                    return false;
+                }
+                ++pc;
+            } break;
+            default:
+                assert(instruction.opcode == Program::Opcode::RETURN);
+                if (parent == -1) {
+                    return pattern->accepts(state);  // end of the root chain
+                }
+                pc     = wheels[parent].resume;
+                parent = wheels[parent].parent;
+        }
+    }
+}
+
+int FilteredOdometer::appendRange(Wheel& wheel) {
+    const Program::Instruction& instruction =
+        program->instructions[wheel.instruction];
+    const Range& range = program->ranges[instruction.first];
+
+    for (;;) {
+        value.resize(wheel.offset + range.maxLength());
+        const int length = range.format(&value[wheel.offset], wheel.digit);
+        value.resize(wheel.offset + length);
+
+        int state = wheel.state;
+        int i     = 0;
+        for (; i < length; ++i) {
+            state = pattern->step(state, value[wheel.offset + i]);
+            if (state == Pattern::DEAD) {
+                break;
+            }
+        }
+        if (i == length) {
+            return state;
+        }
+
+        // Every value whose text begins with the same `i + 1` bytes fails
+        // the same way, so skip past all of them, as `next` skips past an
+        // alternative that fails.
+        const int skip = range.skip(wheel.digit, i + 1);
+        if (skip == instruction.count) {
+            wheel.digit = skip - 1;
+            return Pattern::DEAD;
+        }
+        wheel.digit = skip;
+    }
+}
+
+FilteredOdometer::FilteredOdometer(const Program& program, Pattern& pattern)
+: program(&program)
+, pattern(&pattern) {
+}
+
+bool FilteredOdometer::first() {
+    value.clear();
+    wheels.clear();
+    return descend(program->root, -1, pattern->start()) || next();
+}
+
+bool FilteredOdometer::next() {
+    const auto& instructions = program->instructions;
+
+    for (int i = int(wheels.size()) - 1; i >= 0;) {
+        Wheel&                      wheel = wheels[i];
+        const Program::Instruction& slot  = instructions[wheel.instruction];
+
+        if (++wheel.digit == slot.count) {
+            --i;  // This wheel rolled over, so turn the one before it.
+            continue;
+        }
+
+        // As in `Odometer::advance`, rewrite the value from this wheel
+        // onward.  If the new value is abandoned, then turn the last wheel
+        // that it reached, which might be this one.
+        wheels.resize(i + 1);
+        if (slot.opcode == Program::Opcode::RANGE) {
+            // Unlike `Odometer::advance`, format the range's text from
+            // scratch, since every byte of it is fed to the pattern anyway.
+            const int state = appendRange(wheel);
+            if (state != Pattern::DEAD &&
+                descend(wheel.resume, wheel.parent, state)) {
+                return true;
+            }
+        }
+        else {
+            value.resize(wheel.offset);
+            if (descend(program->branches[slot.first + wheel.digit],
+                        i,
+                        wheel.state)) {
+                return true;
+            }
+        }
+        i = int(wheels.size()) - 1;
+    }
+
+    return false;
+}
+
+const std::string& FilteredOdometer::current() const {
+    return value;
+}
+
+// free functions
+// --------------
+
+std::uint64_t expandFiltered(Sink&              sink,
+                             FilteredOdometer&  odometer,
+                             const std::string& separator,
+                             std::uint64_t      limit) {
+    if (limit == 0 || !odometer.first()) {
+        return 0;
+    }
+
+    sink.write(odometer.current());
+
+    std::uint64_t count = 1;
+    for (; count < limit && odometer.next(); ++count) {
+        sink.write(separator);
+        sink.write(odometer.current());
+    }
+
+    return count;
+}
+
+}  // namespace brex
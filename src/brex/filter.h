@@ -0,0 +1,105 @@
+#ifndef INCLUDED_BREX_FILTER
+#define INCLUDED_BREX_FILTER
+
+#include <cstdint>  // uint64_t
+#include <string>
+#include <vector>
+
+namespace brex {
+
+class Pattern;
+struct Program;
+class Sink;
+
+// `FilteredOdometer` iterates over those values of a compiled `Program` (see
+// `compile.h`) that match a `Pattern` (see `pattern.h`), in the order in
+// which `Odometer` (see `odometer.h`) would produce them.
+//
+// It works as `Odometer` does, except that each byte appended to the current
+// value is also fed to the pattern, and each wheel remembers the pattern's
+// state where the wheel begins.  As soon as the pattern reaches a state from
+// which nothing can match, the value is abandoned before it is finished, and
+// the last wheel that was reached is turned instead.  That skips, all at
+// once, every value that begins the same way: every combination of the
+// wheels that the abandoned value had not yet reached.  A pattern that
+// constrains the beginning of a value, such as a prefix, thus prunes most of
+// the expansion at the first slot where it fails, and the cost of an
+// expansion follows the number of values that match rather than the number
+// of values in all.  A range prunes the same way within itself: when the
+// text of one of its values fails, every value whose text begins with the
+// bytes that failed is skipped at once (see `Range::skip`), so a range of a
+// billion values costs a few steps per digit rather than a billion steps.
+// A pattern that constrains only the end of a value, such as `*.txt`, can't
+// prune anything, and costs a table lookup per byte more than `Odometer`
+// does.
+class FilteredOdometer {
+    struct Wheel {
+        int instruction;  // index of the `SLOT` or `RANGE` instruction
+        int digit;        // which branch of the slot, or value of the range,
+                          // is selected
+        int resume;       // index of the instruction that follows the slot
+        int parent;       // index of the wheel whose branch this is in, or -1
+        int offset;       // length of the value that precedes the slot
+        int state;        // pattern state after the value preceding the slot
+    };
+
+    const Program*     program;
+    Pattern*           pattern;
+    std::vector<Wheel> wheels;
+    std::string        value;
+
+    // Starting at the specified instruction index `pc` within a branch of the
+    // wheel at the specified index `parent`, and with the pattern in the
+    // specified `state`, walk the remainder of the current value as
+    // `Odometer::descend` does.  Return `true` if the value is finished and
+    // matches the pattern.  Return `false` as soon as it is known that the
+    // value can't match, in which case the value and the wheels reached so
+    // far are left as they were at that point.
+    bool descend(int pc, int parent, int state);
+
+    // Append to `value` the text of the first value of the range of the
+    // specified `wheel`, at or after the one that the wheel selects, whose
+    // text can still match, feeding it to the pattern starting from the
+    // wheel's state, and turn the wheel to that value.  Return the resulting
+    // pattern state, or return `Pattern::DEAD` if no such value remains, in
+    // which case the wheel is left at the range's last value.
+    int appendRange(Wheel& wheel);
+
+  public:
+    // Create an object that iterates over the values of the specified
+    // `program` that match the specified `pattern`.  Call `first()` before
+    // accessing any value.  The behavior is undefined unless `program` and
+    // `pattern` outlive this object.
+    FilteredOdometer(const Program& program, Pattern& pattern);
+
+    // Set this object to the first matching value of its program.  Return
+    // `true` on success, or `false` if no value matches.
+    bool first();
+
+    // Set this object to the next matching value of its program.  Return
+    // `true` on success, or `false` if there are no more matching values, in
+    // which case the current value is unspecified.  The behavior is
+    // undefined unless the most recent call to `first()` or `next()`
+    // returned `true`.
+    bool next();
+
+    // Return a reference providing non-modifiable access to the current value
+    // of this object.  The reference remains valid for the lifetime of this
+    // object, but the value to which it refers changes with each call to
+    // `first()` or `next()`.
+    const std::string& current() const;
+};
+
+// Append to the specified `sink` the values produced by the specified
+// `odometer`, starting with its first, where each appended value is
+// separated from the next by the specified `separator`.  Stop after the last
+// value, or after the optionally specified `limit` number of values.  Return
+// the number of values appended.
+std::uint64_t expandFiltered(Sink&              sink,
+                             FilteredOdometer&  odometer,
+                             const std::string& separator,
+                             std::uint64_t      limit = std::uint64_t(-1));
+
+}  // namespace brex
+
+#endif
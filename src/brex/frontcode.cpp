@@ -0,0 +1,177 @@
+#include <brex/frontcode.h>
+#include <brex/odometer.h>
+#include <brex/sink.h>
+
+#include <istream>
+#include <ostream>  // operator<<
+#include <streambuf>
+
+namespace brex {
+namespace {
+
+// the most bytes that the LEB128 encoding of a 64-bit value can have
+const int MAX_VARINT_SIZE = 10;
+
+// the longest term that `decodeFrontCoded` accepts
+const std::uint64_t MAX_TERM_SIZE = std::uint64_t(1) << 32;
+
+// the most bytes of a term that `decodeFrontCoded` reads at once, so that
+// memory for a term is allocated only as its bytes arrive, rather than all
+// at once for whatever length a corrupt record claims
+const std::size_t READ_SIZE = 1 << 16;
+
+// Encode the specified `value` as a varint into the buffer at the specified
+// `output`, which must have room for `MAX_VARINT_SIZE` bytes.  Return the
+// number of bytes written.
+int encodeVarint(char* output, std::uint64_t value) {
+    int size = 0;
+    while (value >= 0x80) {
+        output[size++] = char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    output[size++] = char(value);
+    return size;
+}
+
+// `VarintResult` is returned by `decodeVarint`.
+enum class VarintResult { SUCCESS, END_OF_INPUT, TRUNCATED, TOO_LARGE };
+
+// Load into the specified `value` a varint read from the specified `input`.
+// Return `VarintResult::SUCCESS` on success, `VarintResult::END_OF_INPUT` if
+// `input` has no more bytes, or another value if the varint is invalid,
+// including if it has bits beyond the 64th.
+VarintResult decodeVarint(std::uint64_t& value, std::streambuf& input) {
+    typedef std::streambuf::traits_type Traits;
+
+    value = 0;
+    for (int i = 0; i < MAX_VARINT_SIZE; ++i) {
+        const Traits::int_type byte = input.sbumpc();
+        if (Traits::eq_int_type(byte, Traits::eof())) {
+            return i == 0 ? VarintResult::END_OF_INPUT
+                          : VarintResult::TRUNCATED;
+        }
+
+        // The last byte holds only the 64th bit, and can't continue.
+        if (i == MAX_VARINT_SIZE - 1 && byte > 1) {
+            return VarintResult::TOO_LARGE;
+        }
+
+        value |= std::uint64_t(byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0) {
+            return VarintResult::SUCCESS;
+        }
+    }
+
+    return VarintResult::TOO_LARGE;
+}
+
+// Append to the specified `sink` the front coding of the specified `value`,
+// which shares the specified `shared` number of leading bytes with the
+// previous value.
+void writeTerm(Sink& sink, const std::string& value, std::size_t shared) {
+    char      header[2 * MAX_VARINT_SIZE];
+    const int size = encodeVarint(header, shared);
+    const int both =
+        size + encodeVarint(header + size, value.size() - shared);
+
+    sink.write(header, both);
+    sink.write(value.data() + shared, value.size() - shared);
+}
+
+}  // namespace
+
+void expandFrontCoded(Sink& sink, Odometer& odometer, std::uint64_t limit) {
+    if (limit == 0) {
+        return;
+    }
+
+    writeTerm(sink, odometer.current(), 0);
+
+    while (--limit && odometer.advance() == AdvanceResult::NO_CARRY) {
+        writeTerm(sink, odometer.current(), odometer.stableLength());
+    }
+}
+
+void expandLengthPrefixed(Sink&         sink,
+                          Odometer&     odometer,
+                          std::uint64_t limit) {
+    if (limit == 0) {
+        return;
+    }
+
+    do {
+        const std::string& value = odometer.current();
+        char               header[MAX_VARINT_SIZE];
+        sink.write(header, encodeVarint(header, value.size()));
+        sink.write(value);
+    } while (--limit && odometer.advance() == AdvanceResult::NO_CARRY);
+}
+
+int decodeFrontCoded(Sink&              sink,
+                     std::istream&      input,
+                     const std::string& separator,
+                     std::ostream*      errors) {
+    std::streambuf& buffer = *input.rdbuf();
+    std::string     term;  // reused for every term
+    std::uint64_t   count = 0;
+
+    for (;; ++count) {
+        std::uint64_t shared;
+        std::uint64_t length;
+
+        VarintResult result = decodeVarint(shared, buffer);
+        if (result == VarintResult::END_OF_INPUT) {
+            break;
+        }
+        if (result == VarintResult::SUCCESS) {
+            result = decodeVarint(length, buffer);
+        }
+
+        const char* problem = nullptr;
+        if (result != VarintResult::SUCCESS) {
+            problem = result == VarintResult::TOO_LARGE
+                          ? "a length does not fit in 64 bits"
+                          : "the input ends within a length";
+        }
+        else if (shared > term.size()) {
+            problem = "the shared prefix is longer than the previous term";
+        }
+        else if (length > MAX_TERM_SIZE - shared) {
+            problem = "the term is too long";
+        }
+        else {
+            term.resize(shared);
+            while (length && !problem) {
+                const std::size_t piece =
+                    length < READ_SIZE ? length : READ_SIZE;
+                const std::size_t size = term.size();
+                term.resize(size + piece);
+                if (buffer.sgetn(&term[size], piece) !=
+                    std::streamsize(piece)) {
+                    problem = "the input ends within a term";
+                }
+                length -= piece;
+            }
+        }
+
+        if (problem) {
+            if (errors) {
+                *errors << "Invalid front coding at term " << count << ": "
+                        << problem << ".\n";
+            }
+            return 1;
+        }
+
+        if (count) {
+            sink.write(separator);
+        }
+        sink.write(term);
+    }
+
+    if (count) {
+        sink.write("\n", 1);
+    }
+    return 0;
+}
+
+}  // namespace brex
@@ -0,0 +1,62 @@
+#ifndef INCLUDED_BREX_FRONTCODE
+#define INCLUDED_BREX_FRONTCODE
+
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // istream&, ostream*
+#include <string>
+
+namespace brex {
+
+class Odometer;
+class Sink;
+
+// Front coding is a compact binary encoding of a list of terms, where
+// consecutive terms usually share long prefixes, as those of an expansion
+// do.  Each term is encoded as
+//
+// 1. the number of leading bytes that it shares with the previous term,
+// 2. the number of bytes that follow the shared prefix,
+// 3. those bytes.
+//
+// Both numbers are unsigned LEB128 varints: seven bits per byte, least
+// significant first, with the high bit set on every byte but the last.  The
+// first term shares nothing with its (nonexistent) previous term.  An
+// encoding is just its terms' encodings one after another; it has no header
+// or trailer.
+
+// Append to the specified `sink` the front coding of the values produced by
+// the specified `odometer`, starting with its current value.  Stop after the
+// last value, or after the optionally specified `limit` number of values.
+// The shared prefix of each value is the part of the value that the
+// odometer's advance did not rewrite (see `Odometer::stableLength`), so no
+// values are compared.
+void expandFrontCoded(Sink&         sink,
+                      Odometer&     odometer,
+                      std::uint64_t limit = std::uint64_t(-1));
+
+// Append to the specified `sink` the values produced by the specified
+// `odometer`, starting with its current value, each as a length-prefixed
+// record: its length in bytes as a LEB128 varint, followed by its bytes.
+// Stop after the last value, or after the optionally specified `limit`
+// number of values.  This is front coding (see above) without the shared
+// prefix, so that each record stands alone: a reader can skip a record
+// without decoding any other.
+void expandLengthPrefixed(Sink&         sink,
+                          Odometer&     odometer,
+                          std::uint64_t limit = std::uint64_t(-1));
+
+// Read a front coding from the specified `input` until the end of `input`,
+// and append to the specified `sink` the terms that it encodes, where each
+// term is separated from the next by the specified `separator`, and the last
+// is followed by a newline.  Return zero on success, or a nonzero value if
+// the input is not a valid front coding.  If the input is invalid and the
+// optionally specified `errors` is not null, then write a diagnostic to
+// `errors`.  Terms decoded before the error is found are appended to `sink`.
+int decodeFrontCoded(Sink&              sink,
+                     std::istream&      input,
+                     const std::string& separator,
+                     std::ostream*      errors = nullptr);
+
+}  // namespace brex
+
+#endif
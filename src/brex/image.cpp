@@ -0,0 +1,376 @@
+#include <brex/compile.h>
+#include <brex/expand.h>
+#include <brex/image.h>
+#include <brex/mapped.h>
+#include <brex/range.h>
+#include <brex/sink.h>
+
+#include <cerrno>
+#include <climits>  // INT_MAX
+#include <cstring>  // memcmp, memcpy
+#include <ostream>
+#include <vector>
+
+#include <fcntl.h>   // open
+#include <unistd.h>  // close
+
+namespace brex {
+namespace {
+
+const char          MAGIC[8]   = {'b', 'r', 'e', 'x', 'p', 'r', 'o', 'g'};
+const std::uint32_t ORDER_MARK = 0x01020304;
+
+// the sections of an image, in order
+enum Section { INSTRUCTIONS, BRANCHES, LITERALS, RANGES, TERMS, BYTES };
+
+const int SECTION_COUNT = BYTES + 1;
+
+// the size in bytes of a record of each section
+const std::size_t RECORD_SIZES[SECTION_COUNT] = {12, 4, 1, 32, 4, 4};
+
+// the offsets of the fields of the header
+const std::size_t CHECKSUM_OFFSET = 16;
+const std::size_t SIZE_OFFSET     = 24;
+const std::size_t ROOT_OFFSET     = 32;
+const std::size_t COUNT_OFFSET    = 36;
+const std::size_t TABLE_OFFSET    = 40;
+const std::size_t HEADER_SIZE     = TABLE_OFFSET + SECTION_COUNT * 16;
+
+// Return the checksum of the specified `size` bytes at the specified `data`,
+// where `size` is a multiple of 8.  This is FNV-1a applied to 8 byte words,
+// with a shift after each multiplication so that every bit of a word
+// affects the low bits of the result, too.
+std::uint64_t checksum(const char* data, std::size_t size) {
+    std::uint64_t result = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        result = (result ^ word) * 1099511628211ull;
+        result ^= result >> 29;
+    }
+    return result;
+}
+
+// Append to the specified `output` the bytes of the specified `value`.
+template <typename Integer>
+void put(std::string& output, Integer value) {
+    output.append(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+// Return the integer of type `Integer` at the specified `offset` within the
+// specified `data`.
+template <typename Integer>
+Integer get(const char* data, std::size_t offset) {
+    Integer result;
+    std::memcpy(&result, data + offset, sizeof result);
+    return result;
+}
+
+// Append to the specified `output` the base 2^32 digits of the specified
+// `value`, least significant first, and return how many there are.
+std::uint64_t putLimbs(std::string& output, const BigUnsigned& value) {
+    const int count = (value.bitLength() + 31) / 32;
+    for (int i = 0; i < count; ++i) {
+        put(output, value.limb(i));
+    }
+    return count;
+}
+
+// Load into the specified `output` the number whose specified `count` base
+// 2^32 digits, least significant first, are at the specified `data`.
+void getLimbs(BigUnsigned& output, const char* data, std::uint64_t count) {
+    std::vector<std::uint32_t> limbs(count);
+    if (count) {
+        std::memcpy(limbs.data(), data, count * 4);
+    }
+    BigUnsigned::fromLimbs(output, limbs.data(), limbs.size());
+}
+
+// Return whether the specified `range` is one that `parse` could produce,
+// having the specified `count` number of values.
+bool validRange(const Range& range, int count) {
+    const auto small = [](std::int64_t value) {
+        return value > -MAX_RANGE_MAGNITUDE && value < MAX_RANGE_MAGNITUDE;
+    };
+    if (!small(range.start) || !small(range.end) || !small(range.step) ||
+        range.step == 0 || (range.end < range.start) != (range.step < 0) ||
+        range.width < 0) {
+        return false;
+    }
+
+    if (range.letters) {
+        const auto lower = [](std::int64_t code) {
+            return code >= 'a' && code <= 'z';
+        };
+        const auto upper = [](std::int64_t code) {
+            return code >= 'A' && code <= 'Z';
+        };
+        if (!(lower(range.start) && lower(range.end)) &&
+            !(upper(range.start) && upper(range.end))) {
+            return false;
+        }
+    }
+
+    const std::uint64_t distance =
+        range.end < range.start ? range.start - range.end
+                                : range.end - range.start;
+    const std::uint64_t stride = range.step < 0 ? -range.step : range.step;
+    return distance / stride < INT_MAX && range.count() == count;
+}
+
+}  // namespace
+
+void writeImage(std::string&       output,
+                const Program&     program,
+                const Cardinality& cardinality) {
+    output.assign(HEADER_SIZE, '\0');
+    std::memcpy(&output[0], MAGIC, sizeof MAGIC);
+    std::memcpy(&output[8], &IMAGE_VERSION, 4);
+    std::memcpy(&output[12], &ORDER_MARK, 4);
+
+    std::uint64_t table[SECTION_COUNT][2];  // offset and count of each
+
+    // Pad to the next multiple of 8 bytes, and begin the specified
+    // `section`.
+    const auto begin = [&](Section section) {
+        output.resize((output.size() + 7) / 8 * 8, '\0');
+        table[section][0] = output.size();
+    };
+
+    begin(INSTRUCTIONS);
+    for (const Program::Instruction& instruction : program.instructions) {
+        put(output, std::int32_t(instruction.opcode));
+        put(output, std::int32_t(instruction.first));
+        put(output, std::int32_t(instruction.count));
+    }
+    table[INSTRUCTIONS][1] = program.instructions.size();
+
+    begin(BRANCHES);
+    for (const int branch : program.branches) {
+        put(output, std::int32_t(branch));
+    }
+    table[BRANCHES][1] = program.branches.size();
+
+    begin(LITERALS);
+    output += program.literals;
+    table[LITERALS][1] = program.literals.size();
+
+    begin(RANGES);
+    for (const Range& range : program.ranges) {
+        put(output, std::int64_t(range.start));
+        put(output, std::int64_t(range.end));
+        put(output, std::int64_t(range.step));
+        put(output, std::int32_t(range.width));
+        put(output, std::int32_t(range.letters));
+    }
+    table[RANGES][1] = program.ranges.size();
+
+    begin(TERMS);
+    table[TERMS][1] = putLimbs(output, cardinality.terms);
+
+    begin(BYTES);
+    table[BYTES][1] = putLimbs(output, cardinality.bytes);
+
+    output.resize((output.size() + 7) / 8 * 8, '\0');
+
+    const std::uint64_t size  = output.size();
+    const std::int32_t  root  = program.root;
+    const std::uint32_t count = SECTION_COUNT;
+    std::memcpy(&output[SIZE_OFFSET], &size, 8);
+    std::memcpy(&output[ROOT_OFFSET], &root, 4);
+    std::memcpy(&output[COUNT_OFFSET], &count, 4);
+    std::memcpy(&output[TABLE_OFFSET], table, sizeof table);
+
+    const std::uint64_t sum = checksum(output.data() + SIZE_OFFSET,
+                                       output.size() - SIZE_OFFSET);
+    std::memcpy(&output[CHECKSUM_OFFSET], &sum, 8);
+}
+
+int readImage(Program&      program,
+              Cardinality&  cardinality,
+              const char*   data,
+              std::size_t   size,
+              std::ostream* errors) {
+    // Return a nonzero value, having written the specified `problem` to
+    // `errors`.
+    const auto fail = [&](const char* problem) {
+        if (errors) {
+            *errors << "Invalid compiled expression image: " << problem
+                    << "\n";
+        }
+        return 1;
+    };
+
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof MAGIC)) {
+        return fail("it does not begin with a brex image header.");
+    }
+    if (get<std::uint32_t>(data, 8) != IMAGE_VERSION) {
+        if (errors) {
+            *errors << "Invalid compiled expression image: it has format "
+                       "version "
+                    << get<std::uint32_t>(data, 8) << ", but this brex reads "
+                    << "only version " << IMAGE_VERSION
+                    << ".  Compile the expression again.\n";
+        }
+        return 1;
+    }
+    if (get<std::uint32_t>(data, 12) != ORDER_MARK) {
+        return fail("it was written on a machine of another byte order.");
+    }
+    if (get<std::uint64_t>(data, SIZE_OFFSET) != size || size % 8 != 0) {
+        return fail("its size is not the size recorded in its header.");
+    }
+    if (checksum(data + SIZE_OFFSET, size - SIZE_OFFSET) !=
+        get<std::uint64_t>(data, CHECKSUM_OFFSET)) {
+        return fail("its checksum does not match its contents.");
+    }
+    if (get<std::uint32_t>(data, COUNT_OFFSET) != SECTION_COUNT) {
+        return fail("it has the wrong number of sections.");
+    }
+
+    const char*   sections[SECTION_COUNT];
+    std::uint64_t counts[SECTION_COUNT];
+    for (int i = 0; i < SECTION_COUNT; ++i) {
+        const std::uint64_t offset =
+            get<std::uint64_t>(data, TABLE_OFFSET + i * 16);
+        counts[i] = get<std::uint64_t>(data, TABLE_OFFSET + i * 16 + 8);
+        if (offset < HEADER_SIZE || offset % 8 != 0 || offset > size ||
+            counts[i] > (size - offset) / RECORD_SIZES[i] ||
+            counts[i] > INT_MAX) {
+            return fail("a section lies outside of the image.");
+        }
+        sections[i] = data + offset;
+    }
+
+    // Copy the sections into `program`, checking each instruction against
+    // what `compile` could produce.  `chain` is the index of the first
+    // instruction of the chain being read.
+    program.literals.assign(sections[LITERALS], counts[LITERALS]);
+
+    program.branches.resize(counts[BRANCHES]);
+    for (std::size_t i = 0; i < program.branches.size(); ++i) {
+        program.branches[i] = get<std::int32_t>(sections[BRANCHES], i * 4);
+    }
+
+    program.ranges.resize(counts[RANGES]);
+    for (std::size_t i = 0; i < program.ranges.size(); ++i) {
+        const char* const record = sections[RANGES] + i * 32;
+        Range&            range  = program.ranges[i];
+        range.start              = get<std::int64_t>(record, 0);
+        range.end                = get<std::int64_t>(record, 8);
+        range.step               = get<std::int64_t>(record, 16);
+        range.width              = get<std::int32_t>(record, 24);
+        range.letters            = get<std::int32_t>(record, 28) != 0;
+    }
+
+    const int instructionCount = int(counts[INSTRUCTIONS]);
+    const int branchCount      = int(counts[BRANCHES]);
+    const int rangeCount       = int(counts[RANGES]);
+    const int literalCount     = int(counts[LITERALS]);
+    std::vector<char> starts(instructionCount);  // whether each begins a chain
+    int               chain = 0;
+
+    program.instructions.resize(instructionCount);
+    for (int i = 0; i < instructionCount; ++i) {
+        const char* const     record      = sections[INSTRUCTIONS] + i * 12;
+        Program::Instruction& instruction = program.instructions[i];
+        const std::int32_t    opcode      = get<std::int32_t>(record, 0);
+        instruction.first                 = get<std::int32_t>(record, 4);
+        instruction.count                 = get<std::int32_t>(record, 8);
+
+        if (i == 0 || program.instructions[i - 1].opcode ==
+                          Program::Opcode::RETURN) {
+            chain     = i;
+            starts[i] = true;
+        }
+
+        const int first = instruction.first;
+        const int count = instruction.count;
+        bool      valid = first >= 0 && count >= 0;
+        switch (opcode) {
+            case int(Program::Opcode::LITERAL):
+                instruction.opcode = Program::Opcode::LITERAL;
+                valid = valid && count <= literalCount - first;
+                break;
+            case int(Program::Opcode::SLOT):
+                instruction.opcode = Program::Opcode::SLOT;
+                valid = valid && count > 0 && count <= branchCount - first;
+                // A branch must lead to the beginning of an earlier chain.
+                for (int j = 0; valid && j < count; ++j) {
+                    const int branch = program.branches[first + j];
+                    valid = branch >= 0 && branch < chain && starts[branch];
+                }
+                break;
+            case int(Program::Opcode::RANGE):
+                instruction.opcode = Program::Opcode::RANGE;
+                valid = valid && first < rangeCount &&
+                        validRange(program.ranges[first], count);
+                break;
+            case int(Program::Opcode::RETURN):
+                instruction.opcode = Program::Opcode::RETURN;
+                break;
+            default:
+                valid = false;
+        }
+
+        if (!valid) {
+            return fail("it contains an invalid instruction.");
+        }
+    }
+
+    program.root = get<std::int32_t>(data, ROOT_OFFSET);
+    if (instructionCount == 0 ||
+        program.instructions.back().opcode != Program::Opcode::RETURN ||
+        program.root < 0 || program.root >= instructionCount ||
+        !starts[program.root]) {
+        return fail("its program is incomplete.");
+    }
+
+    getLimbs(cardinality.terms, sections[TERMS], counts[TERMS]);
+    getLimbs(cardinality.bytes, sections[BYTES], counts[BYTES]);
+    return 0;
+}
+
+int saveImage(const std::string& path,
+              const Program&     program,
+              const Cardinality& cardinality,
+              std::ostream*      errors) {
+    std::string image;
+    writeImage(image, program, cardinality);
+
+    const int fileDescriptor =
+        ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    int error = fileDescriptor == -1 ? errno : 0;
+    if (!error) {
+        Sink sink(fileDescriptor);
+        sink.write(image);
+        error = sink.flush();
+        if (::close(fileDescriptor) && !error) {
+            error = errno;
+        }
+    }
+
+    if (error && errors) {
+        *errors << "Unable to write the compiled expression to " << path
+                << " (errno " << error << ").\n";
+    }
+    return error != 0;
+}
+
+int loadImage(Program&           program,
+              Cardinality&       cardinality,
+              const std::string& path,
+              std::ostream*      errors) {
+    MappedFile file;
+    if (const int error = file.open(path)) {
+        if (errors) {
+            *errors << "Unable to open the compiled expression " << path
+                    << " (errno " << error << ").\n";
+        }
+        return 1;
+    }
+
+    return readImage(program, cardinality, file.data(), file.size(), errors);
+}
+
+}  // namespace brex
@@ -0,0 +1,93 @@
+#ifndef INCLUDED_BREX_IMAGE
+#define INCLUDED_BREX_IMAGE
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t
+#include <iosfwd>   // ostream*
+#include <string>
+
+namespace brex {
+
+struct Cardinality;
+struct Program;
+
+// An image is a compiled `Program` (see `compile.h`) and the `Cardinality`
+// of its expansion (see `expand.h`), serialized so that an expression can be
+// compiled once and expanded many times without being parsed again.
+//
+// An image is a header followed by sections, each of which is an array of
+// fixed size records:
+//
+// - the 8 byte magic string "brexprog",
+// - `IMAGE_VERSION`, as a 4 byte integer,
+// - the 4 byte integer 0x01020304, to detect a different byte order,
+// - a 64-bit checksum of everything that follows it,
+// - the size of the whole image in bytes, as an 8 byte integer,
+// - the program's `root`, as a 4 byte integer,
+// - the number of sections, as a 4 byte integer,
+// - the offset from the beginning of the image, and the number of records,
+//   of each section, as 8 byte integers,
+// - the sections: the program's instructions (three 4 byte integers each:
+//   opcode, `first`, and `count`), branches (4 bytes each), literals (1 byte
+//   each), and ranges (32 bytes each: `start`, `end`, and `step` as 8 byte
+//   integers, then `width` and `letters` as 4 byte integers), followed by
+//   the number of terms and the number of bytes of the expansion, each as
+//   its base 2^32 digits, least significant first (4 bytes each).
+//
+// Integers are in the byte order of the machine that wrote the image.  Every
+// section begins at a multiple of 8 bytes, and padding is zero.  Since
+// sections refer to each other only by index, an image can be mapped at any
+// address.
+//
+// The checksum detects truncated and damaged images, not forged ones.
+// Loading also checks that the program is well formed, e.g. that every
+// index is in bounds and that every chain comes after the chains that it
+// branches to, so that a bad image is rejected rather than expanded.  The
+// recorded size of the expansion is not checked, since computing it again
+// would cost as much as parsing the expression again.  `--count` reports it
+// as recorded, and `--output` compares it with the program before relying
+// on it (see `expandToFile` in `layout.h`).
+
+// `IMAGE_VERSION` is the version of the image format.  It changes whenever
+// `Program`, or the way that an image encodes it, changes, so that an image
+// written by another version of brex is rejected.
+const std::uint32_t IMAGE_VERSION = 1;
+
+// Load into the specified `output` the image of the specified `program` and
+// `cardinality`.
+void writeImage(std::string&       output,
+                const Program&     program,
+                const Cardinality& cardinality);
+
+// Load into the specified `program` and `cardinality` the contents of the
+// image at the specified `data` having the specified `size` in bytes.  Return
+// zero on success, or a nonzero value if the image is invalid, in which case
+// `program` and `cardinality` are unspecified, and if the specified `errors`
+// is not null, a diagnostic is written to it.
+int readImage(Program&      program,
+              Cardinality&  cardinality,
+              const char*   data,
+              std::size_t   size,
+              std::ostream* errors);
+
+// Write the image of the specified `program` and `cardinality` to the file
+// at the specified `path`, replacing any file there.  Return zero on success
+// or a nonzero value otherwise, in which case write a diagnostic to the
+// specified `errors` if it is not null.
+int saveImage(const std::string& path,
+              const Program&     program,
+              const Cardinality& cardinality,
+              std::ostream*      errors);
+
+// Map the image in the file at the specified `path` into memory, and load
+// its contents into the specified `program` and `cardinality` as `readImage`
+// does.  Return zero on success or a nonzero value otherwise, in which case
+// write a diagnostic to the specified `errors` if it is not null.
+int loadImage(Program&           program,
+              Cardinality&       cardinality,
+              const std::string& path,
+              std::ostream*      errors);
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef INCLUDED_BREX_INTERNER
+#define INCLUDED_BREX_INTERNER
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <vector>
+
+namespace brex {
+
+// Combine the specified `value` into the specified `hash` (FNV-1a, applied to
+// whole values rather than to bytes).
+void mix(std::uint64_t& hash, std::uint64_t value);
+
+// Combine the specified `element` into the specified `hash`.
+void mixElement(std::uint64_t& hash, char element);
+void mixElement(std::uint64_t& hash, int element);
+
+// Return whether the specified `left` and `right` are equal.
+bool sameElement(char left, char right);
+bool sameElement(int left, int right);
+
+// `Interner` finds repeated spans within a pool, which is a `std::string` or
+// `std::vector` to which elements are appended.  A span is appended to the
+// pool and then interned.  If an equal span was interned before, then the
+// new one is removed from the pool, and the earlier one is used instead.
+// Each distinct span has an index: the number of distinct spans interned
+// before it.
+//
+// Elements are hashed and compared using `mixElement` and `sameElement`,
+// which are provided above for `char` and `int`, and which for any other
+// element type must be found by argument dependent lookup.
+//
+// The spans are kept in an open addressing hash table with linear probing,
+// which is faster here than a `std::unordered_set`, since there is no
+// allocation per span.
+template <typename Pool>
+class Interner {
+    struct Span {
+        std::uint64_t hash;
+        int           offset;
+        int           length;
+    };
+
+    Pool&             pool;
+    std::vector<Span> spans;
+    std::vector<int>  table;  // index into `spans`, or -1 if empty
+
+    // Return the hash of the specified `length` elements of the pool
+    // beginning at the specified `offset`.
+    std::uint64_t hash(int offset, int length) const;
+
+    // Return whether the specified spans have equal elements.
+    bool equal(const Span& left, const Span& right) const;
+
+    // Double the size of the table.
+    void grow();
+
+  public:
+    // Create an object that interns spans of the specified `pool`.
+    explicit Interner(Pool& pool);
+
+    // If the last specified `length` elements of the pool are equal to a
+    // span interned earlier, then remove them from the pool and return the
+    // index of the earlier span.  Otherwise, intern them and return their
+    // index, which is the previous value of `size()`.
+    int intern(int length);
+
+    // Forget all interned spans and clear the pool.
+    void clear();
+
+    // Return the offset within the pool of the span having the specified
+    // `index`.
+    int offset(int index) const;
+
+    // Return the length of the span having the specified `index`.
+    int length(int index) const;
+
+    // Return the number of distinct spans interned.
+    int size() const;
+};
+
+// inline definitions
+// ------------------
+
+inline void mix(std::uint64_t& hash, std::uint64_t value) {
+    hash = (hash ^ value) * 1099511628211ull;
+}
+
+inline void mixElement(std::uint64_t& hash, char element) {
+    mix(hash, static_cast<unsigned char>(element));
+}
+
+inline void mixElement(std::uint64_t& hash, int element) {
+    mix(hash, unsigned(element));
+}
+
+inline bool sameElement(char left, char right) {
+    return left == right;
+}
+
+inline bool sameElement(int left, int right) {
+    return left == right;
+}
+
+template <typename Pool>
+Interner<Pool>::Interner(Pool& pool)
+: pool(pool)
+, table(1024, -1) {
+}
+
+template <typename Pool>
+std::uint64_t Interner<Pool>::hash(int offset, int length) const {
+    std::uint64_t result = 14695981039346656037ull;
+    mix(result, unsigned(length));
+    for (int i = 0; i < length; ++i) {
+        mixElement(result, pool[offset + i]);
+    }
+    return result;
+}
+
+template <typename Pool>
+bool Interner<Pool>::equal(const Span& left, const Span& right) const {
+    if (left.hash != right.hash || left.length != right.length) {
+        return false;
+    }
+    for (int i = 0; i < left.length; ++i) {
+        if (!sameElement(pool[left.offset + i], pool[right.offset + i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Pool>
+void Interner<Pool>::grow() {
+    std::vector<int>  bigger(table.size() * 2, -1);
+    const std::size_t mask = bigger.size() - 1;
+
+    for (int i = 0; i < int(spans.size()); ++i) {
+        std::size_t slot = spans[i].hash & mask;
+        while (bigger[slot] != -1) {
+            slot = (slot + 1) & mask;
+        }
+        bigger[slot] = i;
+    }
+
+    table.swap(bigger);
+}
+
+template <typename Pool>
+int Interner<Pool>::intern(int length) {
+    Span span;
+    span.offset = int(pool.size()) - length;
+    span.length = length;
+    span.hash   = hash(span.offset, length);
+
+    const std::size_t mask = table.size() - 1;
+    std::size_t       slot = span.hash & mask;
+
+    for (; table[slot] != -1; slot = (slot + 1) & mask) {
+        if (equal(span, spans[table[slot]])) {
+            pool.resize(span.offset);
+            return table[slot];
+        }
+    }
+
+    const int index = int(spans.size());
+    table[slot]     = index;
+    spans.push_back(span);
+    if (spans.size() * 2 > table.size()) {
+        grow();
+    }
+
+    return index;
+}
+
+template <typename Pool>
+void Interner<Pool>::clear() {
+    pool.clear();
+    spans.clear();
+    table.assign(1024, -1);
+}
+
+template <typename Pool>
+int Interner<Pool>::offset(int index) const {
+    return spans[index].offset;
+}
+
+template <typename Pool>
+int Interner<Pool>::length(int index) const {
+    return spans[index].length;
+}
+
+template <typename Pool>
+int Interner<Pool>::size() const {
+    return int(spans.size());
+}
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,378 @@
+#include <brex/bigunsigned.h>
+#include <brex/compile.h>
+#include <brex/expand.h>
+#include <brex/layout.h>
+#include <brex/odometer.h>
+#include <brex/range.h>
+#include <brex/rank.h>
+
+#include <algorithm>  // max, min, upper_bound
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>  // INT64_MAX, uintptr_t
+#include <cstring>  // memcpy
+#include <ostream>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>     // fallocate, open
+#include <sys/mman.h>  // madvise, mmap, munmap
+#include <unistd.h>    // close, ftruncate, sysconf
+
+namespace brex {
+namespace {
+
+// Return the number of bytes in the first `count` values of the specified
+// `range`.
+std::uint64_t prefixLength(const Range& range, int count) {
+    if (count == 0) {
+        return 0;
+    }
+    Range prefix = range;
+    prefix.end   = range.value(count - 1);
+    return prefix.totalLength();
+}
+
+// Expand the chunks of `program` claimed from the specified `nextChunk`,
+// each having the specified `chunkTerms` number of terms, into the specified
+// `output`, as described by `expandInto`.
+void expandChunks(char*                       output,
+                  const Program&              program,
+                  const Ranking&              ranking,
+                  const Layout&               layout,
+                  char                        delimiter,
+                  char                        terminator,
+                  std::uint64_t               chunkTerms,
+                  std::atomic<std::uint64_t>& nextChunk) {
+    Odometer odometer(program);
+
+    for (;;) {
+        const std::uint64_t first = nextChunk++ * chunkTerms;
+        if (first >= layout.terms()) {
+            return;
+        }
+        const std::uint64_t last =
+            std::min(first + chunkTerms, layout.terms());
+
+        // Each term is followed by one byte, so the chunk begins after those
+        // of the terms before it.
+        char*       position = output + layout.offset(first) + first;
+        char* const end      = output + layout.offset(last) + last;
+
+        // Fault in the chunk's pages all at once, rather than one at a time
+        // as they're first written.  This is only advice, and kernels before
+        // Linux 5.14 don't take it.
+        const std::uintptr_t page  = ::sysconf(_SC_PAGESIZE);
+        const std::uintptr_t begin = std::uintptr_t(position) / page * page;
+        ::madvise(reinterpret_cast<void*>(begin),
+                  std::uintptr_t(end) - begin,
+                  MADV_POPULATE_WRITE);
+
+        odometer.seek(ranking, first);
+        for (std::uint64_t index = first;; ++index) {
+            const std::string& term = odometer.current();
+            std::memcpy(position, term.data(), term.size());
+            position += term.size();
+
+            if (index + 1 == last) {
+                *position = last == layout.terms() ? terminator : delimiter;
+                break;
+            }
+            *position++ = delimiter;
+
+            const AdvanceResult result = odometer.advance();
+            assert(result == AdvanceResult::NO_CARRY);
+            (void)result;
+        }
+    }
+}
+
+}  // namespace
+
+// class Layout
+// ------------
+
+Layout::Layout(const Program& program)
+: program(&program)
+, partTerms(program.instructions.size())
+, partBytes(program.instructions.size())
+, suffixTerms(program.instructions.size())
+, suffixBytes(program.instructions.size())
+, branchTerms(program.branches.size())
+, branchBytes(program.branches.size())
+, longestRange(0) {
+    const auto& instructions = program.instructions;
+    const int   size         = instructions.size();
+
+    // As in `Ranking`, walking the instructions forwards visits every chain
+    // before any slot that refers to it.  `chainTerms` and `chainBytes` are
+    // indexed by the instruction index at which a chain begins.
+    std::vector<std::uint64_t> chainTerms(size);
+    std::vector<std::uint64_t> chainBytes(size);
+    int                        chainBegin = 0;
+
+    for (int pc = 0; pc < size; ++pc) {
+        const Program::Instruction& instruction = instructions[pc];
+
+        switch (instruction.opcode) {
+            case Program::Opcode::LITERAL:
+                partTerms[pc] = 1;
+                partBytes[pc] = instruction.count;
+                break;
+            case Program::Opcode::SLOT:
+                for (int i = 0; i < instruction.count; ++i) {
+                    const int branch    = instruction.first + i;
+                    const int chain     = program.branches[branch];
+                    branchTerms[branch] = partTerms[pc];
+                    branchBytes[branch] = partBytes[pc];
+                    partTerms[pc] += chainTerms[chain];
+                    partBytes[pc] += chainBytes[chain];
+                }
+                break;
+            case Program::Opcode::RANGE: {
+                const Range& range = program.ranges[instruction.first];
+                partTerms[pc]      = instruction.count;
+                partBytes[pc]      = range.totalLength();
+                longestRange       = std::max(longestRange, range.maxLength());
+            } break;
+            default: {
+                assert(instruction.opcode == Program::Opcode::RETURN);
+                // This is the end of a chain, so the chain is complete.  A
+                // chain's expansion is the cross product of its parts'
+                // expansions, so each part's terms are repeated once for
+                // every term of the parts that follow it.
+                std::uint64_t terms = 1;
+                std::uint64_t bytes = 0;
+                for (int part = pc - 1; part >= chainBegin; --part) {
+                    suffixTerms[part] = terms;
+                    suffixBytes[part] = bytes;
+                    bytes = partBytes[part] * terms + partTerms[part] * bytes;
+                    terms *= partTerms[part];
+                }
+                chainTerms[chainBegin] = terms;
+                chainBytes[chainBegin] = bytes;
+                chainBegin             = pc + 1;
+            }
+        }
+    }
+
+    totalTerms = chainTerms[program.root];
+    totalBytes = chainBytes[program.root];
+}
+
+std::uint64_t Layout::offset(std::uint64_t index) const {
+    assert(index <= totalTerms);
+
+    if (index == totalTerms) {
+        return totalBytes;
+    }
+
+    // The term at `index` is walked as `Odometer` would walk it, keeping
+    // track of its length so far in `position`.  Within a chain, the terms
+    // that precede it are, for each part, those that agree with it on the
+    // parts before and choose an earlier term of that part.  A chain within
+    // a slot's branch is entered with a `multiplier`, since each term that
+    // precedes it within the branch is repeated once for every term of the
+    // parts that follow the slot, and so on outward.
+    struct Frame {
+        int           pc;          // the next instruction of the chain
+        std::uint64_t index;       // of the term within the chain
+        std::uint64_t multiplier;  // how many times the chain is repeated
+        std::uint64_t start;       // `position` where the chain began
+    };
+
+    const auto&        instructions = program->instructions;
+    std::vector<Frame> frames(1, Frame{program->root, index, 1, 0});
+    std::string        text(longestRange, '\0');
+    std::uint64_t      result   = 0;
+    std::uint64_t      position = 0;
+
+    while (!frames.empty()) {
+        const Frame                 frame       = frames.back();
+        const Program::Instruction& instruction = instructions[frame.pc];
+        ++frames.back().pc;
+
+        if (instruction.opcode == Program::Opcode::RETURN) {
+            frames.pop_back();
+            continue;
+        }
+        if (instruction.opcode == Program::Opcode::LITERAL) {
+            position += instruction.count;
+            continue;
+        }
+
+        // The part's digit is that of `frame.index` in a mixed radix whose
+        // last part is the least significant.
+        const std::uint64_t repeat = suffixTerms[frame.pc];
+        const std::uint64_t digit =
+            frame.index / repeat % partTerms[frame.pc];
+
+        // Each of the `digit` earlier terms of this part begins `repeat`
+        // terms of the chain, each having the same text before this part as
+        // the term at `index` does, and between them, every term of the
+        // parts that follow.  The earlier terms' own bytes, `repeat` times
+        // over, are added below.
+        result += frame.multiplier * digit *
+                  (repeat * (position - frame.start) + suffixBytes[frame.pc]);
+
+        if (instruction.opcode == Program::Opcode::RANGE) {
+            const Range& range = program->ranges[instruction.first];
+            result += frame.multiplier * repeat * prefixLength(range, digit);
+            position += range.format(&text[0], digit);
+            continue;
+        }
+
+        // Find the last branch that begins at or before `digit`.  The slot's
+        // expansion is the concatenation of its branches' expansions.
+        const auto begin  = branchTerms.begin() + instruction.first;
+        const auto end    = begin + instruction.count;
+        const int  branch = instruction.first +
+                           int(std::upper_bound(begin, end, digit) - begin) -
+                           1;
+
+        result += frame.multiplier * repeat * branchBytes[branch];
+        frames.push_back(Frame{program->branches[branch],
+                               digit - branchTerms[branch],
+                               frame.multiplier * repeat,
+                               position});
+    }
+
+    return result;
+}
+
+void expandInto(char*              output,
+                const Program&     program,
+                const Ranking&     ranking,
+                const Layout&      layout,
+                const std::string& delimiter,
+                const std::string& terminator,
+                int                threads) {
+    assert(delimiter.size() == 1);
+    assert(terminator.size() == 1);
+    assert(threads > 0);
+
+    // Aim for chunks of at most about a megabyte, judging by the longest
+    // term, as `expandParallel` does.
+    const std::uint64_t chunkTerms =
+        std::max<std::uint64_t>(1, (1 << 20) / (longestValue(program) + 1));
+
+    // If the system won't start as many workers as were asked for, those
+    // that it did start, if any, share the work with the calling thread.
+    std::atomic<std::uint64_t> nextChunk(0);
+    std::vector<std::thread>   workers;
+    for (int i = 1; i < threads; ++i) {
+        try {
+            workers.emplace_back(expandChunks,
+                                 output,
+                                 std::cref(program),
+                                 std::cref(ranking),
+                                 std::cref(layout),
+                                 delimiter[0],
+                                 terminator[0],
+                                 chunkTerms,
+                                 std::ref(nextChunk));
+        }
+        catch (const std::system_error&) {
+            break;
+        }
+    }
+
+    // The calling thread is a worker, too.
+    expandChunks(output,
+                 program,
+                 ranking,
+                 layout,
+                 delimiter[0],
+                 terminator[0],
+                 chunkTerms,
+                 nextChunk);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int expandToFile(const std::string& path,
+                 const Program&     program,
+                 const Ranking&     ranking,
+                 const Cardinality& cardinality,
+                 const std::string& delimiter,
+                 const std::string& terminator,
+                 int                threads,
+                 std::ostream*      errors) {
+    // Every term is followed by a one byte delimiter or terminator.
+    const BigUnsigned total = cardinality.bytes + cardinality.terms;
+    if (!total.fitsUint64() || total.toUint64() > INT64_MAX ||
+        total.toUint64() > std::size_t(-1)) {
+        if (errors) {
+            *errors << "The expansion is " << total
+                    << " bytes, which is too large to write to a file.\n";
+        }
+        return 1;
+    }
+
+    // `cardinality` bounds the sums that `Layout` computes, so they can't
+    // overflow.  Even so, the file is sized from the `Layout` that says
+    // where each term goes, and a `cardinality` that disagrees with it is
+    // refused rather than trusted.
+    const Layout        layout(program);
+    const std::uint64_t size = layout.bytes() + layout.terms();
+    if (size != total.toUint64()) {
+        if (errors) {
+            *errors << "The expansion is " << size << " bytes, but "
+                    << total << " bytes were expected.\n";
+        }
+        return 1;
+    }
+
+    // Return a nonzero value, having written a diagnostic mentioning the
+    // specified `what` and the current `errno`.
+    const auto fail = [&](const char* what) {
+        if (errors) {
+            *errors << "Unable to " << what << " the output file " << path
+                    << " (errno " << errno << ").\n";
+        }
+        return 1;
+    };
+
+    const int fileDescriptor =
+        ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fileDescriptor == -1) {
+        return fail("open");
+    }
+
+    // Reserving the file's blocks up front means that running out of space
+    // is reported here, rather than as a `SIGBUS` while writing the mapping.
+    // Not every file system can, though, so those merely set the size.
+    if (::fallocate(fileDescriptor, 0, 0, size) &&
+        (errno != EOPNOTSUPP || ::ftruncate(fileDescriptor, size))) {
+        const int status = fail("allocate");
+        ::close(fileDescriptor);
+        return status;
+    }
+
+    void* const map = ::mmap(
+        nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (map == MAP_FAILED) {
+        const int status = fail("map");
+        ::close(fileDescriptor);
+        return status;
+    }
+
+    expandInto(static_cast<char*>(map),
+               program,
+               ranking,
+               layout,
+               delimiter,
+               terminator,
+               threads);
+
+    ::munmap(map, size);
+    if (::close(fileDescriptor)) {
+        return fail("close");
+    }
+    return 0;
+}
+
+}  // namespace brex
@@ -0,0 +1,120 @@
+#ifndef INCLUDED_BREX_LAYOUT
+#define INCLUDED_BREX_LAYOUT
+
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // ostream*
+#include <string>
+#include <vector>
+
+namespace brex {
+
+struct Cardinality;
+struct Program;
+class Ranking;
+
+// `Layout` holds the number of terms, and the number of bytes in those terms,
+// produced by each part of a compiled `Program` (see `compile.h`), so that
+// where any term begins within the output can be found directly, without
+// expanding the terms before it.  Where `Ranking` finds the term at an index,
+// `Layout` finds the byte offset of the term at an index.
+//
+// Every count is a `std::uint64_t`, since a layout is only of use for an
+// expansion small enough to be written out.  Each part of the program
+// contributes at least once to the whole expansion, so if the whole fits,
+// then so does each part.
+class Layout {
+    const Program* program;
+
+    // the number of terms of each instruction, and the number of bytes in
+    // them, indexed by instruction index (one term for a `LITERAL`)
+    std::vector<std::uint64_t> partTerms;
+    std::vector<std::uint64_t> partBytes;
+
+    // the number of terms of the instructions that follow each instruction
+    // in its chain, and the number of bytes in them, indexed by instruction
+    // index
+    std::vector<std::uint64_t> suffixTerms;
+    std::vector<std::uint64_t> suffixBytes;
+
+    // the number of terms of a slot that precede each of its branches, and
+    // the number of bytes in them, parallel to `program->branches`
+    std::vector<std::uint64_t> branchTerms;
+    std::vector<std::uint64_t> branchBytes;
+
+    std::uint64_t totalTerms;
+    std::uint64_t totalBytes;
+    int           longestRange;  // the greatest `Range::maxLength()`
+
+  public:
+    // Create an object describing the specified `program`.  The behavior is
+    // undefined unless `program` outlives this object, and unless the number
+    // of terms of its expansion plus the number of bytes in them is
+    // representable as a `std::uint64_t`.
+    explicit Layout(const Program& program);
+
+    // Return the number of terms of the whole expansion.
+    std::uint64_t terms() const;
+
+    // Return the number of bytes in the terms of the whole expansion, not
+    // counting any separators.
+    std::uint64_t bytes() const;
+
+    // Return the number of bytes in the terms that precede the term at the
+    // specified zero-based `index` within the expansion, not counting any
+    // separators.  The behavior is undefined unless `index <= terms()`.
+    // This operation takes time proportional to the number of slots that the
+    // term passes through, not to `index`.
+    std::uint64_t offset(std::uint64_t index) const;
+};
+
+// Write to the specified `output` the values of the specified `program`,
+// each followed by the specified `delimiter`, except for the last, which is
+// followed by the specified `terminator`.  `output` must have room for
+// exactly `layout.bytes() + layout.terms()` bytes.  Use the specified
+// `threads` number of worker threads, counting the calling thread, or as
+// many as the system will start, which divide the expansion into chunks,
+// and use the specified `ranking` and `layout` of `program` to seek to the
+// first term of each chunk and to find where in `output` it goes.  Every
+// chunk is written in place, independently of the others.  The
+// behavior is undefined unless `delimiter` and `terminator` are each one
+// byte, `threads` is positive, and `ranking` and `layout` were created from
+// `program`.
+void expandInto(char*              output,
+                const Program&     program,
+                const Ranking&     ranking,
+                const Layout&      layout,
+                const std::string& delimiter,
+                const std::string& terminator,
+                int                threads);
+
+// Write the values of the specified `program` to the file at the specified
+// `path`, replacing any file there, as `expandInto` does.  The file is first
+// allocated at its final size, and then mapped into memory and written in
+// place.  Return zero on success or a nonzero value otherwise, in which case
+// write a diagnostic to the specified `errors` if it is not null.  Fail
+// without writing anything if the expansion, whose size the specified
+// `cardinality` of `program` gives, is too large to be addressed, or if
+// `cardinality` is not that of `program`.
+int expandToFile(const std::string& path,
+                 const Program&     program,
+                 const Ranking&     ranking,
+                 const Cardinality& cardinality,
+                 const std::string& delimiter,
+                 const std::string& terminator,
+                 int                threads,
+                 std::ostream*      errors);
+
+// inline definitions
+// ------------------
+
+inline std::uint64_t Layout::terms() const {
+    return totalTerms;
+}
+
+inline std::uint64_t Layout::bytes() const {
+    return totalBytes;
+}
+
+}  // namespace brex
+
+#endif
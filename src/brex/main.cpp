@@ -1,12 +1,39 @@
+#include <brex/arena.h>
+#include <brex/batch.h>
+#include <brex/compile.h>
 #include <brex/expand.h>
+#include <brex/filter.h>
+#include <brex/frontcode.h>
+#include <brex/image.h>
+#include <brex/layout.h>
+#include <brex/mapped.h>
+#include <brex/match.h>
+#include <brex/odometer.h>
 #include <brex/options.h>
+#include <brex/parallel.h>
 #include <brex/parse.h>
+#include <brex/pattern.h>
+#include <brex/rank.h>
+#include <brex/sample.h>
+#include <brex/serve.h>
+#include <brex/sink.h>
+#include <brex/stats.h>
 
+#include <cstddef>  // size_t
+#include <cstdint>
+#include <cstring>   // memchr
 #include <iostream>  // cout, cerr
 #include <memory>
 #include <ostream>  // ostream::traits_type
+#include <random>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include <pthread.h>  // pthread_sigmask
+#include <signal.h>   // sigaddset, sigemptyset, sigwait, SIGINT, SIGTERM
+#include <unistd.h>   // STDOUT_FILENO
 
 int main(int, char* argv[]) {
     brex::Options options;
@@ -22,24 +49,197 @@ int main(int, char* argv[]) {
         return 0;
     }
 
+    // Terms are separated by `delimiter`, and the last is followed by
+    // `terminator`.  With `-0`, every term is terminated by a null byte.
     std::ostream* const errors = options.verbose ? &std::cerr : nullptr;
+    const std::string   null(1, '\0');
+    const std::string   delimiter =
+        options.null ? null : options.lines ? "\n" : " ";
+    const std::string terminator = options.null ? null : "\n";
+
+    // Flush the specified `sink`.  Return zero on success, or return 1
+    // having written a diagnostic if any write to standard output failed.
+    const auto flushOutput = [&](brex::Sink& sink) {
+        if (const int error = sink.flush()) {
+            if (errors) {
+                *errors << "Unable to write to standard output (errno "
+                        << error << ").\n";
+            }
+            return 1;
+        }
+        return 0;
+    };
+
+    if (options.decode) {
+        // As with `--batch`, standard input isn't shared with C's standard
+        // I/O, and unsynchronized, `std::cin` reads it in large blocks.
+        std::ios::sync_with_stdio(false);
+
+        brex::Sink sink(STDOUT_FILENO,
+                        options.bufferSize ? options.bufferSize
+                                           : brex::Sink::DEFAULT_CAPACITY);
+        const int status =
+            brex::decodeFrontCoded(sink, std::cin, delimiter, errors);
+
+        if (flushOutput(sink)) {
+            return 1;
+        }
+        return status;
+    }
+
+    if (options.batch) {
+        // Standard input is read line by line, and standard output isn't
+        // written through `std::cout`, so there's nothing to synchronize with
+        // C's standard I/O.  Unsynchronized, `std::cin` buffers its input,
+        // which is faster and lets `expandBatch` see when there's no more
+        // input ready.
+        std::ios::sync_with_stdio(false);
+
+        brex::Sink sink(STDOUT_FILENO,
+                        options.bufferSize ? options.bufferSize
+                                           : brex::Sink::DEFAULT_CAPACITY);
+        brex::expandBatch(sink,
+                          std::cin,
+                          options.limit ? options.limit : std::uint64_t(-1),
+                          errors);
+
+        return flushOutput(sink);
+    }
+
+    if (options.serve) {
+        // `SIGINT` and `SIGTERM` are blocked in every thread, and instead
+        // received by `waiter`, which stops the server, so that the server
+        // removes its socket on the way out.
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        brex::ProgramCache cache(options.cacheSize
+                                     ? options.cacheSize
+                                     : brex::ProgramCache::DEFAULT_CAPACITY);
+        brex::Server       server(cache,
+                            options.limit ? options.limit : std::uint64_t(-1),
+                            options.bufferSize
+                                ? options.bufferSize
+                                : brex::Server::DEFAULT_BUFFER_SIZE);
+        if (server.open(options.socketPath, errors)) {
+            return 1;
+        }
+
+        std::thread waiter([&] {
+            int signal;
+            sigwait(&signals, &signal);
+            server.stop();
+        });
+
+        const unsigned processors = std::thread::hardware_concurrency();
+        server.run(options.threads ? int(options.threads)
+                                   : processors ? int(processors) : 1);
 
-    std::string input;
-    std::getline(std::cin, input);
+        // `run` returns only once `waiter` has stopped the server, unless
+        // every worker failed, in which case `waiter` is still waiting.
+        pthread_kill(waiter.native_handle(), SIGTERM);
+        waiter.join();
+        return 0;
+    }
+
+    if (options.match) {
+        // As with `--batch`, the rest of standard input is read line by line.
+        std::ios::sync_with_stdio(false);
+    }
 
-    if (std::cin.peek() != std::ostream::traits_type::eof()) {
-        // There are characters after the first newline, which violates the
-        // specification.
+    brex::Pattern pattern;
+    if (options.prefix) {
+        pattern.assignPrefix(options.pattern);
+    }
+    else if (options.glob && pattern.assignGlob(options.pattern)) {
         if (errors) {
-            *errors << "Encountered input after initial newline.\n";
+            *errors << "Invalid --glob pattern: " << options.pattern << "\n";
         }
-        return 2;
+        return 1;
     }
 
+    // `stats` is null unless `--stats` is given, so that nothing is measured
+    // otherwise.
+    brex::Stats        statistics;
+    brex::Stats* const stats = options.stats ? &statistics : nullptr;
+    brex::Stopwatch    stopwatch;
+
+    // With `--load`, the compiled expression and its cardinality are read
+    // from an image, and there's no expression to read or to parse.  The
+    // parse tree refers to `input`, or with `--input` to `inputFile`, so
+    // they're declared first.
+    std::string         input;
+    brex::MappedFile    inputFile;
+    brex::Arena         arena;
     brex::ParseTreeNode parseTree;
-    const auto          result = brex::parse(parseTree, input, errors);
-    if (result != brex::ParseResult::SUCCESS) {
-        return int(result);
+    brex::Program       program;
+    brex::Cardinality   loaded;
+
+    if (options.load) {
+        if (brex::loadImage(program, loaded, options.imagePath, errors)) {
+            return 1;
+        }
+    }
+    else {
+        // The expression is the first line of the input, which is viewed in
+        // place if it's a mapped file, and otherwise copied into `input`.
+        const char* expression;
+        std::size_t expressionSize;
+        bool        trailing;  // whether anything follows the first newline
+
+        if (options.input) {
+            if (const int error = inputFile.open(options.inputPath)) {
+                if (errors) {
+                    *errors << "Unable to read the input file "
+                            << options.inputPath << " (errno " << error
+                            << ").\n";
+                }
+                return 1;
+            }
+
+            const char* const begin   = inputFile.data();
+            const char* const end     = begin + inputFile.size();
+            const char* const newline = static_cast<const char*>(
+                std::memchr(begin, '\n', inputFile.size()));
+            expression     = begin;
+            expressionSize = (newline ? newline : end) - begin;
+            trailing       = newline && newline + 1 != end;
+        }
+        else {
+            std::getline(std::cin, input);
+            expression     = input.data();
+            expressionSize = input.size();
+            trailing       = !options.match &&
+                       std::cin.peek() != std::ostream::traits_type::eof();
+        }
+
+        if (stats) {
+            stopwatch.lap(stats->read);
+        }
+
+        if (trailing) {
+            // There are characters after the first newline, which violates
+            // the specification.
+            if (errors) {
+                *errors << "Encountered input after initial newline.\n";
+            }
+            return 2;
+        }
+
+        // The parse tree, and the `Expander` built from it, are allocated
+        // from `arena` and freed all at once.
+        const auto result = brex::parse(
+            parseTree, arena, expression, expressionSize, errors);
+        if (result != brex::ParseResult::SUCCESS) {
+            return int(result);
+        }
+
+        if (stats) {
+            stopwatch.lap(stats->parse);
+        }
     }
 
     if (options.parse) {
@@ -47,9 +247,232 @@ int main(int, char* argv[]) {
         return 0;
     }
 
-    const char* const delimiter = options.lines ? "\n" : " ";
+    if (options.match) {
+        brex::Automaton automaton;
+        if (brex::automaton(automaton, parseTree)) {
+            if (errors) {
+                *errors << "The expression would need more than "
+                        << brex::MAX_AUTOMATON_STATES
+                        << " automaton states for --match.\n";
+            }
+            return 1;
+        }
+
+        brex::Sink sink(STDOUT_FILENO,
+                        options.bufferSize ? options.bufferSize
+                                           : brex::Sink::DEFAULT_CAPACITY);
+        brex::printMatches(sink, automaton, std::cin);
+
+        return flushOutput(sink);
+    }
+
+    if (options.count) {
+        // Every term is followed by a one byte delimiter, except for the
+        // last, which is followed by a newline.
+        const brex::Cardinality cardinality =
+            options.load ? loaded : brex::cardinality(parseTree);
+        std::cout << "{\"terms\": " << cardinality.terms
+                  << ", \"bytes\": " << (cardinality.bytes + cardinality.terms)
+                  << "}\n";
+        return 0;
+    }
+
+    const std::uint64_t limit =
+        options.limit ? options.limit : std::uint64_t(-1);
+
+    // Return the specified `status`, having first printed statistics if
+    // `--stats` was given.  The specified `bytes` were written, as were the
+    // specified `terms`, or if `terms` is null, then every term from
+    // `options.offset` onward, up to `limit`.
+    const auto finish = [&](int                      status,
+                            std::uint64_t            bytes,
+                            const brex::BigUnsigned* terms) {
+        if (stats) {
+            stopwatch.lap(stats->expand);
+            if (terms) {
+                stats->terms = *terms;
+            }
+            else {
+                stats->terms =
+                    brex::cardinality(parseTree).terms - options.offset;
+                if (stats->terms > limit) {
+                    stats->terms = limit;
+                }
+            }
+            stats->bytes       = bytes;
+            stats->arenaBlocks = arena.blockCount();
+            stats->arenaBytes  = arena.bytesReserved();
+            brex::countNodes(*stats, parseTree);
+            stats->peakResidentKilobytes = brex::peakResidentKilobytes();
+            brex::printStats(std::cerr, *stats);
+        }
+        return status;
+    };
+
+    // With `--stats`, output written through `std::cout` is counted on its
+    // way to standard output.
+    std::streambuf* const      standardOutput = std::cout.rdbuf();
+    brex::CountingStreamBuffer counter(standardOutput);
+
+    if (options.tree) {
+        const int depth = brex::treeDepth(parseTree);
+        if (depth > brex::MAX_EXPANDER_DEPTH) {
+            if (errors) {
+                *errors << "The expression is nested too deeply for --tree.  "
+                           "Its parse tree has depth "
+                        << depth << ", but the maximum supported is "
+                        << brex::MAX_EXPANDER_DEPTH << ".\n";
+            }
+            return 1;
+        }
+
+        brex::Expander& expander = brex::expander(arena, parseTree);
+        if (stats) {
+            stopwatch.lap(stats->build);
+            std::cout.rdbuf(&counter);
+        }
+
+        brex::expand(std::cout, expander, delimiter, limit);
+        std::cout << terminator;
+        std::cout.rdbuf(standardOutput);
+        return finish(0, counter.bytes(), nullptr);
+    }
+
+    if (!options.load) {
+        brex::compile(program, parseTree);
+
+        if (stats) {
+            stopwatch.lap(stats->build);
+        }
+    }
+
+    if (options.compile) {
+        return brex::saveImage(options.imagePath,
+                               program,
+                               brex::cardinality(parseTree),
+                               errors);
+    }
+
+    if (options.output) {
+        const brex::Cardinality cardinality =
+            options.load ? loaded : brex::cardinality(parseTree);
+        const brex::Ranking ranking(program);
+        if (brex::expandToFile(options.outputPath,
+                               program,
+                               ranking,
+                               cardinality,
+                               delimiter,
+                               terminator,
+                               options.threads ? int(options.threads) : 1,
+                               errors)) {
+            return 1;
+        }
+        const brex::BigUnsigned bytes = cardinality.bytes + cardinality.terms;
+        return finish(0, bytes.toUint64(), &cardinality.terms);
+    }
+
+    if (options.prefix || options.glob) {
+        brex::Sink sink(STDOUT_FILENO,
+                        options.bufferSize ? options.bufferSize
+                                           : brex::Sink::DEFAULT_CAPACITY);
+        brex::FilteredOdometer  odometer(program, pattern);
+        const brex::BigUnsigned terms =
+            brex::expandFiltered(sink, odometer, delimiter, limit);
+        if (!terms.isZero()) {
+            sink.write(terminator);
+        }
+
+        if (flushOutput(sink)) {
+            return 1;
+        }
+        return finish(0, sink.bytesWritten(), &terms);
+    }
 
-    const auto expanderPtr = brex::expander(parseTree);
-    brex::expand(std::cout, *expanderPtr, delimiter);
-    std::cout << "\n";
+    brex::Odometer odometer(program);
+
+    if (options.sample) {
+        const brex::Ranking ranking(program);
+        std::mt19937_64     generator(options.seeded ? options.seed
+                                                     : std::random_device()());
+
+        brex::Sink sink(STDOUT_FILENO,
+                        options.bufferSize ? options.bufferSize
+                                           : brex::Sink::DEFAULT_CAPACITY);
+        const brex::BigUnsigned terms = brex::expandSample(sink,
+                                                           odometer,
+                                                           ranking,
+                                                           options.sample,
+                                                           options.distinct,
+                                                           generator,
+                                                           delimiter);
+        sink.write(terminator);
+
+        if (flushOutput(sink)) {
+            return 1;
+        }
+        return finish(0, sink.bytesWritten(), &terms);
+    }
+
+    std::unique_ptr<brex::Ranking> ranking;
+    if (!options.offset.isZero() || options.threads > 1) {
+        ranking.reset(new brex::Ranking(program));
+    }
+
+    if (!options.offset.isZero()) {
+        if (options.offset >= ranking->terms()) {
+            if (!options.nth) {
+                // There's nothing to print.
+                const brex::BigUnsigned none;
+                return finish(0, 0, &none);
+            }
+            if (errors) {
+                *errors << "The expansion has only " << ranking->terms()
+                        << " terms, so there is no term at index "
+                        << options.offset << ".\n";
+            }
+            return 1;
+        }
+        odometer.seek(*ranking, options.offset);
+    }
+
+    if (options.ostream) {
+        if (stats) {
+            std::cout.rdbuf(&counter);
+        }
+        brex::expand(std::cout, odometer, delimiter, limit);
+        std::cout << terminator;
+        std::cout.rdbuf(standardOutput);
+        return finish(0, counter.bytes(), nullptr);
+    }
+
+    brex::Sink sink(STDOUT_FILENO,
+                    options.bufferSize ? options.bufferSize
+                                       : brex::Sink::DEFAULT_CAPACITY);
+    if (options.threads > 1) {
+        brex::expandParallel(sink,
+                             program,
+                             *ranking,
+                             delimiter,
+                             options.offset,
+                             limit,
+                             options.threads);
+    }
+    else if (options.frontCode) {
+        brex::expandFrontCoded(sink, odometer, limit);
+    }
+    else if (options.lengthPrefixed) {
+        brex::expandLengthPrefixed(sink, odometer, limit);
+    }
+    else {
+        brex::expand(sink, odometer, delimiter, limit);
+    }
+
+    if (!options.frontCode && !options.lengthPrefixed) {
+        sink.write(terminator);
+    }
+
+    if (flushOutput(sink)) {
+        return 1;
+    }
+    return finish(0, sink.bytesWritten(), nullptr);
 }
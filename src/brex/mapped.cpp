@@ -0,0 +1,75 @@
+#include <brex/mapped.h>
+
+#include <cerrno>
+
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // madvise, mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+namespace brex {
+
+// class MappedFile
+// ----------------
+
+MappedFile::MappedFile()
+: begin("")
+, length(0)
+, map(nullptr) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (map) {
+        ::munmap(map, length);
+    }
+    begin  = "";
+    length = 0;
+    map    = nullptr;
+}
+
+int MappedFile::open(const std::string& path) {
+    close();
+
+    const int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor == -1) {
+        return errno;
+    }
+
+    struct stat status;
+    if (::fstat(fileDescriptor, &status)) {
+        const int error = errno;
+        ::close(fileDescriptor);
+        return error;
+    }
+
+    // An empty file can't be mapped, but there's nothing in it to view.
+    if (status.st_size != 0) {
+        void* const result = ::mmap(nullptr,
+                                    status.st_size,
+                                    PROT_READ,
+                                    MAP_PRIVATE,
+                                    fileDescriptor,
+                                    0);
+        if (result == MAP_FAILED) {
+            const int error = errno;
+            ::close(fileDescriptor);
+            return error;
+        }
+
+        // The file is read from beginning to end, once.
+        ::madvise(result, status.st_size, MADV_SEQUENTIAL);
+
+        map    = result;
+        begin  = static_cast<const char*>(result);
+        length = status.st_size;
+    }
+
+    ::close(fileDescriptor);
+    return 0;
+}
+
+}  // namespace brex
@@ -0,0 +1,58 @@
+#ifndef INCLUDED_BREX_MAPPED
+#define INCLUDED_BREX_MAPPED
+
+#include <cstddef>  // size_t
+#include <string>
+
+namespace brex {
+
+// `MappedFile` is a read-only view of the contents of a file, mapped into
+// memory rather than read into a buffer, so that pages are loaded only as
+// they're touched and are shared with the operating system's file cache.
+// The view remains valid until the object is destroyed or opened again.
+class MappedFile {
+    const char* begin;
+    std::size_t length;
+    void*       map;  // as returned by `mmap`, or null if nothing is mapped
+
+    // Unmap any file that this object has mapped.
+    void close();
+
+  public:
+    // Create an object that views an empty file.
+    MappedFile();
+
+    // Unmap any file that this object has mapped, and destroy this object.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file at the specified `path`, replacing any view that this
+    // object had before.  Return zero on success or the `errno` value of the
+    // failed operation otherwise, in which case this object views an empty
+    // file.
+    int open(const std::string& path);
+
+    // Return a pointer to the first byte of the file.  The bytes are not
+    // followed by a null terminator.
+    const char* data() const;
+
+    // Return the number of bytes in the file.
+    std::size_t size() const;
+};
+
+// inline definitions
+// ------------------
+
+inline const char* MappedFile::data() const {
+    return begin;
+}
+
+inline std::size_t MappedFile::size() const {
+    return length;
+}
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,379 @@
+#include <brex/interner.h>
+#include <brex/match.h>
+#include <brex/parse.h>
+#include <brex/range.h>
+#include <brex/sink.h>
+
+#include <algorithm>  // binary_search, fill, min, sort, unique
+#include <cassert>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace brex {
+namespace {
+
+// `Nfa` is a nondeterministic finite automaton without epsilon transitions.
+// State zero is the initial state and state one is the only accepting state.
+// Since the language of a brace expression is finite, the automaton is
+// acyclic.
+struct Nfa {
+    struct Edge {
+        int from;
+        int column;  // see `Automaton::classes`
+        int to;
+    };
+
+    int               states;
+    std::vector<Edge> edges;  // sorted by `from`, then `column`, then `to`
+    std::vector<int>  first;  // index of the first edge from each state,
+                              // followed by `edges.size()`
+};
+
+bool operator<(const Nfa::Edge& left, const Nfa::Edge& right) {
+    if (left.from != right.from) {
+        return left.from < right.from;
+    }
+    if (left.column != right.column) {
+        return left.column < right.column;
+    }
+    return left.to < right.to;
+}
+
+bool operator==(const Nfa::Edge& left, const Nfa::Edge& right) {
+    return left.from == right.from && left.column == right.column &&
+           left.to == right.to;
+}
+
+// Return the column of the specified `byte` within the specified `output`,
+// giving `byte` a column of its own if it doesn't already have one.
+int column(Automaton& output, char byte) {
+    unsigned char& result = output.classes[static_cast<unsigned char>(byte)];
+    if (result == 0) {
+        result = output.columns++;
+    }
+    return result;
+}
+
+// Load into the specified `nfa` an automaton that accepts exactly the terms
+// of the expansion of the specified parse tree `root`, and load into the
+// specified `output` the columns of the bytes that appear in `root`.  Return
+// zero on success, or a nonzero value if the automaton would have more than
+// `MAX_AUTOMATON_STATES` states.
+//
+// Each node of the tree is given a pair of states, `in` and `out`, and
+// accepts its terms on the way from `in` to `out`.  A string is a chain of
+// new states from `in` to `out`.  A sequence puts a new state between each
+// pair of adjacent children.  An alternation gives each of its children its
+// own `in` and `out`.  A range is a chain for each of its values, where each
+// chain shares with the previous one the states of the bytes that
+// `Range::increment` left unchanged.  Since no term is empty, no epsilon
+// transitions are needed.  The tree is walked with an explicit stack, so that
+// its depth is limited only by memory.
+int buildNfa(Nfa& nfa, Automaton& output, const ParseTreeNode& root) {
+    struct Task {
+        const ParseTreeNode* node;
+        int                  in;
+        int                  out;
+    };
+
+    std::fill(output.classes, output.classes + 256, 0);
+    output.columns = 1;
+
+    nfa.states = 2;
+    nfa.edges.clear();
+
+    std::vector<Task> tasks(1, Task{&root, 0, 1});
+    while (!tasks.empty()) {
+        const Task           task = tasks.back();
+        const ParseTreeNode& node = *task.node;
+        tasks.pop_back();
+
+        switch (node.type) {
+            case ParseTreeNode::Type::STRING: {
+                const char* const text = node.sourceBegin();
+                int               from = task.in;
+                for (int i = 0; i < node.byteLength; ++i) {
+                    const int to =
+                        i + 1 == node.byteLength ? task.out : nfa.states++;
+                    nfa.edges.push_back(
+                        Nfa::Edge{from, column(output, text[i]), to});
+                    from = to;
+                }
+                break;
+            }
+            case ParseTreeNode::Type::RANGE: {
+                // `path[i]` is the state after the first `i` bytes of the
+                // current value, except for the last byte, whose edge leads
+                // to `out`.
+                const Range&      range  = *node.range;
+                const int         values = range.count();
+                std::vector<char> text(range.maxLength());
+                std::vector<int>  path(1, task.in);
+                int               length = range.format(text.data(), 0);
+                int               shared = 0;
+
+                for (int index = 0;;) {
+                    path.resize(shared + 1);
+                    for (int i = shared; i < length; ++i) {
+                        const int to =
+                            i + 1 == length ? task.out : nfa.states++;
+                        nfa.edges.push_back(
+                            Nfa::Edge{path[i], column(output, text[i]), to});
+                        path.push_back(to);
+                    }
+
+                    if (nfa.states > MAX_AUTOMATON_STATES) {
+                        return 1;
+                    }
+                    if (++index == values) {
+                        break;
+                    }
+
+                    const int changed =
+                        range.increment(text.data(), length, index);
+                    shared = std::min(changed, length - 1);
+                }
+                break;
+            }
+            case ParseTreeNode::Type::SEQUENCE: {
+                int from = task.in;
+                for (int i = 0; i < node.childCount; ++i) {
+                    const int to =
+                        i + 1 == node.childCount ? task.out : nfa.states++;
+                    tasks.push_back(Task{&node.children[i], from, to});
+                    from = to;
+                }
+                break;
+            }
+            default:
+                assert(node.type == ParseTreeNode::Type::ALTERNATION);
+                for (int i = 0; i < node.childCount; ++i) {
+                    const ParseTreeNode& option = node.children[i];
+                    tasks.push_back(Task{&option, task.in, task.out});
+                }
+        }
+    }
+
+    // Identical options of an alternation produce identical edges.
+    std::sort(nfa.edges.begin(), nfa.edges.end());
+    nfa.edges.erase(std::unique(nfa.edges.begin(), nfa.edges.end()),
+                    nfa.edges.end());
+
+    nfa.first.assign(nfa.states + 1, 0);
+    for (const Nfa::Edge& edge : nfa.edges) {
+        ++nfa.first[edge.from + 1];
+    }
+    for (int state = 0; state < nfa.states; ++state) {
+        nfa.first[state + 1] += nfa.first[state];
+    }
+
+    return 0;
+}
+
+// `Determinizer` holds the state of the second half of a single invocation of
+// `automaton`: the subset construction, which makes a deterministic automaton
+// whose states are sets of states of the `Nfa`, and the minimization of the
+// result.  The two are done together.  The sets are visited depth first, and
+// since the automaton is acyclic, all of the successors of a set are
+// finished before the set itself.  A finished set becomes a row of the
+// transition table, and two sets whose rows are identical are equivalent, so
+// interning the rows yields the minimal automaton directly.
+class Determinizer {
+    // A `Successor` is the set reached from another set on a column.
+    struct Successor {
+        int column;
+        int set;  // index of the set in `sets`
+    };
+
+    // A `Frame` is a set whose successors are being visited.  Its successors
+    // are the elements of `successors` from `mark` onward, since those of
+    // the frames after it are removed when they finish.
+    struct Frame {
+        int set;   // index of the set in `sets`
+        int mark;  // index into `successors` of the set's first successor
+        int next;  // index into `successors` of the next successor to visit
+    };
+
+    const Nfa&                 nfa;
+    Automaton&                 output;
+    std::vector<int>           sets;  // sorted sets of `Nfa` states
+    Interner<std::vector<int>> setInterner;
+    std::vector<int>           rows;  // see `finish`
+    Interner<std::vector<int>> rowInterner;
+    std::vector<int>           minimal;     // state of each set, or -1
+    std::vector<Frame>         frames;      // sets being visited
+    std::vector<Successor>     successors;  // of the sets being visited
+    std::vector<Nfa::Edge>     scratch;
+
+    // Push a frame for the set having the specified `set` index, and append
+    // its successors to `successors` in order of column, interning any new
+    // sets.  Return zero on success or a nonzero value if there
+    // would be more than `MAX_AUTOMATON_STATES` sets.
+    int visit(int set);
+
+    // Intern the row of the set of the last frame, remove the frame and its
+    // successors, and return the set's minimal state.  The successors must
+    // all be finished.  A row has an element
+    // for each column.  Its first element is whether the set is accepting,
+    // and the others are the minimal states of its successors, or zero (the
+    // dead state) where there is no successor.  The dead state's row is
+    // interned before any other, and the minimal state of the row at index
+    // `i` is `i`.
+    int finish();
+
+  public:
+    // Create an object that determinizes the specified `nfa` into the
+    // specified `output`, whose columns are already set.
+    Determinizer(const Nfa& nfa, Automaton& output);
+
+    // Load the transition table and accepting states into `output`.  Return
+    // zero on success or a nonzero value if more than `MAX_AUTOMATON_STATES`
+    // sets would be needed.
+    int run();
+};
+
+Determinizer::Determinizer(const Nfa& nfa, Automaton& output)
+: nfa(nfa)
+, output(output)
+, setInterner(sets)
+, rowInterner(rows) {
+}
+
+int Determinizer::visit(int set) {
+    // Gather the edges leaving every state in the set, by column.
+    scratch.clear();
+    const int offset = setInterner.offset(set);
+    const int length = setInterner.length(set);
+    for (int i = 0; i < length; ++i) {
+        const int state = sets[offset + i];
+        scratch.insert(scratch.end(),
+                       nfa.edges.begin() + nfa.first[state],
+                       nfa.edges.begin() + nfa.first[state + 1]);
+    }
+    for (Nfa::Edge& edge : scratch) {
+        edge.from = 0;  // so that edges are ordered by column, then target
+    }
+    std::sort(scratch.begin(), scratch.end());
+    scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+
+    const int mark = int(successors.size());
+
+    for (std::size_t i = 0; i < scratch.size();) {
+        const int column = scratch[i].column;
+        const int count  = setInterner.size();
+        const int begin  = int(sets.size());
+        for (; i < scratch.size() && scratch[i].column == column; ++i) {
+            sets.push_back(scratch[i].to);
+        }
+
+        const int next = setInterner.intern(int(sets.size()) - begin);
+        if (next == count) {
+            if (count == MAX_AUTOMATON_STATES) {
+                return 1;
+            }
+            minimal.push_back(-1);
+        }
+        successors.push_back(Successor{column, next});
+    }
+
+    frames.push_back(Frame{set, mark, mark});
+    return 0;
+}
+
+int Determinizer::finish() {
+    const Frame frame  = frames.back();
+    const int   offset = setInterner.offset(frame.set);
+    const int   length = setInterner.length(frame.set);
+    const int   row    = int(rows.size());
+
+    rows.resize(row + output.columns, 0);
+    rows[row] = std::binary_search(
+        sets.begin() + offset, sets.begin() + offset + length, 1);
+    for (int i = frame.mark; i < int(successors.size()); ++i) {
+        rows[row + successors[i].column] = minimal[successors[i].set];
+    }
+
+    successors.resize(frame.mark);
+    frames.pop_back();
+    return rowInterner.intern(output.columns);
+}
+
+int Determinizer::run() {
+    rows.assign(output.columns, 0);
+    rowInterner.intern(output.columns);  // the dead state
+
+    sets.push_back(0);
+    setInterner.intern(1);
+    minimal.push_back(-1);
+    if (visit(0)) {
+        return 1;
+    }
+
+    for (;;) {
+        Frame& frame = frames.back();
+
+        if (frame.next < int(successors.size())) {
+            const int set = successors[frame.next++].set;
+            if (minimal[set] == -1 && visit(set)) {
+                return 1;
+            }
+            continue;
+        }
+
+        const int set   = frame.set;
+        const int state = finish();
+        minimal[set]    = state;
+        if (frames.empty()) {
+            output.start = state;
+            break;
+        }
+    }
+
+    // The rows are the transition table, except that their first elements
+    // are whether each state is accepting, where the table has transitions
+    // to the dead state.
+    const int columns = output.columns;
+    const int states  = rowInterner.size();
+
+    output.accepting.resize(states);
+    for (int state = 0; state < states; ++state) {
+        output.accepting[state] = char(rows[std::size_t(state) * columns]);
+        rows[std::size_t(state) * columns] = 0;
+    }
+    output.transitions.swap(rows);
+
+    return 0;
+}
+
+}  // namespace
+
+int automaton(Automaton& output, const ParseTreeNode& root) {
+    Nfa nfa;
+    if (buildNfa(nfa, output, root)) {
+        return 1;
+    }
+    return Determinizer(nfa, output).run();
+}
+
+void printMatches(Sink&            sink,
+                  const Automaton& automaton,
+                  std::istream&    input) {
+    std::string line;
+    while (std::getline(input, line)) {
+        if (automaton.accepts(line.data(), line.size())) {
+            sink.write(line);
+            sink.write("\n", 1);
+        }
+
+        if (input.rdbuf()->in_avail() <= 0) {
+            sink.flush();
+        }
+
+        if (sink.error()) {
+            return;
+        }
+    }
+}
+
+}  // namespace brex
@@ -0,0 +1,82 @@
+#ifndef INCLUDED_BREX_MATCH
+#define INCLUDED_BREX_MATCH
+
+#include <cstddef>  // size_t
+#include <iosfwd>   // istream&
+#include <vector>
+
+namespace brex {
+
+struct ParseTreeNode;
+class Sink;
+
+// `Automaton` is a minimal deterministic finite automaton that accepts exactly
+// the terms of the expansion of a parse tree.  It answers whether a string is
+// one of the terms in time proportional to the length of the string,
+// however many terms there are.
+//
+// Bytes are mapped to columns of the transition table by `classes`.  Each
+// byte that occurs in the expression has a column of its own, and every
+// other byte maps to column zero, whose transitions all lead to the dead
+// state.  State zero is the dead state: it is not accepting, and all of its
+// transitions lead back to it.
+struct Automaton {
+    unsigned char     classes[256];  // column of each byte
+    int               columns;       // how many columns the table has
+    int               start;         // the initial state
+    std::vector<int>  transitions;   // `columns` next states per state
+    std::vector<char> accepting;     // whether each state is accepting
+
+    // Return whether the specified `size` bytes at the specified `data` are
+    // accepted by this automaton.
+    bool accepts(const char* data, std::size_t size) const;
+
+    // Return the number of states of this automaton, including the dead
+    // state.
+    int states() const;
+};
+
+// `MAX_AUTOMATON_STATES` is the greatest number of states that `automaton`
+// will create before minimization.  A finite language can require a
+// deterministic automaton exponentially larger than the expression, e.g. when
+// many options of an alternation begin the same way and the alternation is
+// followed by another.  This bounds the memory and time spent on such
+// expressions.
+const int MAX_AUTOMATON_STATES = 1 << 24;
+
+// Load into the specified `output` the minimal `Automaton` that accepts
+// exactly the terms of the expansion of the specified parse tree `root`.
+// Return zero on success, or a nonzero value if doing so would require more
+// than `MAX_AUTOMATON_STATES` states, in which case `output` is unspecified.
+int automaton(Automaton& output, const ParseTreeNode& root);
+
+// Read lines from the specified `input` until the end of `input`, and append
+// to the specified `sink` each line that the specified `automaton` accepts,
+// followed by a newline.  Stop early if writing to `sink` fails.  The output
+// is flushed whenever `input` has no more buffered characters, so that a
+// program that writes one line and then waits for the answer does not wait
+// forever.
+void printMatches(Sink& sink, const Automaton& automaton, std::istream& input);
+
+// inline definitions
+// ------------------
+
+inline bool Automaton::accepts(const char* data, std::size_t size) const {
+    const int* const table = transitions.data();
+    int              state = start;
+
+    for (std::size_t i = 0; i < size && state; ++i) {
+        state = table[state * columns +
+                      classes[static_cast<unsigned char>(data[i])]];
+    }
+
+    return accepting[state];
+}
+
+inline int Automaton::states() const {
+    return int(accepting.size());
+}
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,191 @@
+#include <brex/compile.h>
+#include <brex/odometer.h>
+#include <brex/range.h>
+#include <brex/rank.h>
+#include <brex/sink.h>
+
+#include <cassert>
+#include <ostream>
+
+namespace brex {
+
+// class Odometer
+// --------------
+
+void Odometer::descend(int pc, int parent, const int* positions) {
+    const auto&       instructions = program->instructions;
+    const char* const literals     = program->literals.data();
+
+    for (;;) {
+        assert(pc >= 0);
+        assert(pc < int(instructions.size()));
+
+        const Program::Instruction& instruction = instructions[pc];
+
+        switch (instruction.opcode) {
+            case Program::Opcode::LITERAL:
+                value.append(literals + instruction.first, instruction.count);
+                ++pc;
+                break;
+            case Program::Opcode::SLOT: {
+                Wheel wheel;
+                wheel.instruction = pc;
+                wheel.digit       = positions ? *positions++ : 0;
+                wheel.resume      = pc + 1;
+                wheel.parent      = parent;
+                wheel.offset      = value.size();
+                wheel.length      = 0;
+
+                assert(wheel.digit >= 0);
+                assert(wheel.digit < instruction.count);
+
+                parent = wheels.size();
+                wheels.push_back(wheel);
+                pc = program->branches[instruction.first + wheel.digit];
+            } break;
+            case Program::Opcode::RANGE: {
+                // A range's wheel is never a parent, since a range has no
+                // branches.  Its text is formatted into room at the end of
+                // `value` for the range's longest text.
+                const Range& range = program->ranges[instruction.first];
+
+                Wheel wheel;
+                wheel.instruction = pc;
+                wheel.digit       = positions ? *positions++ : 0;
+                wheel.resume      = pc + 1;
+                wheel.parent      = parent;
+                wheel.offset      = value.size();
+
+                assert(wheel.digit >= 0);
+                assert(wheel.digit < instruction.count);
+
+                value.resize(wheel.offset + range.maxLength());
+                wheel.length = range.format(&value[wheel.offset], wheel.digit);
+                value.resize(wheel.offset + wheel.length);
+
+                wheels.push_back(wheel);
+                ++pc;
+            } break;
+            default:
+                assert(instruction.opcode == Program::Opcode::RETURN);
+                if (parent == -1) {
+                    return;  // end of the root chain
+                }
+                pc     = wheels[parent].resume;
+                parent = wheels[parent].parent;
+        }
+    }
+}
+
+Odometer::Odometer(const Program& program)
+: program(&program)
+, stable(0) {
+    descend(program.root, -1);
+}
+
+void Odometer::reset() {
+    stable = 0;
+    value.clear();
+    wheels.clear();
+    descend(program->root, -1);
+}
+
+AdvanceResult Odometer::advance() {
+    const auto& instructions = program->instructions;
+
+    for (int i = int(wheels.size()) - 1; i >= 0; --i) {
+        Wheel&                      wheel = wheels[i];
+        const Program::Instruction& slot  = instructions[wheel.instruction];
+
+        if (++wheel.digit == slot.count) {
+            continue;  // This wheel rolled over, so turn the one before it.
+        }
+
+        // This wheel turned without rolling over.  Every wheel after it
+        // rolled over, and so is either in its initial position or no longer
+        // passed through.  Everything before it is unchanged.
+        wheels.resize(i + 1);
+
+        if (slot.opcode == Program::Opcode::SLOT) {
+            // Rewrite the value from this wheel onward.
+            stable = wheel.offset;
+            value.resize(stable);
+            descend(program->branches[slot.first + wheel.digit], i);
+            return AdvanceResult::NO_CARRY;
+        }
+
+        // Increment the range's text in place, and rewrite the value from
+        // the end of the range onward.
+        const Range& range = program->ranges[slot.first];
+        value.resize(wheel.offset + range.maxLength());
+        const int changed =
+            range.increment(&value[wheel.offset], wheel.length, wheel.digit);
+        stable = wheel.offset + changed;
+        value.resize(wheel.offset + wheel.length);
+        descend(wheel.resume, wheel.parent);
+        return AdvanceResult::NO_CARRY;
+    }
+
+    // Every wheel rolled over.
+    reset();
+    return AdvanceResult::CARRY;
+}
+
+void Odometer::seek(const Ranking& ranking, const BigUnsigned& index) {
+    ranking.unrank(digits, index);
+
+    stable = 0;
+    value.clear();
+    wheels.clear();
+    descend(program->root, -1, digits.data());
+    assert(wheels.size() == digits.size());
+}
+
+void Odometer::printCurrent(std::ostream& stream) const {
+    stream << value;
+}
+
+const std::string& Odometer::current() const {
+    return value;
+}
+
+int Odometer::stableLength() const {
+    return stable;
+}
+
+// free functions
+// --------------
+
+void expand(std::ostream&      stream,
+            Odometer&          odometer,
+            const std::string& separator,
+            std::uint64_t      limit) {
+    if (limit == 0) {
+        return;
+    }
+
+    odometer.printCurrent(stream);
+
+    while (--limit && odometer.advance() == AdvanceResult::NO_CARRY) {
+        stream << separator;
+        odometer.printCurrent(stream);
+    }
+}
+
+void expand(Sink&              sink,
+            Odometer&          odometer,
+            const std::string& separator,
+            std::uint64_t      limit) {
+    if (limit == 0) {
+        return;
+    }
+
+    sink.write(odometer.current());
+
+    while (--limit && odometer.advance() == AdvanceResult::NO_CARRY) {
+        sink.write(separator);
+        sink.write(odometer.current());
+    }
+}
+
+}  // namespace brex
@@ -0,0 +1,125 @@
+#ifndef INCLUDED_BREX_ODOMETER
+#define INCLUDED_BREX_ODOMETER
+
+#include <brex/expand.h>  // AdvanceResult
+
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // ostream&
+#include <string>
+#include <vector>
+
+namespace brex {
+
+class BigUnsigned;
+struct Program;
+class Ranking;
+class Sink;
+
+// `Odometer` is a non-virtual alternative to the `Expander` tree.  It iterates
+// over the values of a compiled `Program` (see `compile.h`) the way a car's
+// odometer counts: the least significant wheel turns on every advance, and
+// the next wheel over turns only when its neighbor rolls over.
+//
+// Each wheel is a `SLOT` or `RANGE` instruction that the current value passes
+// through.  Since choosing a different branch of a slot can change which
+// slots follow it, the wheels that come after a wheel that turned are
+// recomputed, and are all in their initial position.  Slots that the current
+// value does not pass through have no wheel, and so are always in their
+// initial position.
+//
+// The current value is kept in a buffer.  Each wheel remembers how much of
+// the buffer precedes it, so when a wheel turns, everything before it is
+// kept and only the suffix from that point onward is rewritten.  The work
+// per advance is thus proportional to how much of the value changed, not to
+// the length of the value.  A range's text is not rewritten at all when its
+// wheel turns: its digits are incremented in place (see
+// `Range::increment`).
+class Odometer {
+    struct Wheel {
+        int instruction;  // index of the `SLOT` or `RANGE` instruction
+        int digit;        // which branch of the slot, or value of the range,
+                          // is selected
+        int resume;       // index of the instruction that follows the slot
+        int parent;       // index of the wheel whose branch this is in, or -1
+        int offset;       // length of the value that precedes the slot
+        int length;       // `RANGE`: length of the range's text
+    };
+
+    const Program*     program;
+    std::vector<Wheel> wheels;
+    std::string        value;
+    int                stable;  // see `stableLength()`
+    std::vector<int>   digits;  // scratch space for `seek`
+
+    // Starting at the specified instruction index `pc` within a branch of the
+    // wheel at the specified index `parent`, walk the remainder of the
+    // current value, appending the literals and range values passed through
+    // to `value` and appending a wheel for each slot and range passed
+    // through.  If `parent` is -1, then `pc` is within the root chain.  Each
+    // appended wheel is in its initial position unless the optionally
+    // specified `positions` is not null, in which case successive wheels take
+    // successive elements of `positions`.
+    void descend(int pc, int parent, const int* positions = nullptr);
+
+  public:
+    // Create an object that iterates over the values of the specified
+    // `program`, starting at the first.  The behavior is undefined unless
+    // `program` outlives this object.
+    explicit Odometer(const Program& program);
+
+    // Set this object to the first value of its program.  Note that the
+    // program might have been modified (e.g. compiled anew) since this object
+    // was created, in which case this object iterates over the values of the
+    // modified program.  The storage of this object is reused.
+    void reset();
+
+    // Increment this object to its next value. Return `AdvanceResult::CARRY`
+    // if this object has "rolled over" to its initial value. Return
+    // `AdvanceResult::NO_CARRY` otherwise.
+    AdvanceResult advance();
+
+    // Set this object to the value at the specified zero-based `index` within
+    // the expansion, using the specified `ranking` of this object's program.
+    // The behavior is undefined unless `index` is less than
+    // `ranking.terms()`, and unless `ranking` was created from the same
+    // program as was this object.  This operation takes time proportional to
+    // the number of slots that the value passes through, not to `index`.
+    void seek(const Ranking& ranking, const BigUnsigned& index);
+
+    // Insert into the specified `stream` the current value of this object.
+    void printCurrent(std::ostream& stream) const;
+
+    // Return a reference providing non-modifiable access to the current value
+    // of this object.  The reference remains valid for the lifetime of this
+    // object, but the value to which it refers changes with each advance.
+    const std::string& current() const;
+
+    // Return the length of the longest prefix of the current value that the
+    // most recent call to `advance()` did not rewrite.  Return zero if there
+    // has been no such call, or if the call returned `AdvanceResult::CARRY`.
+    // Note that the rewritten suffix might nonetheless happen to begin with
+    // the same characters as before.
+    int stableLength() const;
+};
+
+// Insert into the specified `stream` the values produced by the specified
+// `odometer`, starting with its current value, where each inserted value is
+// separated from the next by the specified `separator`.  Stop after the last
+// value, or after the optionally specified `limit` number of values.
+void expand(std::ostream&      stream,
+            Odometer&          odometer,
+            const std::string& separator,
+            std::uint64_t      limit = std::uint64_t(-1));
+
+// Append to the specified `sink` the values produced by the specified
+// `odometer`, starting with its current value, where each appended value is
+// separated from the next by the specified `separator`.  Stop after the last
+// value, or after the optionally specified `limit` number of values.
+void expand(Sink&              sink,
+            Odometer&          odometer,
+            const std::string& separator,
+            std::uint64_t      limit = std::uint64_t(-1));
+
+}  // namespace brex
+
+#endif
@@ -1,9 +1,60 @@
 #include <brex/options.h>
 
 #include <cassert>
+#include <cstdint>
+#include <limits>
 #include <ostream>  // operator<<
+#include <string>
 
 namespace brex {
+namespace {
+
+// Load into the specified `output` the non-negative integer represented in
+// decimal by the specified `text`.  Return zero on success or a nonzero value
+// if `text` is not such a representation, or if the integer is not
+// representable as a `std::uint64_t`.  If an error occurs, `output` is not
+// modified.
+int parseUnsigned(std::uint64_t& output, const char* text) {
+    const std::uint64_t max    = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t       result = 0;
+
+    if (*text == '\0') {
+        return 1;
+    }
+
+    for (; *text; ++text) {
+        if (*text < '0' || *text > '9') {
+            return 1;
+        }
+
+        const std::uint64_t digit = *text - '0';
+        if (result > (max - digit) / 10) {
+            return 1;  // overflow
+        }
+        result = result * 10 + digit;
+    }
+
+    output = result;
+    return 0;
+}
+
+// Load into the specified `output` the positive integer represented in
+// decimal by the specified `text`.  Return zero on success or a nonzero value
+// if `text` is not such a representation, or if the integer is not
+// representable as a `std::size_t`.  If an error occurs, `output` is not
+// modified.
+int parsePositive(std::size_t& output, const char* text) {
+    std::uint64_t result;
+    if (parseUnsigned(result, text) || result == 0 ||
+        result > std::numeric_limits<std::size_t>::max()) {
+        return 1;
+    }
+
+    output = result;
+    return 0;
+}
+
+}  // namespace
 
 int parseCommandLine(Options&           output,
                      const char* const* argv,
@@ -11,6 +62,7 @@ int parseCommandLine(Options&           output,
     assert(argv);
 
     Options options;
+    bool    offset = false;  // whether `--offset` was specified
 
     for (++argv; *argv; ++argv) {
         const std::string arg(*argv);
@@ -28,12 +80,327 @@ int parseCommandLine(Options&           output,
         else if (arg == "--lines") {
             options.lines = true;
         }
+        else if (arg == "--tree") {
+            options.tree = true;
+        }
+        else if (arg == "--ostream") {
+            options.ostream = true;
+        }
+        else if (arg == "--count") {
+            options.count = true;
+        }
+        else if (arg == "--batch") {
+            options.batch = true;
+        }
+        else if (arg == "--match") {
+            options.match = true;
+        }
+        else if (arg == "--front-code") {
+            options.frontCode = true;
+        }
+        else if (arg == "--decode") {
+            options.decode = true;
+        }
+        else if (arg == "-0" || arg == "--null") {
+            options.null = true;
+        }
+        else if (arg == "--length-prefixed") {
+            options.lengthPrefixed = true;
+        }
+        else if (arg == "--stats") {
+            options.stats = true;
+        }
+        else if (arg == "--distinct") {
+            options.distinct = true;
+        }
+        else if (arg == "--buffer-size" || arg == "--limit" ||
+                 arg == "--threads" || arg == "--sample" ||
+                 arg == "--cache-size") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            std::size_t& value =
+                arg == "--limit"
+                    ? options.limit
+                    : arg == "--threads"
+                          ? options.threads
+                          : arg == "--sample"
+                                ? options.sample
+                                : arg == "--cache-size" ? options.cacheSize
+                                                        : options.bufferSize;
+            if (parsePositive(value, *++argv) ||
+                (arg == "--threads" && value > MAX_THREADS)) {
+                errors << "Invalid value for command line option " << arg
+                       << ": " << *argv << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--prefix" || arg == "--glob") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            options.pattern = *++argv;
+            if (arg == "--prefix") {
+                options.prefix = true;
+            }
+            else {
+                options.glob = true;
+            }
+        }
+        else if (arg == "--serve") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            options.socketPath = *++argv;
+            options.serve      = true;
+        }
+        else if (arg == "--input" || arg == "--output") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            if (arg == "--input") {
+                options.inputPath = *++argv;
+                options.input     = true;
+            }
+            else {
+                options.outputPath = *++argv;
+                options.output     = true;
+            }
+        }
+        else if (arg == "--compile" || arg == "--load") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            options.imagePath = *++argv;
+            if (arg == "--compile") {
+                options.compile = true;
+            }
+            else {
+                options.load = true;
+            }
+        }
+        else if (arg == "--seed") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            if (parseUnsigned(options.seed, *++argv)) {
+                errors << "Invalid value for command line option " << arg
+                       << ": " << *argv << "\n";
+                return 1;
+            }
+            options.seeded = true;
+        }
+        else if (arg == "--offset" || arg == "--nth") {
+            if (argv[1] == nullptr) {
+                errors << "Missing value for command line option: " << arg
+                       << "\n";
+                return 1;
+            }
+            if (BigUnsigned::fromDecimal(options.offset, *++argv)) {
+                errors << "Invalid value for command line option " << arg
+                       << ": " << *argv << "\n";
+                return 1;
+            }
+            if (arg == "--nth") {
+                options.nth = true;
+            }
+            else {
+                offset = true;
+            }
+        }
         else {
             errors << "Unknown command line option: " << arg << "\n";
             return 1;
         }
     }
 
+    // `--nth` is shorthand for an offset and a limit of one, so it's
+    // refused alongside either, rather than letting the order of the
+    // options decide which one wins.
+    if (options.nth && (offset || options.limit)) {
+        errors << "The --nth option cannot be used with --offset or "
+                  "--limit.\n";
+        return 1;
+    }
+    if (options.nth) {
+        options.limit = 1;
+    }
+
+    if (options.tree && (options.nth || !options.offset.isZero())) {
+        errors << "The --offset and --nth options cannot be used with "
+                  "--tree.\n";
+        return 1;
+    }
+
+    if (options.threads > 1 && (options.tree || options.ostream)) {
+        errors << "The --threads option cannot be used with --tree or "
+                  "--ostream.\n";
+        return 1;
+    }
+
+    if (options.batch &&
+        (options.parse || options.count || options.nth ||
+         !options.offset.isZero() || options.threads > 1 || options.tree ||
+         options.ostream)) {
+        errors << "The --batch option cannot be used with --parse, --count, "
+                  "--nth, --offset, --threads, --tree, or --ostream.\n";
+        return 1;
+    }
+
+    if (options.match &&
+        (options.parse || options.count || options.nth ||
+         !options.offset.isZero() || options.limit || options.batch ||
+         options.threads > 1 || options.tree || options.ostream)) {
+        errors << "The --match option cannot be used with --parse, --count, "
+                  "--nth, --offset, --limit, --batch, --threads, --tree, or "
+                  "--ostream.\n";
+        return 1;
+    }
+
+    if (options.frontCode &&
+        (options.parse || options.count || options.batch || options.match ||
+         options.threads > 1 || options.tree || options.ostream)) {
+        errors << "The --front-code option cannot be used with --parse, "
+                  "--count, --batch, --match, --threads, --tree, or "
+                  "--ostream.\n";
+        return 1;
+    }
+
+    if (options.decode &&
+        (options.parse || options.count || options.nth ||
+         !options.offset.isZero() || options.limit || options.batch ||
+         options.match || options.frontCode || options.threads > 1 ||
+         options.tree || options.ostream)) {
+        errors << "The --decode option can be used only with --lines, "
+                  "--verbose, and --buffer-size.\n";
+        return 1;
+    }
+
+    if ((options.prefix || options.glob) &&
+        (options.prefix == options.glob || options.parse || options.count ||
+         options.nth || !options.offset.isZero() || options.batch ||
+         options.match || options.frontCode || options.decode ||
+         options.threads > 1 || options.tree || options.ostream)) {
+        errors << "The --prefix and --glob options cannot be used together, "
+                  "or with --parse, --count, --nth, --offset, --batch, "
+                  "--match, --front-code, --decode, --threads, --tree, or "
+                  "--ostream.\n";
+        return 1;
+    }
+
+    if (options.sample &&
+        (options.parse || options.count || options.nth ||
+         !options.offset.isZero() || options.limit || options.batch ||
+         options.match || options.frontCode || options.decode ||
+         options.prefix || options.glob || options.threads > 1 ||
+         options.tree || options.ostream)) {
+        errors << "The --sample option cannot be used with --parse, --count, "
+                  "--nth, --offset, --limit, --batch, --match, --front-code, "
+                  "--decode, --prefix, --glob, --threads, --tree, or "
+                  "--ostream.\n";
+        return 1;
+    }
+
+    if (!options.sample && (options.distinct || options.seeded)) {
+        errors << "The --distinct and --seed options can be used only with "
+                  "--sample.\n";
+        return 1;
+    }
+
+    if (options.stats && (options.parse || options.count || options.batch ||
+                          options.match || options.decode)) {
+        errors << "The --stats option cannot be used with --parse, --count, "
+                  "--batch, --match, or --decode.\n";
+        return 1;
+    }
+
+    if (options.null &&
+        (options.parse || options.count || options.batch || options.match ||
+         options.frontCode || options.decode || options.lines)) {
+        errors << "The -0 option cannot be used with --parse, --count, "
+                  "--batch, --match, --front-code, --decode, or --lines.\n";
+        return 1;
+    }
+
+    if (options.lengthPrefixed &&
+        (options.parse || options.count || options.batch || options.match ||
+         options.frontCode || options.decode || options.prefix ||
+         options.glob || options.sample || options.threads > 1 ||
+         options.tree || options.ostream || options.lines || options.null)) {
+        errors << "The --length-prefixed option cannot be used with --parse, "
+                  "--count, --batch, --match, --front-code, --decode, "
+                  "--prefix, --glob, --sample, --threads, --tree, "
+                  "--ostream, --lines, or -0.\n";
+        return 1;
+    }
+
+    if (options.serve &&
+        (options.parse || options.lines || options.tree || options.ostream ||
+         options.count || options.nth || !options.offset.isZero() ||
+         options.batch || options.match || options.frontCode ||
+         options.decode || options.prefix || options.glob || options.sample ||
+         options.stats || options.null || options.lengthPrefixed)) {
+        errors << "The --serve option can be used only with --verbose, "
+                  "--limit, --threads, --cache-size, and --buffer-size.\n";
+        return 1;
+    }
+
+    if (options.cacheSize && !options.serve) {
+        errors << "The --cache-size option can be used only with --serve.\n";
+        return 1;
+    }
+
+    if (options.compile &&
+        (options.load || options.parse || options.lines || options.tree ||
+         options.ostream || options.count || options.nth ||
+         !options.offset.isZero() || options.limit || options.batch ||
+         options.match || options.frontCode || options.decode ||
+         options.prefix || options.glob || options.sample || options.stats ||
+         options.null || options.lengthPrefixed || options.serve ||
+         options.threads || options.bufferSize)) {
+        errors << "The --compile option can be used only with --verbose.\n";
+        return 1;
+    }
+
+    if (options.load &&
+        (options.parse || options.tree || options.batch || options.match ||
+         options.decode || options.stats || options.serve)) {
+        errors << "The --load option cannot be used with --parse, --tree, "
+                  "--batch, --match, --decode, --stats, or --serve.\n";
+        return 1;
+    }
+
+    if (options.output &&
+        (options.parse || options.tree || options.ostream || options.count ||
+         options.nth || !options.offset.isZero() || options.limit ||
+         options.batch || options.match || options.frontCode ||
+         options.decode || options.prefix || options.glob || options.sample ||
+         options.lengthPrefixed || options.serve || options.compile ||
+         options.bufferSize)) {
+        errors << "The --output option can be used only with --verbose, "
+                  "--lines, -0, --threads, --stats, and --load.\n";
+        return 1;
+    }
+
+    if (options.input && (options.batch || options.match || options.decode ||
+                          options.serve || options.load)) {
+        errors << "The --input option cannot be used with --batch, --match, "
+                  "--decode, --serve, or --load.\n";
+        return 1;
+    }
+
     output = options;
     return 0;
 }
@@ -62,6 +429,201 @@ Options:
 --lines      Delimit expansion terms using a line feed
              instead of a space.
 
+-0, --null   Terminate each expansion term, including the last,
+             with a null byte, rather than delimiting terms
+             with spaces or line feeds, as `xargs -0` expects.
+             Cannot be used with --parse, --count, --batch,
+             --match, --front-code, --decode, or --lines.
+
+--length-prefixed
+             Print each expansion term as a binary record: the
+             length of the term in bytes as a LEB128 varint
+             (seven bits per byte, least significant first,
+             with the high bit set on every byte but the
+             last), followed by the term.  Nothing separates
+             or follows the records.  Cannot be used with
+             --parse, --count, --batch, --match, --front-code,
+             --decode, --prefix, --glob, --sample, --threads,
+             --tree, --ostream, --lines, or -0.
+
+--count      Rather than printing the brace expression's
+             expansion, instead print as JSON to standard
+             output the number of terms in the expansion and
+             the number of bytes that printing it would write.
+             The expansion is not performed.
+
+--nth INDEX  Print only the term at the zero-based INDEX
+             within the expansion.  Fail if the expansion does
+             not have that many terms.  The term is found
+             directly, without expanding the terms before it.
+             Cannot be used with --offset or --limit.
+
+--offset INDEX
+             Begin printing at the term at the zero-based
+             INDEX within the expansion, which is found
+             directly, without expanding the terms before it.
+
+--limit COUNT
+             Print at most COUNT terms.
+
+--batch      Read any number of brace expressions, one per
+             line, and print a record for each: a line with
+             the status that brex would exit with for that
+             expression alone, then each term of its expansion
+             on a line of its own, then an empty line.  Keep
+             going after invalid expressions.  Cannot be used
+             with --parse, --count, --nth, --offset, --threads,
+             --tree, or --ostream.
+
+--match      Rather than printing the brace expression's
+             expansion, read lines after the expression and
+             print each line that is a term of the expansion.
+             Each line is checked in time proportional to its
+             length, without expanding the expression.  Cannot
+             be used with --parse, --count, --nth, --offset,
+             --limit, --batch, --threads, --tree, or --ostream.
+
+--front-code
+             Print the expansion in a compact binary format
+             rather than as text.  Each term is encoded as the
+             number of leading bytes that it shares with the
+             previous term, the number of bytes that follow,
+             and those bytes, where the numbers are LEB128
+             varints.  Cannot be used with --parse, --count,
+             --batch, --match, --threads, --tree, or --ostream.
+
+--decode     Rather than reading a brace expression, read the
+             output of --front-code, and print the terms that
+             it encodes as brex would have printed them.  Can
+             be used only with --lines, --verbose, and
+             --buffer-size.
+
+--prefix STRING
+             Print only the terms of the expansion that begin
+             with STRING.  Terms are skipped in groups: as soon
+             as the beginning of a term can't match, every
+             term that begins the same way is skipped without
+             being expanded.  With --limit, print at most COUNT
+             matching terms.  Print nothing if no term matches.
+             Cannot be used with --glob, --parse, --count,
+             --nth, --offset, --batch, --match, --front-code,
+             --decode, --threads, --tree, or --ostream.
+
+--glob PATTERN
+             Like --prefix, but print only the terms that match
+             the shell glob PATTERN, where * matches any bytes,
+             ? matches any byte, [...] matches any byte in the
+             brackets (or not in them, if the first is ! or ^),
+             and \ matches the byte after it.  Only the
+             beginning of PATTERN, up to its first *, prunes
+             the expansion; the rest is checked term by term.
+
+--sample COUNT
+             Rather than printing the brace expression's
+             expansion, print COUNT terms drawn from it
+             uniformly at random, in the order drawn.  Each
+             term is found directly, so the time taken depends
+             on COUNT and on the size of the expression, not on
+             the number of terms in the expansion.  Cannot be
+             used with --parse, --count, --nth, --offset,
+             --limit, --batch, --match, --front-code, --decode,
+             --prefix, --glob, --threads, --tree, or --ostream.
+
+--distinct   With --sample, draw terms without replacement, so
+             that no term is printed twice, and print them in
+             the order in which they appear in the expansion.
+             If COUNT is at least the number of terms, then
+             print the whole expansion.
+
+--seed SEED  With --sample, seed the random number generator
+             with the integer SEED, so that the same sample is
+             drawn every time.  By default, the seed is
+             unpredictable.
+
+--stats      Print to standard error, as JSON, statistics about
+             the run: the wall and CPU time spent reading,
+             parsing, building (compiling, or assembling the
+             --tree), and expanding, the number of parse tree
+             nodes of each type, the depth of the tree, the
+             number of terms and bytes written, the memory
+             allocated for the parse tree, and the peak
+             resident set size.  Cannot be used with --parse,
+             --count, --batch, --match, or --decode.
+
+--serve PATH
+             Rather than reading standard input, listen on a
+             Unix domain socket created at PATH, and answer
+             any number of clients at once until terminated.
+             A client writes brace expressions, one per line,
+             and reads back a record for each, as with
+             --batch.  Recently seen expressions are not parsed
+             or compiled again.  With --threads, serve using
+             COUNT threads; the default is one per processor.
+             With --limit, print at most COUNT terms per
+             expression.  With --buffer-size, buffer up to
+             BYTES bytes of output per client; the default is
+             65536.  Can be used only with --verbose, --limit,
+             --threads, --cache-size, and --buffer-size.
+
+--cache-size COUNT
+             With --serve, keep up to COUNT compiled
+             expressions, evicting the least recently used.
+             The default is 4096.
+
+--compile FILE
+             Rather than printing the brace expression's
+             expansion, write the compiled expression to FILE
+             as a binary image, which --load reads.  Can be
+             used only with --verbose.
+
+--load FILE  Rather than reading a brace expression from
+             standard input, read the image that --compile
+             wrote to FILE, and expand it without parsing or
+             compiling again.  The output is the same.  Fails
+             if FILE is damaged, or was written by a version
+             of brex that compiles differently.  Cannot be
+             used with --parse, --tree, --batch, --match,
+             --decode, --stats, or --serve.
+
+--input FILE
+             Read the brace expression from FILE rather than
+             from standard input.  FILE is mapped into memory
+             and parsed in place, rather than copied, which
+             saves time and memory for large expressions.
+             Cannot be used with --batch, --match, --decode,
+             --serve, or --load.
+
+--output FILE
+             Write the expansion to FILE rather than to
+             standard output.  The size of the output is
+             computed first, and FILE is allocated at that size
+             and written in place through a memory mapping.
+             With --threads, each thread writes its own parts
+             of FILE.  Can be used only with --verbose,
+             --lines, -0, --threads, --stats, and --load.
+
+--threads COUNT
+             Expand using COUNT threads, at most 1024.  The
+             output is the same.  Cannot be used with --tree
+             or --ostream.
+
+--tree       Expand using the original tree of virtual
+             expander objects rather than the compiled
+             engine.  The output is the same.  This option
+             exists for comparison.  Implies --ostream.
+             Fails if the expression is nested more than a
+             few thousand levels deep.
+
+--ostream    Write output through the C++ standard library's
+             std::cout rather than directly to the standard
+             output file descriptor.  The output is the same.
+             This option exists for comparison.
+
+--buffer-size BYTES
+             Buffer up to BYTES bytes of output before writing
+             it to standard output.  The default is 1048576.
+             This option has no effect with --ostream.
+
 )";
 }
 
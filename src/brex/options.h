@@ -1,10 +1,20 @@
 #ifndef INCLUDED_BREX_OPTIONS
 #define INCLUDED_BREX_OPTIONS
 
-#include <iosfwd>  // ostream&
+#include <brex/bigunsigned.h>
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // ostream&
+#include <string>
 
 namespace brex {
 
+// `MAX_THREADS` is the greatest number of threads that `--threads` accepts.
+// More would only contend for the processors, and enough more would exhaust
+// the process's memory or its limit on threads.
+const std::size_t MAX_THREADS = 1024;
+
 struct Options {
     bool help;     // Print usage instructions to standard output and exit.
     bool verbose;  // Print error diagnostics to standard error.
@@ -12,12 +22,92 @@ struct Options {
                    // output and exit.
     bool lines;    // Delimit terms of the expansion with a line feed rather
                    // than with a space.
+    bool tree;     // Expand using a tree of `Expander` objects rather than
+                   // using a compiled `Program`.
+    bool ostream;  // Write output using `std::cout` rather than using a
+                   // `Sink`.
+    bool count;    // Print the number of terms in the expansion and the size
+                   // of the output, rather than the expansion itself.
+    bool nth;      // Print only the term at `offset`, and fail if there is no
+                   // such term.
+    bool batch;    // Read one expression per line, and print a record for
+                   // each.
+    bool match;    // Read candidate strings after the expression, one per
+                   // line, and print those that are terms of the expansion.
+    bool frontCode;  // Print the expansion front coded (see `frontcode.h`).
+    bool decode;     // Read a front coded expansion rather than an
+                     // expression, and print the terms that it encodes.
+    bool prefix;     // Print only the terms that begin with `pattern`.
+    bool glob;       // Print only the terms that match the glob `pattern`.
+    bool distinct;   // Sample without replacement.
+    bool seeded;     // Seed the sample's random numbers with `seed` rather
+                     // than with an unpredictable value.
+    bool stats;      // Print statistics about the run to standard error.
+    bool null;       // Terminate each term with a null byte rather than
+                     // delimiting terms with spaces or line feeds.
+    bool lengthPrefixed;  // Print each term preceded by its length (see
+                          // `expandLengthPrefixed` in `frontcode.h`).
+    bool serve;           // Answer requests on the Unix domain socket at
+                          // `socketPath` rather than reading standard input.
+    bool compile;         // Write the compiled expression to the image file
+                          // at `imagePath` rather than expanding it.
+    bool load;            // Read the compiled expression from the image file
+                          // at `imagePath` rather than from standard input.
+    bool input;           // Read the expression from the file at
+                          // `inputPath` rather than from standard input.
+    bool output;          // Write the expansion to the file at `outputPath`
+                          // rather than to standard output.
+
+    std::string pattern;     // the argument of `--prefix` or `--glob`
+    std::string socketPath;  // the argument of `--serve`
+    std::string imagePath;   // the argument of `--compile` or `--load`
+    std::string inputPath;   // the argument of `--input`
+    std::string outputPath;  // the argument of `--output`
+
+    std::size_t   bufferSize;  // capacity of the output `Sink`, or zero for
+                               // the default
+    BigUnsigned   offset;      // zero-based index of the first term to print
+    std::size_t   limit;       // maximum number of terms to print, or zero
+                               // for no limit
+    std::size_t   threads;     // how many threads to use for expansion or
+                               // for serving, or zero for the default
+    std::size_t   sample;      // how many random terms to print, or zero to
+                               // print the expansion
+    std::uint64_t seed;        // see `seeded`
+    std::size_t   cacheSize;   // how many compiled expressions `--serve`
+                               // keeps, or zero for the default
 
     Options()
     : help(false)
     , verbose(false)
     , parse(false)
-    , lines(false) {
+    , lines(false)
+    , tree(false)
+    , ostream(false)
+    , count(false)
+    , nth(false)
+    , batch(false)
+    , match(false)
+    , frontCode(false)
+    , decode(false)
+    , prefix(false)
+    , glob(false)
+    , distinct(false)
+    , seeded(false)
+    , stats(false)
+    , null(false)
+    , lengthPrefixed(false)
+    , serve(false)
+    , compile(false)
+    , load(false)
+    , input(false)
+    , output(false)
+    , bufferSize(0)
+    , limit(0)
+    , threads(0)
+    , sample(0)
+    , seed(0)
+    , cacheSize(0) {
     }
 };
 
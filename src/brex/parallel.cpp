@@ -0,0 +1,224 @@
+#include <brex/bigunsigned.h>
+#include <brex/compile.h>
+#include <brex/odometer.h>
+#include <brex/parallel.h>
+#include <brex/rank.h>
+#include <brex/sink.h>
+
+#include <algorithm>  // min
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace brex {
+namespace {
+
+// `Pipeline` is the state shared between the worker threads and the writing
+// thread in `expandParallel`.  Chunks are numbered from zero.  A chunk is
+// buffered in the slot of `ring` at the chunk's number modulo the size of
+// `ring`, so a worker must not begin a chunk until the writer has finished
+// with the chunk that last used the same slot.
+class Pipeline {
+    struct Slot {
+        std::string text;
+        bool        ready;
+    };
+
+    const Program&     program;
+    const Ranking&     ranking;
+    const std::string& separator;
+    const BigUnsigned& offset;
+    std::uint64_t      terms;       // how many terms to expand in total
+    std::uint64_t      chunkTerms;  // how many terms per chunk
+    std::uint64_t      chunkCount;
+
+    std::mutex              mutex;
+    std::condition_variable produced;  // a chunk became ready
+    std::condition_variable consumed;  // a chunk was written
+    std::vector<Slot>       ring;
+    std::uint64_t           nextClaim;  // next chunk for a worker to claim
+    std::uint64_t           nextWrite;  // next chunk for the writer to write
+    bool                    stopping;
+
+  public:
+    Pipeline(const Program&     program,
+             const Ranking&     ranking,
+             const std::string& separator,
+             const BigUnsigned& offset,
+             std::uint64_t      terms,
+             std::uint64_t      chunkTerms,
+             int                slots);
+
+    // Claim and expand chunks until there are none left or until the writer
+    // stops.  This is the body of each worker thread.
+    void work();
+
+    // Write each chunk to the specified `sink` in order, as each becomes
+    // ready.  Stop early if writing to `sink` fails.
+    void write(Sink& sink);
+};
+
+Pipeline::Pipeline(const Program&     program,
+                   const Ranking&     ranking,
+                   const std::string& separator,
+                   const BigUnsigned& offset,
+                   std::uint64_t      terms,
+                   std::uint64_t      chunkTerms,
+                   int                slots)
+: program(program)
+, ranking(ranking)
+, separator(separator)
+, offset(offset)
+, terms(terms)
+, chunkTerms(chunkTerms)
+, chunkCount(terms / chunkTerms + (terms % chunkTerms != 0))
+, ring(slots)
+, nextClaim(0)
+, nextWrite(0)
+, stopping(false) {
+    for (Slot& slot : ring) {
+        slot.ready = false;
+    }
+}
+
+void Pipeline::work() {
+    Odometer    odometer(program);
+    std::string text;
+
+    for (;;) {
+        std::uint64_t chunk;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (stopping || nextClaim == chunkCount) {
+                return;
+            }
+            chunk = nextClaim++;
+
+            // Wait for this chunk's slot to be free.
+            consumed.wait(lock, [&] {
+                return stopping || chunk < nextWrite + ring.size();
+            });
+            if (stopping) {
+                return;
+            }
+        }
+
+        const std::uint64_t first = chunk * chunkTerms;
+        const std::uint64_t count = std::min(chunkTerms, terms - first);
+
+        text.clear();
+        if (chunk != 0) {
+            text += separator;
+        }
+
+        odometer.seek(ranking, offset + first);
+        text += odometer.current();
+        for (std::uint64_t i = 1; i < count; ++i) {
+            const AdvanceResult result = odometer.advance();
+            assert(result == AdvanceResult::NO_CARRY);
+            (void)result;
+
+            text += separator;
+            text += odometer.current();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Slot&                       slot = ring[chunk % ring.size()];
+            assert(!slot.ready);
+
+            slot.text.swap(text);  // and reuse the slot's old buffer
+            slot.ready = true;
+        }
+        produced.notify_all();
+    }
+}
+
+void Pipeline::write(Sink& sink) {
+    for (std::uint64_t chunk = 0; chunk < chunkCount; ++chunk) {
+        Slot& slot = ring[chunk % ring.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            produced.wait(lock, [&] { return slot.ready; });
+        }
+
+        // No worker touches a ready slot, so it's safe to write it without
+        // holding the lock.
+        sink.write(slot.text);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.ready = false;
+            nextWrite  = chunk + 1;
+            if (sink.error()) {
+                stopping = true;
+            }
+        }
+        consumed.notify_all();
+
+        if (sink.error()) {
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+void expandParallel(Sink&              sink,
+                    const Program&     program,
+                    const Ranking&     ranking,
+                    const std::string& separator,
+                    const BigUnsigned& offset,
+                    std::uint64_t      limit,
+                    int                threads,
+                    std::uint64_t      chunkTerms) {
+    assert(offset < ranking.terms());
+    assert(limit > 0);
+    assert(threads > 0);
+
+    const BigUnsigned   remaining = ranking.terms() - offset;
+    const std::uint64_t terms     = remaining.fitsUint64()
+                                    ? std::min(limit, remaining.toUint64())
+                                    : limit;
+
+    if (chunkTerms == 0) {
+        // Aim for chunks of at most about a megabyte, however long the
+        // terms in any one chunk turn out to be.
+        const std::uint64_t termSize =
+            longestValue(program) + separator.size();
+        chunkTerms = std::max<std::uint64_t>(1, (1 << 20) / termSize);
+    }
+
+    Pipeline pipeline(
+        program, ranking, separator, offset, terms, chunkTerms, 4 * threads);
+
+    // If the system won't start as many workers as were asked for, make do
+    // with those that it did start, or with none.
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+        try {
+            workers.emplace_back(&Pipeline::work, &pipeline);
+        }
+        catch (const std::system_error&) {
+            break;
+        }
+    }
+
+    if (workers.empty()) {
+        Odometer odometer(program);
+        odometer.seek(ranking, offset);
+        expand(sink, odometer, separator, terms);
+        return;
+    }
+
+    pipeline.write(sink);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace brex
@@ -0,0 +1,49 @@
+#ifndef INCLUDED_BREX_PARALLEL
+#define INCLUDED_BREX_PARALLEL
+
+#include <cstdint>  // uint64_t
+#include <string>
+
+namespace brex {
+
+class BigUnsigned;
+struct Program;
+class Ranking;
+class Sink;
+
+// Append to the specified `sink` the values of the specified `program`
+// beginning at the specified zero-based `offset` within the expansion, where
+// each appended value is separated from the next by the specified
+// `separator`.  Stop after the last value, or after the specified `limit`
+// number of values.  Use the specified `threads` number of worker threads,
+// and use the specified `ranking` of `program` to divide the expansion among
+// them.  The output is the same as that of `expand` using an `Odometer`
+// positioned at `offset` (see `odometer.h`).
+//
+// The range of term indices is split into chunks.  Each worker repeatedly
+// claims the next chunk, seeks an `Odometer` of its own to the beginning of
+// the chunk, and expands the chunk into a buffer of its own.  The calling
+// thread writes the buffers to `sink` in order.  At most a few chunks per
+// worker are buffered at any time.  Each chunk has the optionally specified
+// `chunkTerms` number of terms, or if `chunkTerms` is zero, a number of
+// terms chosen so that no chunk is more than about a megabyte, judging by
+// the longest value of `program` (see `longestValue` in `compile.h`).  If
+// fewer workers can be started than `threads`, then those that could be
+// share the work, and if none can, then the calling thread expands on its
+// own.
+//
+// The behavior is undefined unless `offset` is less than `ranking.terms()`,
+// `limit` is positive, `threads` is positive, and `ranking` was created from
+// `program`.
+void expandParallel(Sink&              sink,
+                    const Program&     program,
+                    const Ranking&     ranking,
+                    const std::string& separator,
+                    const BigUnsigned& offset,
+                    std::uint64_t      limit,
+                    int                threads,
+                    std::uint64_t      chunkTerms = 0);
+
+}  // namespace brex
+
+#endif
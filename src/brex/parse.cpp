@@ -1,11 +1,17 @@
+#include <brex/arena.h>
 #include <brex/parse.h>
+#include <brex/range.h>
+#include <brex/scan.h>
 
+#include <algorithm>  // copy, max
 #include <cassert>
-#include <cctype>   // isalpha
 #include <cstddef>  // size_t
+#include <cstdint>  // int64_t
 #include <limits>
 #include <ostream>
 #include <sstream>  // ostringstream
+#include <utility>  // pair
+#include <vector>
 
 namespace brex {
 namespace {
@@ -52,46 +58,95 @@ const char* toJson(ParseTreeNode::Type type) {
             return "\"STRING\"";
         case ParseTreeNode::Type::SEQUENCE:
             return "\"SEQUENCE\"";
-        default:
-            assert(type == ParseTreeNode::Type::ALTERNATION);
+        case ParseTreeNode::Type::ALTERNATION:
             return "\"ALTERNATION\"";
+        default:
+            assert(type == ParseTreeNode::Type::RANGE);
+            return "\"RANGE\"";
     }
 }
 
-}  // namespace
-
-void toJson(std::ostream& stream, const ParseTreeNode& node) {
+// Insert into the specified `stream` the beginning of the JSON representation
+// of the specified `node`: everything before its first child, or all of it if
+// it has no children.
+void openJson(std::ostream& stream, const ParseTreeNode& node) {
     // clang-format off
 
     stream << "{"
                   "\"type\": " << toJson(node.type) << ", "
                   "\"byteOffset\": " << node.byteOffset << ", "
-                  // Note that we don't need to escape quotes in `node.source`,
+                  // Note that we don't need to escape quotes in the source,
                   // because there are none.  Parsing will have failed if any
                   // quotes were encountered, since quotes are not accepted by
                   // the grammar.
-                  "\"source\": \"" << node.source << "\"";
-
-    if (!node.children.empty()) {
-        assert(node.children[0]);
+                  "\"source\": \"";
+    stream.write(node.sourceBegin(), node.byteLength);
+    stream << "\"";
 
+    if (node.childCount != 0) {
         stream << ", \"children\": [";
-        toJson(stream, *node.children[0]);
+    }
+    else {
+        stream << "}";
+    }
 
-        for (int i = 1; i < int(node.children.size()); ++i) {
-            const auto& childPointer = node.children[i];
-            assert(childPointer);
+    // clang-format on
+}
 
-            stream << ", ";
-            toJson(stream, *childPointer);
+}  // namespace
+
+int treeDepth(const ParseTreeNode& root) {
+    // Walk the tree using an explicit stack, so that deeply nested trees don't
+    // overflow the call stack.  Each element is a node and its depth.
+    std::vector<std::pair<const ParseTreeNode*, int>> stack;
+    int                                               result = 0;
+
+    stack.emplace_back(&root, 1);
+    while (!stack.empty()) {
+        const ParseTreeNode& node  = *stack.back().first;
+        const int            depth = stack.back().second;
+        stack.pop_back();
+
+        result = std::max(result, depth);
+        for (int i = 0; i < node.childCount; ++i) {
+            stack.emplace_back(&node.children[i], depth + 1);
         }
+    }
 
-        stream << "]";
+    return result;
+}
+
+void toJson(std::ostream& stream, const ParseTreeNode& node) {
+    // Walk the tree using an explicit stack, so that deeply nested trees don't
+    // overflow the call stack.  Each element is a node whose children are
+    // being written, together with the index of the next child to write.
+    std::vector<std::pair<const ParseTreeNode*, int>> stack;
+
+    openJson(stream, node);
+    if (node.childCount != 0) {
+        stack.emplace_back(&node, 0);
     }
 
-    stream << "}";
+    while (!stack.empty()) {
+        const ParseTreeNode& parent = *stack.back().first;
+        const int            next   = stack.back().second++;
 
-    // clang-format on
+        if (next == parent.childCount) {
+            stream << "]}";
+            stack.pop_back();
+            continue;
+        }
+
+        if (next != 0) {
+            stream << ", ";
+        }
+
+        const ParseTreeNode& child = parent.children[next];
+        openJson(stream, child);
+        if (child.childCount != 0) {
+            stack.emplace_back(&child, 0);
+        }
+    }
 }
 
 std::ostream& operator<<(std::ostream& stream, const ParseTreeNode& node) {
@@ -111,119 +166,310 @@ ParseError invalidCharacter(int byteOffset, char offendingCharacter) try {
         << int(offendingCharacter)
         << "), which is not in the allowed character set.  Only upper and "
            "lower case English letters are allowed, and the punctutation "
-           "characters \"{\", \"}\", and \",\".";
+           "characters \"{\", \"}\", and \",\".  Digits, \"-\", and \".\" "
+           "are allowed only within a range, e.g. \"{1..10}\".";
 }
 catch (const ParseError& error) {
     return error;
 }
 
-bool isAlpha(char ch) {
-    // Per the C++ Standard, `std::isalpha` invoked with an argument of type
-    // `char` would be undefined behavior, so we cast to `unsigned char` first.
-    return std::isalpha(static_cast<unsigned char>(ch));
+// Return a `ParseError` describing the specified `problem` with the range
+// that begins at the specified `rangeOffset`, found at the specified
+// `byteOffset`.  As with `invalidCharacter`, the error is returned rather
+// than thrown.
+ParseError invalidRange(int         byteOffset,
+                        int         rangeOffset,
+                        const char* problem) try {
+    THROW_ERROR(ParseResult::INVALID_RANGE, byteOffset)
+        << "Encountered an invalid range beginning at byte offset "
+        << rangeOffset << ".  " << problem
+        << "  A range is either \"{X..Y}\" or \"{X..Y..STEP}\", where X and Y "
+           "are both integers or both letters of the same case, and STEP is "
+           "a nonzero integer.";
+}
+catch (const ParseError& error) {
+    return error;
 }
 
-std::unique_ptr<ParseTreeNode> parse(const std::string& input, int byteOffset);
+// `Bound` is a bound or the step of a range, as written.
+struct Bound {
+    bool         letter;  // whether it's a letter rather than an integer
+    std::int64_t value;   // the integer, or the code of the letter
+    int          length;  // how many bytes it spans
+    bool         padded;  // whether it's an integer with a leading zero
+    bool         huge;    // whether it's an integer too large for a range
+};
 
-std::unique_ptr<ParseTreeNode> parseAlternation(const std::string& input,
-                                                int byteOffset) {
-    const int inputSize = input.size();
+// Load into the specified `output` the bound at the beginning of the
+// specified `[begin, end)`: a letter, or an integer, optionally negative.
+// Return a pointer just beyond the bound, or return `begin` if there is no
+// bound there.
+const char* scanBound(Bound& output, const char* begin, const char* end) {
+    const char* cursor = begin;
+    if (cursor != end && isLetter(*cursor)) {
+        output.letter = true;
+        output.value  = *cursor;
+        output.length = 1;
+        output.padded = false;
+        output.huge   = false;
+        return cursor + 1;
+    }
 
-    assert(byteOffset < inputSize);
+    const bool negative = cursor != end && *cursor == '-';
+    cursor += negative;
+
+    const char* const digits = cursor;
+    std::int64_t      value  = 0;
+    bool              huge   = false;
+    for (; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor) {
+        // Stop accumulating before `value` could overflow.  Any value at
+        // least a tenth of the limit is at least the limit once another
+        // digit follows.
+        if (!huge) {
+            huge = value >= MAX_RANGE_MAGNITUDE / 10;
+        }
+        if (!huge) {
+            value = value * 10 + (*cursor - '0');
+        }
+    }
 
-    std::unique_ptr<ParseTreeNode> node(new ParseTreeNode);
-    node->type       = ParseTreeNode::Type::ALTERNATION;
-    node->byteOffset = byteOffset;
+    if (cursor == digits) {
+        return begin;
+    }
 
-    assert(input[byteOffset] == '{');
+    output.letter = false;
+    output.value  = negative ? -value : value;
+    output.length = int(cursor - begin);
+    output.padded = cursor - digits > 1 && *digits == '0';
+    output.huge   = huge;
+    return cursor;
+}
 
-    ++byteOffset;
-    if (byteOffset == inputSize) {
-        THROW_ERROR(ParseResult::UNCLOSED_ALTERNATION, byteOffset)
-            << "The alternation starting at the last character (byte offset "
-            << (byteOffset - 1) << ") was not closed before the end of input.";
-    }
+// `Parser` is an explicit-stack parser, so that arbitrarily deep nesting
+// uses heap memory rather than the call stack.  The nodes parsed so far whose
+// parents are not yet complete are kept on the `pending` stack.  Each
+// alternation that has been opened but not yet closed has a `Frame` on the
+// `frames` stack, recording where in `pending` its children begin.  Once all
+// of a node's children are known, they are moved into a contiguous array
+// allocated from `arena`.
+class Parser {
+    struct Frame {
+        // where the '{' that opened this alternation appears in the input
+        int byteOffset;
+
+        // the index within `pending` of the alternation's first child
+        int childMark;
+
+        // the index within `pending` of the first part of the alternation's
+        // child currently being parsed, which is a sequence if it has more
+        // than one part
+        int partMark;
+    };
+
+    const char* const          input;
+    const int                  inputLength;
+    Arena&                     arena;
+    std::vector<ParseTreeNode> pending;
+    std::vector<Frame>         frames;
+
+    // Return a node of the specified `type` beginning at the specified
+    // `byteOffset`.  The node has no children and zero length.
+    ParseTreeNode makeNode(ParseTreeNode::Type type, int byteOffset) const;
+
+    // Make the elements of `pending` at and after the specified `mark` the
+    // children of the specified `node`, and remove them from `pending`.
+    void adoptChildren(ParseTreeNode& node, int mark);
+
+    // Replace the elements of `pending` at and after the specified `mark`
+    // with a single node: the only element if there is one, and otherwise a
+    // sequence of the elements ending just before the specified
+    // `byteOffset`.
+    void finishSequence(int mark, int byteOffset);
+
+    // If a range begins at the specified `byteOffset`, then parse it, push it
+    // onto `pending`, and return the byte offset just beyond it.  Otherwise,
+    // return `byteOffset`.  Throw a `ParseError` if what begins there looks
+    // like a range, i.e. "{" followed by a bound and "..", but is not a valid
+    // range.
+    int parseRange(int byteOffset);
+
+    // Parse a string beginning at the specified `byteOffset` and push it onto
+    // `pending`.  Return the byte offset just beyond the string.  Throw a
+    // `ParseError` if the string ends at a character that is not allowed.
+    int parseString(int byteOffset);
+
+    // Throw a `ParseError` describing the unexpected character at the
+    // specified `byteOffset`, where a string or an alternation was expected.
+    void unexpectedCharacter(int byteOffset) const;
+
+  public:
+    // Create a parser of the specified `inputLength` bytes at the specified
+    // `input`, which allocates nodes from the specified `arena`.
+    Parser(const char* input, int inputLength, Arena& arena);
+
+    // Return the node parsed from the beginning of the input.  Parsing stops
+    // at the end of input or at a "," or "}" that is not within any
+    // alternation.  Throw a `ParseError` if an error occurs.
+    ParseTreeNode run();
+};
 
-    if (input[byteOffset] == '}') {
-        THROW_ERROR(ParseResult::EMPTY_ALTERNATION, byteOffset)
-            << "An alternation must contain at least one child (e.g. "
-               "\"{foo}\"), but encountered one that had none (e.g. \"{}\").";
-    }
+Parser::Parser(const char* input, int inputLength, Arena& arena)
+: input(input)
+, inputLength(inputLength)
+, arena(arena) {
+}
 
-    // Parse the children of the alternation.
-    for (;;) {
-        std::unique_ptr<ParseTreeNode> child = parse(input, byteOffset);
+ParseTreeNode Parser::makeNode(ParseTreeNode::Type type,
+                               int                 byteOffset) const {
+    ParseTreeNode node;
+    node.type       = type;
+    node.byteOffset = byteOffset;
+    node.byteLength = 0;
+    node.childCount = 0;
+    node.input      = input;
+    node.children   = nullptr;
+    node.range      = nullptr;
+    return node;
+}
 
-        assert(child);
-        assert(child->byteOffset == byteOffset);
+void Parser::adoptChildren(ParseTreeNode& node, int mark) {
+    const int count = int(pending.size()) - mark;
+    assert(count > 0);
 
-        byteOffset += child->source.size();
+    ParseTreeNode* const children = arena.allocateArray<ParseTreeNode>(count);
+    std::copy(pending.begin() + mark, pending.end(), children);
+    pending.resize(mark);
 
-        assert(byteOffset <= inputSize);
+    node.children   = children;
+    node.childCount = count;
+}
 
-        if (byteOffset == inputSize) {
-            THROW_ERROR(ParseResult::UNCLOSED_ALTERNATION, byteOffset)
-                << "Encountered an alternation that was not closed before the "
-                   "end of input.  The alternation began at byte offset "
-                << node->byteOffset << ".";
-        }
+void Parser::finishSequence(int mark, int byteOffset) {
+    assert(mark < int(pending.size()));
 
-        const char ch = input[byteOffset];
-        // If `ch` is ',', then we read the next child.  If it's '}', then
-        // we're done.  It can't be anything else (this is a fact about the
-        // `parse` routine).
+    if (mark + 1 == int(pending.size())) {
+        return;  // a lone part is not a sequence
+    }
 
-        // Either way, we add the most recently read child to the alternation.
-        node->children.push_back(std::move(child));
+    ParseTreeNode sequence =
+        makeNode(ParseTreeNode::Type::SEQUENCE, pending[mark].byteOffset);
+    adoptChildren(sequence, mark);
+    sequence.byteLength = byteOffset - sequence.byteOffset;
+    pending.push_back(sequence);
+}
 
-        if (ch == '}') {
-            // We're done.
-            ++byteOffset;  // consume the closing brace
+int Parser::parseRange(int byteOffset) {
+    const char* const data  = input;
+    const char* const end   = data + inputLength;
+    const char* const begin = data + byteOffset;
+    Bound             first;
+    Bound             last;
+    Bound             step;
 
-            const int endOffset    = byteOffset;
-            const int sourceLength = endOffset - node->byteOffset;
+    assert(*begin == '{');
 
-            node->source = input.substr(node->byteOffset, sourceLength);
-            break;
-        }
-        else {
-            // Loop along to read the next child.
-            assert(ch == ',');
-            ++byteOffset;  // consume the comma
+    const char* cursor = scanBound(first, begin + 1, end);
+    if (cursor == begin + 1 || end - cursor < 2 || cursor[0] != '.' ||
+        cursor[1] != '.') {
+        return byteOffset;  // not a range
+    }
 
-            // It could be that this comma is the last thing in the input, so
-            // report that error.
-            if (byteOffset == inputSize) {
-                THROW_ERROR(ParseResult::UNCLOSED_ALTERNATION, byteOffset)
-                    << "Encountered an alternation that was not closed before "
-                       "the end of input.  The alternation began at byte "
-                       "offset "
-                    << node->byteOffset << ".";
-            }
+    // Return the byte offset of the specified `position` within the input.
+    const auto offsetOf = [&](const char* position) {
+        return int(position - data);
+    };
+
+    cursor += 2;
+    const char* next = scanBound(last, cursor, end);
+    if (next == cursor) {
+        throw invalidRange(offsetOf(cursor),
+                           byteOffset,
+                           "Expected an integer or a letter after \"..\".");
+    }
+    if (first.letter != last.letter) {
+        throw invalidRange(
+            offsetOf(cursor),
+            byteOffset,
+            "Its bounds are not both integers or both letters.");
+    }
+    if (first.letter && (first.value >= 'a') != (last.value >= 'a')) {
+        throw invalidRange(offsetOf(cursor),
+                           byteOffset,
+                           "Its letters are not of the same case.");
+    }
+    cursor = next;
+
+    step.value = 1;
+    step.huge  = false;
+    if (end - cursor >= 2 && cursor[0] == '.' && cursor[1] == '.') {
+        cursor += 2;
+        next = scanBound(step, cursor, end);
+        if (next == cursor || step.letter) {
+            throw invalidRange(offsetOf(cursor),
+                               byteOffset,
+                               "Expected an integer step after \"..\".");
+        }
+        if (step.value == 0) {
+            throw invalidRange(offsetOf(cursor),
+                               byteOffset,
+                               "Its step is zero.");
         }
+        cursor = next;
     }
 
-    const int endOffset    = byteOffset;
-    const int sourceLength = endOffset - node->byteOffset;
+    if (cursor == end || *cursor != '}') {
+        throw invalidRange(offsetOf(cursor),
+                           byteOffset,
+                           "Expected \"}\" to close the range.");
+    }
+    ++cursor;  // consume the closing brace
 
-    node->source = input.substr(node->byteOffset, sourceLength);
+    if (first.huge || last.huge || step.huge) {
+        throw invalidRange(byteOffset,
+                           byteOffset,
+                           "Its bounds and step must each be less than 10^18 "
+                           "in magnitude.");
+    }
 
-    return node;
+    // The sign of the step is ignored, as in bash: a range always counts from
+    // its start toward its end.  The values are counted with an `int`.
+    const bool         descending = last.value < first.value;
+    const std::int64_t stride = step.value < 0 ? -step.value : step.value;
+    const std::int64_t distance =
+        descending ? first.value - last.value : last.value - first.value;
+    if (distance / stride >= std::numeric_limits<int>::max()) {
+        THROW_ERROR(ParseResult::INVALID_RANGE, byteOffset)
+            << "Encountered a range beginning at byte offset " << byteOffset
+            << " that has more than " << std::numeric_limits<int>::max()
+            << " values.";
+    }
+
+    Range range;
+    range.start   = first.value;
+    range.end     = last.value;
+    range.step    = descending ? -stride : stride;
+    range.width   = first.padded || last.padded
+                        ? std::max(first.length, last.length)
+                        : 0;
+    range.letters = first.letter;
+
+    ParseTreeNode node = makeNode(ParseTreeNode::Type::RANGE, byteOffset);
+    node.byteLength    = offsetOf(cursor) - byteOffset;
+    node.range         = arena.create<Range>(range);
+    pending.push_back(node);
+
+    return offsetOf(cursor);
 }
 
-std::unique_ptr<ParseTreeNode> parseString(const std::string& input,
-                                           int                byteOffset) {
-    const int inputSize = input.size();
+int Parser::parseString(int byteOffset) {
+    const int inputSize = inputLength;
 
     assert(byteOffset < inputSize);
 
-    std::unique_ptr<ParseTreeNode> node(new ParseTreeNode);
-    node->type       = ParseTreeNode::Type::STRING;
-    node->byteOffset = byteOffset;
+    ParseTreeNode node = makeNode(ParseTreeNode::Type::STRING, byteOffset);
 
-    while (byteOffset < inputSize && isAlpha(input[byteOffset])) {
-        ++byteOffset;
-    }
+    const char* const data = input;
+    byteOffset = findNonLetter(data + byteOffset, data + inputSize) - data;
 
     // Reached the end of the string, or reached some punctuation, or reached
     // an invalid character.
@@ -234,37 +480,21 @@ std::unique_ptr<ParseTreeNode> parseString(const std::string& input,
         }
     }
 
-    const int sourceLength = byteOffset - node->byteOffset;
-    node->source           = input.substr(node->byteOffset, sourceLength);
+    node.byteLength = byteOffset - node.byteOffset;
+    pending.push_back(node);
 
-    return node;
+    return byteOffset;
 }
 
-// Return a node parsed from the specified `input` starting at the specified
-// `byteOffset`.  Throw a `ParseError` if an error occurs.  The returned value
-// will not be null.  Note that there is sufficient information in the returned
-// value to deduce the byte offset just beyond the returned node.
-std::unique_ptr<ParseTreeNode> parseOne(const std::string& input,
-                                        int                byteOffset) {
-    assert(byteOffset >= 0);
-    assert(byteOffset < int(input.size()));
-
+void Parser::unexpectedCharacter(int byteOffset) const {
     const char ch = input[byteOffset];
 
-    if (ch == '{') {
-        return parseAlternation(input, byteOffset);
-    }
-
-    if (isAlpha(ch)) {
-        return parseString(input, byteOffset);
-    }
-
     // TODO: Consider creating specific diagnostics for empty alternation
     //       options.  Right now the error that is triggered is
     //       "unexpected ','" or "unexpected '}'".  It would be better to
     //       notice the case where you have ",," or ",}".
 
-    // Otherwise it's a parse error.  First check for misplaced special chars.
+    // First check for misplaced special chars.
     if (ch == '}') {
         THROW_ERROR(ParseResult::MISPLACED_CHARACTER, byteOffset)
             << "Encountered an unexpected \"}\" character.  \"}\" can be used "
@@ -284,80 +514,124 @@ std::unique_ptr<ParseTreeNode> parseOne(const std::string& input,
     throw invalidCharacter(byteOffset, ch);
 }
 
-std::unique_ptr<ParseTreeNode> parse(const std::string& input,
-                                     int                byteOffset) {
-    std::unique_ptr<ParseTreeNode> node = parseOne(input, byteOffset);
-    assert(node);
-    assert(node->byteOffset == byteOffset);
+ParseTreeNode Parser::run() {
+    const int inputSize  = inputLength;
+    int       byteOffset = 0;
+    int       partMark   = 0;  // `Frame::partMark` of the top level
 
-    byteOffset += node->source.size();
-    assert(byteOffset <= int(input.size()));
+    assert(inputSize > 0);
+    pending.clear();
+    frames.clear();
 
-    if (byteOffset == int(input.size())) {
-        // reached the end of input
-        return node;
-    }
+    for (;;) {
+        // Parse the next part of a sequence: either a string, a range, or the
+        // opening of an alternation.
+        assert(byteOffset < inputSize);
+        const char ch       = input[byteOffset];
+        const int  rangeEnd = ch == '{' ? parseRange(byteOffset) : byteOffset;
+
+        if (rangeEnd != byteOffset) {
+            byteOffset = rangeEnd;
+        }
+        else if (ch == '{') {
+            ++byteOffset;
+            if (byteOffset == inputSize) {
+                THROW_ERROR(ParseResult::UNCLOSED_ALTERNATION, byteOffset)
+                    << "The alternation starting at the last character (byte "
+                       "offset "
+                    << (byteOffset - 1)
+                    << ") was not closed before the end of input.";
+            }
 
-    const char ch = input[byteOffset];
-    if (ch == ',' || ch == '}') {
-        // reached the middle or end of something
-        return node;
-    }
+            if (input[byteOffset] == '}') {
+                THROW_ERROR(ParseResult::EMPTY_ALTERNATION, byteOffset)
+                    << "An alternation must contain at least one child (e.g. "
+                       "\"{foo}\"), but encountered one that had none (e.g. "
+                       "\"{}\").";
+            }
 
-    // The only remaining case is one of the following:
-    //
-    //     IwasJustParsed{and,now,here}...
-    //
-    // or
-    //
-    //     {this,was,parsed}andNowHere
-    //
-    // Either case is a sequence.  So, keep parsing the rest of the sequence's
-    // children.
+            Frame frame;
+            frame.byteOffset = byteOffset - 1;
+            frame.childMark  = pending.size();
+            frame.partMark   = pending.size();
+            frames.push_back(frame);
+            continue;  // and parse the alternation's first child
+        }
+        else {
+            if (!isLetter(ch)) {
+                unexpectedCharacter(byteOffset);
+            }
 
-    const int beginOffset = node->byteOffset;
+            byteOffset = parseString(byteOffset);
+        }
 
-    std::unique_ptr<ParseTreeNode> sequence(new ParseTreeNode);
-    sequence->type       = ParseTreeNode::Type::SEQUENCE;
-    sequence->byteOffset = beginOffset;
+        // A part was just completed.  If it's followed by another part, then
+        // go parse that.  Otherwise, it ends the sequence being parsed, which
+        // might in turn end one or more alternations.
+        for (;;) {
+            if (byteOffset != inputSize) {
+                const char ch = input[byteOffset];
+                if (ch != ',' && ch != '}') {
+                    break;  // another part of the same sequence
+                }
+            }
 
-    sequence->children.push_back(std::move(node));
+            if (frames.empty()) {
+                // We're at the end of input, or at a ',' or '}' that isn't
+                // within any alternation.  Either way, we're done.
+                finishSequence(partMark, byteOffset);
+                assert(pending.size() == 1);
+                return pending.back();
+            }
 
-    for (;;) {
-        std::unique_ptr<ParseTreeNode> node = parseOne(input, byteOffset);
-        assert(node);
-        assert(node->byteOffset == byteOffset);
+            Frame& frame = frames.back();
+            finishSequence(frame.partMark, byteOffset);
 
-        byteOffset += node->source.size();
-        assert(byteOffset <= int(input.size()));
+            if (byteOffset == inputSize) {
+                THROW_ERROR(ParseResult::UNCLOSED_ALTERNATION, byteOffset)
+                    << "Encountered an alternation that was not closed before "
+                       "the end of input.  The alternation began at byte "
+                       "offset "
+                    << frame.byteOffset << ".";
+            }
 
-        sequence->children.push_back(std::move(node));
+            if (input[byteOffset] == ',') {
+                ++byteOffset;  // consume the comma
+
+                // It could be that this comma is the last thing in the input,
+                // so report that error.
+                if (byteOffset == inputSize) {
+                    THROW_ERROR(ParseResult::UNCLOSED_ALTERNATION, byteOffset)
+                        << "Encountered an alternation that was not closed "
+                           "before the end of input.  The alternation began "
+                           "at byte offset "
+                        << frame.byteOffset << ".";
+                }
+
+                frame.partMark = pending.size();
+                break;  // and parse the alternation's next child
+            }
 
-        if (byteOffset == int(input.size())) {
-            // reached the end of input
-            break;
-        }
+            // The alternation is closed, which completes a part of the
+            // enclosing sequence.
+            assert(input[byteOffset] == '}');
+            ++byteOffset;  // consume the closing brace
 
-        const char ch = input[byteOffset];
-        if (ch == ',' || ch == '}') {
-            // reached the middle or end of something
-            break;
+            ParseTreeNode alternation =
+                makeNode(ParseTreeNode::Type::ALTERNATION, frame.byteOffset);
+            adoptChildren(alternation, frame.childMark);
+            alternation.byteLength = byteOffset - alternation.byteOffset;
+            pending.push_back(alternation);
+            frames.pop_back();
         }
     }
-
-    const int endOffset    = byteOffset;
-    const int sourceLength = endOffset - beginOffset;
-
-    sequence->source = input.substr(beginOffset, sourceLength);
-
-    return sequence;
 }
 
-void printDiagnostic(std::ostream&      stream,
-                     const ParseError&  error,
-                     const std::string& input) {
-    const int offset      = error.byteOffset;
-    const int inputLength = input.size();
+void printDiagnostic(std::ostream&     stream,
+                     const ParseError& error,
+                     const char*       input,
+                     int               inputLength) {
+    const int offset = error.byteOffset;
 
     stream << error.message << "  Error occurred at byte offset " << offset
            << ":\n";
@@ -369,7 +643,8 @@ void printDiagnostic(std::ostream&      stream,
     const int maxWidth = border + 1 + border;
 
     if (inputLength <= maxWidth) {
-        stream << input << "\n" << std::string(offset, ' ') << '^';
+        stream.write(input, inputLength);
+        stream << "\n" << std::string(offset, ' ') << '^';
     }
     else {
         // Figure out what to elide.  Prefer to keep the pointed-to character
@@ -380,23 +655,30 @@ void printDiagnostic(std::ostream&      stream,
 
         if (offset > border) {
             const int leftLength = border - elideLeft.size();
-            prefix = elideLeft + input.substr(offset - leftLength, leftLength);
+            prefix = elideLeft +
+                     std::string(input + offset - leftLength, leftLength);
         }
         else {
-            prefix = input.substr(0, offset);
+            prefix.assign(input, offset);
         }
 
-        stream << prefix << input[offset];
+        stream << prefix;
+
+        // The error might be at the end of input, just beyond the last
+        // character, in which case there's no character to point at.
+        if (offset < inputLength) {
+            stream << input[offset];
+        }
 
         const std::string elideRight(" ...");
         std::string       suffix;
 
         if (inputLength - offset > border) {
             const int rightLength = border - elideRight.size();
-            suffix = input.substr(offset + 1, rightLength) + elideRight;
+            suffix = std::string(input + offset + 1, rightLength) + elideRight;
         }
-        else {
-            suffix = input.substr(offset + 1, inputLength - offset - 1);
+        else if (offset < inputLength) {
+            suffix.assign(input + offset + 1, inputLength - offset - 1);
         }
 
         stream << suffix << "\n" << std::string(prefix.size(), ' ') << '^';
@@ -407,53 +689,65 @@ void printDiagnostic(std::ostream&      stream,
 
 }  // namespace
 
-ParseResult parse(ParseTreeNode&     output,
-                  const std::string& input,
-                  std::ostream*      errors) try {
+ParseResult parse(ParseTreeNode& output,
+                  Arena&         arena,
+                  const char*    input,
+                  std::size_t    inputSize,
+                  std::ostream*  errors) try {
     // We use `int` for byte offsets.  If you're trying to expand gigabytes of
     // curly braces, then someone needs to tell you to stop, and it might as
     // well be me.
     const std::size_t MAX_INPUT_SIZE = std::numeric_limits<int>::max();
     const int         byteOffset     = 0;
 
-    if (input.size() > MAX_INPUT_SIZE) {
+    if (inputSize > MAX_INPUT_SIZE) {
         THROW_ERROR(ParseResult::INPUT_TOO_LARGE, byteOffset)
-            << "Input is too large (having size " << input.size()
+            << "Input is too large (having size " << inputSize
             << " bytes).  Maximum allowed input size is " << MAX_INPUT_SIZE
             << " bytes.";
     }
 
-    if (input.empty()) {
+    if (inputSize == 0) {
         THROW_ERROR(ParseResult::EMPTY_INPUT, byteOffset)
             << "Cannot parse empty input.";
     }
 
-    // Call an overload of `parse` that returns a
-    // `unique_ptr<ParseTreeNode>` (that is also never null), and if all went
-    // well, then move the referred-to `ParseTreeNode` into `output`.
-    std::unique_ptr<ParseTreeNode> tree(parse(input, byteOffset));
-    assert(tree);
-    assert(tree->source.size() <= input.size());
+    // Parse as much of the input as possible, and if all went well, then
+    // copy the result into `output`.
+    Parser              parser(input, int(inputSize), arena);
+    const ParseTreeNode tree = parser.run();
+    assert(tree.byteOffset == byteOffset);
+    assert(std::size_t(tree.byteLength) <= inputSize);
 
-    const auto parsedSize = tree->source.size();
+    const auto parsedSize = std::size_t(tree.byteLength);
 
-    if (parsedSize != input.size()) {
+    if (parsedSize != inputSize) {
         const char ch = input[parsedSize];
         THROW_ERROR(ParseResult::MISPLACED_CHARACTER, parsedSize)
             << "Parsing ended prematurely at the character \"" << ch
             << "\" (ASCII " << int(ch) << ").";
     }
 
-    output = std::move(*tree);
+    output = tree;
 
     return ParseResult::SUCCESS;
 }
 catch (const ParseError& error) {
     if (errors != nullptr) {
-        printDiagnostic(*errors, error, input);
+        // An input too large to parse is excerpted as if it were cut short.
+        const std::size_t excerpted = std::min<std::size_t>(
+            inputSize, std::numeric_limits<int>::max());
+        printDiagnostic(*errors, error, input, int(excerpted));
     }
 
     return error.code;
 }
 
+ParseResult parse(ParseTreeNode&     output,
+                  Arena&             arena,
+                  const std::string& input,
+                  std::ostream*      errors) {
+    return parse(output, arena, input.data(), input.size(), errors);
+}
+
 }  // namespace brex
@@ -1,13 +1,15 @@
 #ifndef INCLUDED_BREX_PARSE
 #define INCLUDED_BREX_PARSE
 
-#include <iosfwd>  // ostream&
-#include <memory>  // unique_ptr
+#include <cstddef>  // size_t
+#include <iosfwd>   // ostream&
 #include <string>
-#include <vector>
 
 namespace brex {
 
+class Arena;
+struct Range;
+
 // `ParseResult` is returned by `parse`.  On success, `ParseResult::SUCCESS` is
 // returned.  All other values of `ParseResult` indicate some parsing error.
 // Note that the integral values of these constants must be stable, because
@@ -22,14 +24,16 @@ enum class ParseResult {
     UNCLOSED_ALTERNATION    = 4,
     MISPLACED_CHARACTER     = 5,
     INPUT_TOO_LARGE         = 7,
-    EMPTY_INPUT             = 8
+    EMPTY_INPUT             = 8,
+    INVALID_RANGE           = 9
 };
 
 struct ParseTreeNode {
     enum class Type {
-        STRING,      // e.g. foo
-        SEQUENCE,    // e.g. foo{bar,baz}y
-        ALTERNATION  // e.g. {bar,baz}
+        STRING,       // e.g. foo
+        SEQUENCE,     // e.g. foo{bar,baz}y
+        ALTERNATION,  // e.g. {bar,baz}
+        RANGE         // e.g. {1..10}, {a..z}, or {01..99..2}
     };
 
     Type type;
@@ -37,15 +41,49 @@ struct ParseTreeNode {
     // where in the input string this node appears, zero-based
     int byteOffset;  // zero-based
 
-    // A copy of the substring within the input from which this node is parsed.
-    std::string source;
+    // how many bytes of the input string this node spans
+    int byteLength;
+
+    // how many elements `children` has
+    int childCount;
+
+    // The beginning of the entire input string from which this node is
+    // parsed.  The node does not own the input, and does not copy any of it.
+    const char* input;
+
+    // Return a pointer to the first byte of the substring within the input
+    // from which this node is parsed.  The substring has `byteLength` bytes.
+    const char* sourceBegin() const;
+
+    // Return a copy of the substring within the input from which this node is
+    // parsed.
+    std::string source() const;
+
+    // The children of this node, in order, as a contiguous array of
+    // `childCount` nodes.  The array is allocated from the `Arena` passed to
+    // `parse`, and is null if the node has no children.
+    const ParseTreeNode* children;
 
-    // Evidently C++17 can handle `std::vector<ParseTreeNode>` here (and
-    // probably many standard libraries handle it as an extension), but for
-    // portability I'll use a `std::vector<std::unique_ptr<ParseTreeNode>>`.
-    std::vector<std::unique_ptr<ParseTreeNode>> children;
+    // The bounds of a `RANGE` node (see `range.h`), allocated from the
+    // `Arena` passed to `parse`, or null if the node is not a range.
+    const Range* range;
 };
 
+// inline definitions
+// ------------------
+
+inline const char* ParseTreeNode::sourceBegin() const {
+    return input + byteOffset;
+}
+
+inline std::string ParseTreeNode::source() const {
+    return std::string(sourceBegin(), byteLength);
+}
+
+// Return the number of nodes on the longest path from the specified `root` to
+// a leaf of its tree, including both ends.
+int treeDepth(const ParseTreeNode& root);
+
 // Insert into the specified `stream` a JSON representation of the specified
 // `node`.
 void toJson(std::ostream& stream, const ParseTreeNode& node);
@@ -55,14 +93,32 @@ void toJson(std::ostream& stream, const ParseTreeNode& node);
 std::ostream& operator<<(std::ostream& stream, const ParseTreeNode& node);
 
 // Populate the specified `output` with the parse tree of the specified
-// `input` shell bracket expression.  Return `ParseResult::SUCCESS` on success
-// or another `ParseResult` value if an error occurs.  If an error occurs,
-// insert a diagnostic into the optionally specified `errors`.  Also if an
-// error occurs, `output` is not modified.
+// `input` shell bracket expression, allocating the nodes of the tree from the
+// specified `arena`.  Return `ParseResult::SUCCESS` on success or another
+// `ParseResult` value if an error occurs.  If an error occurs, insert a
+// diagnostic into the optionally specified `errors`.  Also if an error
+// occurs, `output` is not modified.  Note that `output` refers to, but does
+// not copy, the contents of `input`, so the behavior is undefined if `output`
+// is used after `input` is modified or destroyed, or after `arena` is reset
+// or destroyed.
 ParseResult parse(ParseTreeNode&     output,
+                  Arena&             arena,
                   const std::string& input,
                   std::ostream*      errors = nullptr);
 
+// Populate the specified `output` with the parse tree of the shell bracket
+// expression that is the specified `inputSize` bytes at the specified
+// `input`, as the other overload of `parse` does.  `input` need not be null
+// terminated, and is neither copied nor modified, so it can be, e.g., a
+// read-only mapping of a file (see `mapped.h`).  The behavior is undefined
+// if `output` is used after `input` is modified or unmapped, or after
+// `arena` is reset or destroyed.
+ParseResult parse(ParseTreeNode& output,
+                  Arena&         arena,
+                  const char*    input,
+                  std::size_t    inputSize,
+                  std::ostream*  errors = nullptr);
+
 }  // namespace brex
 
 #endif
@@ -0,0 +1,165 @@
+#include <brex/pattern.h>
+
+#include <algorithm>  // sort, unique
+#include <cassert>
+
+namespace brex {
+
+const int Pattern::DEAD;
+
+Pattern::Pattern()
+: interner(sets) {
+    Element star;
+    star.kind = Element::Kind::STAR;
+    elements.push_back(star);
+    reset();
+}
+
+int Pattern::finishSet(int begin) {
+    const int end = int(elements.size());
+
+    // Skipping a `*` leads to the position after it.  Positions added here
+    // are themselves visited by the loop.
+    for (std::size_t i = begin; i < sets.size(); ++i) {
+        const int position = sets[i];
+        if (position < end && elements[position].kind == Element::Kind::STAR) {
+            sets.push_back(position + 1);
+        }
+    }
+
+    std::sort(sets.begin() + begin, sets.end());
+    sets.erase(std::unique(sets.begin() + begin, sets.end()), sets.end());
+    const bool matches = int(sets.size()) > begin && sets.back() == end;
+
+    const int count = interner.size();
+    const int state = interner.intern(int(sets.size()) - begin);
+    if (state == count) {
+        transitions.resize(transitions.size() + 256, -1);
+        accepting.push_back(matches);
+    }
+    return state;
+}
+
+int Pattern::computeStep(int state, unsigned char byte) {
+    const int end    = int(elements.size());
+    const int offset = interner.offset(state);
+    const int length = interner.length(state);
+    const int begin  = int(sets.size());
+
+    for (int i = 0; i < length; ++i) {
+        const int position = sets[offset + i];
+        if (position == end) {
+            continue;
+        }
+
+        const Element& element = elements[position];
+        if (element.kind == Element::Kind::STAR) {
+            sets.push_back(position);
+        }
+        else if (element.bytes[byte]) {
+            sets.push_back(position + 1);
+        }
+    }
+
+    const int next                  = finishSet(begin);
+    transitions[state * 256 + byte] = next;
+    return next;
+}
+
+void Pattern::reset() {
+    interner.clear();
+    transitions.clear();
+    accepting.clear();
+
+    // The empty set is the dead state, and it leads only to itself.
+    finishSet(int(sets.size()));
+    std::fill(transitions.begin(), transitions.end(), DEAD);
+
+    sets.push_back(0);
+    const int initial = finishSet(int(sets.size()) - 1);
+    assert(initial == start());
+    (void)initial;
+}
+
+int Pattern::assignGlob(const std::string& glob) {
+    std::vector<Element> parsed;
+    const std::size_t    size = glob.size();
+
+    for (std::size_t i = 0; i < size; ++i) {
+        Element element;
+        element.kind = Element::Kind::BYTE;
+
+        const char current = glob[i];
+        if (current == '*') {
+            element.kind = Element::Kind::STAR;
+        }
+        else if (current == '?') {
+            element.bytes.set();
+        }
+        else if (current == '\\') {
+            if (++i == size) {
+                return 1;  // nothing to escape
+            }
+            element.bytes.set(static_cast<unsigned char>(glob[i]));
+        }
+        else if (current == '[') {
+            std::size_t j = i + 1;
+            const bool  negate =
+                j < size && (glob[j] == '!' || glob[j] == '^');
+            if (negate) {
+                ++j;
+            }
+
+            // A `]` right after the `[` (or after the `!`) doesn't close.
+            for (const std::size_t first = j;
+                 j < size && (glob[j] != ']' || j == first);
+                 ++j) {
+                const unsigned char low = glob[j];
+                if (j + 2 < size && glob[j + 1] == '-' && glob[j + 2] != ']') {
+                    const unsigned char high = glob[j + 2];
+                    for (int byte = low; byte <= high; ++byte) {
+                        element.bytes.set(byte);
+                    }
+                    j += 2;
+                }
+                else {
+                    element.bytes.set(low);
+                }
+            }
+
+            if (j == size) {
+                return 1;  // unclosed bracket
+            }
+            if (negate) {
+                element.bytes.flip();
+            }
+            i = j;
+        }
+        else {
+            element.bytes.set(static_cast<unsigned char>(current));
+        }
+
+        parsed.push_back(element);
+    }
+
+    elements.swap(parsed);
+    reset();
+    return 0;
+}
+
+void Pattern::assignPrefix(const std::string& prefix) {
+    elements.clear();
+    for (const char byte : prefix) {
+        Element element;
+        element.kind = Element::Kind::BYTE;
+        element.bytes.set(static_cast<unsigned char>(byte));
+        elements.push_back(element);
+    }
+
+    Element star;
+    star.kind = Element::Kind::STAR;
+    elements.push_back(star);
+    reset();
+}
+
+}  // namespace brex
@@ -0,0 +1,111 @@
+#ifndef INCLUDED_BREX_PATTERN
+#define INCLUDED_BREX_PATTERN
+
+#include <brex/interner.h>
+
+#include <bitset>
+#include <string>
+#include <vector>
+
+namespace brex {
+
+// `Pattern` is a shell glob pattern that strings are matched against one
+// byte at a time, from the beginning, such that after each byte it is known
+// whether any continuation of the bytes so far could match.  This is what
+// lets an expansion skip every term that begins with a prefix that can't
+// match (see `filter.h`).
+//
+// The pattern is a nondeterministic automaton whose states are positions
+// within the pattern.  It is matched as a deterministic automaton whose
+// states are sets of positions, built lazily: each set of positions, and
+// each transition from one set to another, is computed the first time it is
+// needed, and then remembered.  So matching costs a table lookup per byte,
+// and a pattern costs memory in proportion to how much of it is used.
+//
+// The syntax is that of a shell glob:
+//
+// - `*` matches any sequence of bytes, including none,
+// - `?` matches any one byte,
+// - `[...]` matches any one byte in the brackets, where `a-z` is a range of
+//   bytes, and where `!` or `^` first matches any byte not in the brackets,
+//   and where a `]` first is itself in the brackets,
+// - `\` matches the byte that follows it literally,
+// - any other byte matches itself.
+//
+// The whole string must match the whole pattern.
+class Pattern {
+    struct Element {
+        enum class Kind { STAR, BYTE };
+
+        Kind             kind;
+        std::bitset<256> bytes;  // `BYTE`: which bytes match
+    };
+
+    std::vector<Element>       elements;
+    std::vector<int>           sets;  // sorted sets of positions
+    Interner<std::vector<int>> interner;
+    std::vector<int>           transitions;  // 256 per state, -1 if unknown
+    std::vector<char>          accepting;    // whether each state matches
+
+    // Add to the set of positions at the end of `sets` every position
+    // reachable from it by skipping `*` elements, sort it, intern it, and
+    // return its state.
+    int finishSet(int begin);
+
+    // Return the state that follows the specified `state` on the specified
+    // `byte`, where the transition has not been computed before.
+    int computeStep(int state, unsigned char byte);
+
+    // Discard any states and set up the initial and dead states.
+    void reset();
+
+  public:
+    // the state from which no string matches
+    static const int DEAD = 0;
+
+    // Create a pattern that matches every string.
+    Pattern();
+
+    Pattern(const Pattern&) = delete;
+    Pattern& operator=(const Pattern&) = delete;
+
+    // Set this object to match the specified `glob`.  Return zero on
+    // success, or a nonzero value if `glob` is malformed: if it has a `[`
+    // without a matching `]`, or if it ends with an unescaped `\`.  If
+    // `glob` is malformed, then this object is not modified.
+    int assignGlob(const std::string& glob);
+
+    // Set this object to match every string that begins with the specified
+    // `prefix`.
+    void assignPrefix(const std::string& prefix);
+
+    // Return the state in which matching begins.
+    int start() const;
+
+    // Return the state that follows the specified `state` on the specified
+    // `byte`.  Return `DEAD` if no string that continues this way can match.
+    int step(int state, unsigned char byte);
+
+    // Return whether a string that ends in the specified `state` matches.
+    bool accepts(int state) const;
+};
+
+// inline definitions
+// ------------------
+
+inline int Pattern::start() const {
+    return 1;
+}
+
+inline int Pattern::step(int state, unsigned char byte) {
+    const int next = transitions[state * 256 + byte];
+    return next >= 0 ? next : computeStep(state, byte);
+}
+
+inline bool Pattern::accepts(int state) const {
+    return accepting[state];
+}
+
+}  // namespace brex
+
+#endif
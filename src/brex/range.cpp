@@ -0,0 +1,231 @@
+#include <brex/range.h>
+
+#include <algorithm>  // max, min
+#include <cassert>
+#include <cstring>  // memcpy, memmove, memset
+
+namespace brex {
+namespace {
+
+// Return the specified `dividend` divided by the specified positive
+// `divisor`, rounded toward negative infinity.
+std::int64_t floorDivide(std::int64_t dividend, std::int64_t divisor) {
+    assert(divisor > 0);
+    return dividend >= 0 ? dividend / divisor
+                         : -((-dividend + divisor - 1) / divisor);
+}
+
+// Write into the specified `output` the decimal digits of the specified
+// `magnitude`, most significant first, and return how many there are.
+// `output` must have room for 20 bytes.
+int writeDigits(char* output, std::uint64_t magnitude) {
+    char reversed[20];
+    int  count = 0;
+    do {
+        reversed[count++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+
+    for (int i = 0; i < count; ++i) {
+        output[i] = reversed[count - 1 - i];
+    }
+    return count;
+}
+
+// Return the magnitude of the specified `value`.
+std::uint64_t magnitude(std::int64_t value) {
+    return value < 0 ? -std::uint64_t(value) : std::uint64_t(value);
+}
+
+}  // namespace
+
+// struct Range
+// ------------
+
+int Range::count() const {
+    return int(magnitude(end - start) / magnitude(step)) + 1;
+}
+
+std::uint64_t Range::totalLength() const {
+    const int values = count();
+    if (letters) {
+        return values;
+    }
+
+    const std::int64_t lowest = std::min(start, value(values - 1));
+    const std::int64_t stride = magnitude(step);
+
+    // Return how many values lie within `[low, high]`.
+    const auto between = [&](std::int64_t low, std::int64_t high) {
+        const std::int64_t first =
+            std::max<std::int64_t>(0, -floorDivide(lowest - low, stride));
+        const std::int64_t last = std::min<std::int64_t>(
+            values - 1, floorDivide(high - lowest, stride));
+        return std::uint64_t(std::max<std::int64_t>(0, last - first + 1));
+    };
+
+    // Count the values having each number of digits, first the non-negative
+    // and then the negative, whose texts are one byte longer.
+    std::uint64_t result = 0;
+    std::int64_t  power  = 1;  // 10^(digits - 1)
+    for (std::uint64_t digits = 1; power < MAX_RANGE_MAGNITUDE; ++digits) {
+        const std::int64_t low  = digits == 1 ? 0 : power;
+        const std::int64_t high = power * 10 - 1;
+        const std::uint64_t length = std::max<std::uint64_t>(width, digits);
+
+        result += between(low, high) * length;
+        result += between(-high, -std::max<std::int64_t>(low, 1)) *
+                  std::max(length, digits + 1);
+        power *= 10;
+    }
+    return result;
+}
+
+int Range::format(char* output, int index) const {
+    const std::int64_t number = value(index);
+
+    if (letters) {
+        output[0] = char(number);
+        return 1;
+    }
+
+    char      digits[20];
+    const int count  = writeDigits(digits, magnitude(number));
+    const int sign   = number < 0;
+    const int zeros  = std::max(0, width - sign - count);
+    char*     cursor = output;
+
+    if (sign) {
+        *cursor++ = '-';
+    }
+    std::memset(cursor, '0', zeros);
+    std::memcpy(cursor + zeros, digits, count);
+    return sign + zeros + count;
+}
+
+int Range::increment(char* text, int& length, int index) const {
+    assert(index > 0);
+    assert(index < count());
+
+    const std::int64_t previous = value(index - 1);
+    const std::int64_t next     = value(index);
+
+    if (letters) {
+        text[0] = char(next);
+        return 0;
+    }
+
+    if (previous < 0 || next < 0) {
+        // A "-" would come or go, so start over.
+        length = format(text, index);
+        return 0;
+    }
+
+    std::uint64_t carry = magnitude(step);
+    int           i     = length;
+
+    if (step > 0) {
+        // Add the step to the digits, least significant first, stopping as
+        // soon as nothing is left to carry.
+        while (carry && i > 0) {
+            --i;
+            const std::uint64_t sum = (text[i] - '0') + carry % 10;
+            carry                   = carry / 10 + sum / 10;
+            text[i]                 = char('0' + sum % 10);
+        }
+
+        if (carry) {
+            // The value outgrew its text, e.g. "99" became "100", so the
+            // rest of the carry becomes new leading digits.
+            char      digits[20];
+            const int count = writeDigits(digits, carry);
+            std::memmove(text + count, text, length);
+            std::memcpy(text, digits, count);
+            length += count;
+            return 0;
+        }
+        return i;
+    }
+
+    // Subtract the step from the digits.  Since `next` is not negative, the
+    // borrowing ends within the text.
+    while (carry) {
+        assert(i > 0);
+        --i;
+        int difference = (text[i] - '0') - int(carry % 10);
+        carry /= 10;
+        if (difference < 0) {
+            difference += 10;
+            ++carry;
+        }
+        text[i] = char('0' + difference);
+    }
+
+    // Drop the leading zeros that padding doesn't call for, e.g. "10" became
+    // "09" but should be "9".
+    int zeros = 0;
+    while (length - zeros > std::max(width, 1) && text[zeros] == '0') {
+        ++zeros;
+    }
+    if (zeros) {
+        std::memmove(text, text + zeros, length - zeros);
+        length -= zeros;
+        return 0;
+    }
+    return i;
+}
+
+int Range::skip(int index, int prefix) const {
+    assert(index >= 0);
+    assert(index < count());
+    assert(prefix > 0);
+
+    if (letters) {
+        return index + 1;
+    }
+
+    const std::int64_t  number = value(index);
+    const int           sign   = number < 0;
+    const std::uint64_t digits = magnitude(number);
+
+    int places = 1;  // how many decimal digits `digits` has
+    for (std::uint64_t rest = digits / 10; rest; rest /= 10) {
+        ++places;
+    }
+    const int length = std::max(width, sign + places);
+    assert(prefix <= length);
+
+    // The magnitudes whose texts share the prefix are those that share the
+    // digits before the last `length - prefix`, and that have as many
+    // digits as `digits` if it has more than the padding calls for.
+    std::uint64_t lowest  = 0;
+    std::uint64_t highest = MAX_RANGE_MAGNITUDE - 1;
+    if (length - prefix < MAX_UNPADDED_LENGTH) {
+        std::uint64_t scale = 1;
+        for (int i = 0; i < length - prefix; ++i) {
+            scale *= 10;
+        }
+        lowest  = digits / scale * scale;
+        highest = std::min(highest, lowest + scale - 1);
+    }
+    if (places > width - sign && places > 1) {
+        std::uint64_t least = 1;
+        for (int i = 1; i < places; ++i) {
+            least *= 10;
+        }
+        lowest = std::max(lowest, least);
+    }
+    if (sign) {
+        lowest = std::max<std::uint64_t>(lowest, 1);
+    }
+
+    // Find the first value beyond those magnitudes in the direction of the
+    // step.
+    const std::int64_t low  = sign ? -std::int64_t(highest) : lowest;
+    const std::int64_t high = sign ? -std::int64_t(lowest) : highest;
+    const std::int64_t next = step > 0 ? (high - start) / step + 1
+                                       : (start - low) / -step + 1;
+    return int(std::min<std::int64_t>(next, count()));
+}
+
+}  // namespace brex
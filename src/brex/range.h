@@ -0,0 +1,95 @@
+#ifndef INCLUDED_BREX_RANGE
+#define INCLUDED_BREX_RANGE
+
+#include <cstdint>  // int64_t, uint64_t
+
+namespace brex {
+
+// `Range` is an arithmetic progression of integers, e.g. `{1..10}`,
+// `{10..1..3}`, or `{007..100}`, or of letters, e.g. `{a..z}`.  It holds only
+// its bounds, step, and width, however many values it has, so a range costs
+// the same to parse, compile, and count whether it has ten values or a
+// billion.
+//
+// The text of an integer value is its decimal representation, preceded by a
+// "-" if it's negative, and padded with zeros after any "-" to be at least
+// `width` bytes long.  The text of a letter value is the letter.
+//
+// A value's text can be produced from scratch by `format`, but `increment`
+// instead turns the text of one value into that of the next by adding the
+// step to its digits in place, the way an odometer turns, so that expanding
+// a range seldom touches more than its last digit or two.
+struct Range {
+    std::int64_t start;    // the first value, or the code of the first letter
+    std::int64_t end;      // the bound opposite `start`, which might not be a
+                           // value if the step doesn't divide the distance
+    std::int64_t step;     // nonzero, and negative if `end < start`
+    int          width;    // the least length of an integer value's text
+    bool         letters;  // whether the values are letters
+
+    // Return the number of values of this range.
+    int count() const;
+
+    // Return the value at the specified zero-based `index`.  The behavior is
+    // undefined unless `0 <= index < count()`.
+    std::int64_t value(int index) const;
+
+    // Return an upper bound on the length of the text of any value of this
+    // range.  The bound depends only on the width, not on the values.
+    int maxLength() const;
+
+    // Return the sum of the lengths of the texts of all of the values of
+    // this range.  This is computed from the digit counts of the values, so
+    // it takes the same time however many values there are.
+    std::uint64_t totalLength() const;
+
+    // Write into the specified `output` the text of the value at the
+    // specified `index`, and return its length.  `output` must have room for
+    // `maxLength()` bytes.
+    int format(char* output, int index) const;
+
+    // Replace the text of the value at the specified `index - 1`, which is
+    // the specified `length` bytes at the specified `text`, with the text of
+    // the value at `index`, and load its length into `length`.  Return the
+    // position within `text` of the first byte that changed.  `text` must
+    // have room for `maxLength()` bytes.  The behavior is undefined unless
+    // `0 < index < count()`.
+    int increment(char* text, int& length, int index) const;
+
+    // Return the index of the first value after the one at the specified
+    // `index` whose text differs from that value's text in length or within
+    // its first specified `prefix` bytes, or return `count()` if there is no
+    // such value.  Since the values are in order, and texts of one length
+    // are in the same order as their values, every value in between has a
+    // text of that length that begins with those bytes.
+    // The behavior is undefined unless `0 <= index < count()` and
+    // `0 < prefix`, and `prefix` is at most the length of the text.
+    int skip(int index, int prefix) const;
+};
+
+// `MAX_RANGE_MAGNITUDE` is one more than the greatest magnitude allowed for
+// the bounds and step of a range.  It keeps the arithmetic on the values of
+// a range within 64 bits.
+const std::int64_t MAX_RANGE_MAGNITUDE = 1000000000000000000;  // 10^18
+
+// `MAX_UNPADDED_LENGTH` is the length of the longest text of an integer
+// value of a range before it is padded, e.g. "-999999999999999999".
+const int MAX_UNPADDED_LENGTH = 19;
+
+// inline definitions
+// ------------------
+
+inline std::int64_t Range::value(int index) const {
+    return start + index * step;
+}
+
+inline int Range::maxLength() const {
+    if (letters) {
+        return 1;
+    }
+    return width > MAX_UNPADDED_LENGTH ? width : MAX_UNPADDED_LENGTH;
+}
+
+}  // namespace brex
+
+#endif
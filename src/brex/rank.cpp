@@ -0,0 +1,137 @@
+#include <brex/compile.h>
+#include <brex/rank.h>
+
+#include <algorithm>  // reverse, upper_bound
+#include <cassert>
+#include <utility>  // move
+
+namespace brex {
+
+// class Ranking
+// -------------
+
+Ranking::Ranking(const Program& program)
+: program(&program)
+, slotTerms(program.instructions.size())
+, branchOffsets(program.branches.size()) {
+    const auto& instructions = program.instructions;
+    const int   size         = instructions.size();
+
+    // The chains of a slot's branches always come before the slot's chain,
+    // so walking the instructions forwards visits every chain before any slot
+    // that refers to it.  `chainTerms` is indexed by the instruction index at
+    // which a chain begins.
+    std::vector<BigUnsigned> chainTerms(size);
+    BigUnsigned              product    = 1;
+    int                      chainBegin = 0;
+
+    for (int pc = 0; pc < size; ++pc) {
+        const Program::Instruction& instruction = instructions[pc];
+
+        switch (instruction.opcode) {
+            case Program::Opcode::LITERAL:
+                break;
+            case Program::Opcode::SLOT: {
+                BigUnsigned sum;
+                for (int i = 0; i < instruction.count; ++i) {
+                    const int branch      = instruction.first + i;
+                    branchOffsets[branch] = sum;
+                    sum += chainTerms[program.branches[branch]];
+                }
+                product *= sum;
+                slotTerms[pc] = std::move(sum);
+            } break;
+            case Program::Opcode::RANGE:
+                slotTerms[pc] = instruction.count;
+                product *= slotTerms[pc];
+                break;
+            default:
+                assert(instruction.opcode == Program::Opcode::RETURN);
+                // This is the end of a chain, so the chain is complete.
+                chainTerms[chainBegin] = std::move(product);
+                product                = 1;
+                chainBegin             = pc + 1;
+        }
+    }
+
+    total = chainTerms[program.root];
+}
+
+const BigUnsigned& Ranking::terms() const {
+    return total;
+}
+
+const BigUnsigned& Ranking::terms(int slot) const {
+    assert(program->instructions[slot].opcode == Program::Opcode::SLOT ||
+           program->instructions[slot].opcode == Program::Opcode::RANGE);
+    return slotTerms[slot];
+}
+
+void Ranking::unrank(std::vector<int>&   digits,
+                     const BigUnsigned& index) const {
+    assert(index < total);
+
+    const auto& instructions = program->instructions;
+
+    // Each pending element is a slot together with the index of the term
+    // within that slot's expansion.  The element on top of the stack is the
+    // next slot that the term passes through.
+    std::vector<std::pair<int, BigUnsigned>> pending;
+    BigUnsigned                              quotient;
+    BigUnsigned                              remainder;
+
+    // Push onto `pending` the slots of the chain beginning at the specified
+    // `pc` with the index of the term within each slot's expansion, given the
+    // specified `index` of the term within the chain's expansion.  A chain's
+    // expansion is the cross product of its slots' expansions, where the last
+    // slot is the least significant.
+    const auto decodeChain = [&](int pc, BigUnsigned index) {
+        const int mark = pending.size();
+
+        for (; instructions[pc].opcode != Program::Opcode::RETURN; ++pc) {
+            if (instructions[pc].opcode != Program::Opcode::LITERAL) {
+                pending.emplace_back(pc, BigUnsigned());
+            }
+        }
+
+        for (int i = int(pending.size()) - 1; i >= mark; --i) {
+            BigUnsigned::divide(
+                quotient, remainder, index, slotTerms[pending[i].first]);
+            pending[i].second = std::move(remainder);
+            index             = std::move(quotient);
+        }
+        assert(index.isZero());
+
+        std::reverse(pending.begin() + mark, pending.end());
+    };
+
+    digits.clear();
+    decodeChain(program->root, index);
+
+    while (!pending.empty()) {
+        const int   slot      = pending.back().first;
+        BigUnsigned remaining = std::move(pending.back().second);
+        pending.pop_back();
+
+        // A range's expansion is its values, so the index is the digit.
+        const Program::Instruction& instruction = instructions[slot];
+        if (instruction.opcode == Program::Opcode::RANGE) {
+            digits.push_back(int(remaining.toUint64()));
+            continue;
+        }
+
+        // Find the last branch that begins at or before `remaining`.  The
+        // slot's expansion is the concatenation of its branches' expansions.
+        const auto begin = branchOffsets.begin() + instruction.first;
+        const auto end   = begin + instruction.count;
+        const int  digit = std::upper_bound(begin, end, remaining) - begin - 1;
+        assert(digit >= 0);
+
+        remaining -= branchOffsets[instruction.first + digit];
+        digits.push_back(digit);
+        decodeChain(program->branches[instruction.first + digit],
+                    std::move(remaining));
+    }
+}
+
+}  // namespace brex
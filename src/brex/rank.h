@@ -0,0 +1,52 @@
+#ifndef INCLUDED_BREX_RANK
+#define INCLUDED_BREX_RANK
+
+#include <brex/bigunsigned.h>
+
+#include <vector>
+
+namespace brex {
+
+struct Program;
+
+// `Ranking` holds the number of terms produced by each part of a compiled
+// `Program` (see `compile.h`), so that the term at any position within the
+// expansion can be found directly, without enumerating the terms before it.
+class Ranking {
+    const Program* program;
+
+    // the number of terms of each `SLOT` and `RANGE` instruction, indexed by
+    // instruction index, and zero for the other instructions
+    std::vector<BigUnsigned> slotTerms;
+
+    // the number of terms of a slot that precede each of its branches,
+    // parallel to `program->branches`
+    std::vector<BigUnsigned> branchOffsets;
+
+    // the number of terms of the whole expansion
+    BigUnsigned total;
+
+  public:
+    // Create an object describing the specified `program`.  The behavior is
+    // undefined unless `program` outlives this object.
+    explicit Ranking(const Program& program);
+
+    // Return the number of terms of the whole expansion.
+    const BigUnsigned& terms() const;
+
+    // Return the number of terms of the `SLOT` or `RANGE` instruction at the
+    // specified instruction index `slot`.
+    const BigUnsigned& terms(int slot) const;
+
+    // Load into the specified `digits` the branch selected at each slot, and
+    // the value selected at each range, that the term at the specified
+    // zero-based `index` passes through, in the order in which the term
+    // passes through them.  The behavior is undefined
+    // unless `index` is less than `terms()`.  Note that the result is suitable
+    // for passing to `Odometer::seek`.
+    void unrank(std::vector<int>& digits, const BigUnsigned& index) const;
+};
+
+}  // namespace brex
+
+#endif
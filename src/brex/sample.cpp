@@ -0,0 +1,102 @@
+#include <brex/bigunsigned.h>
+#include <brex/odometer.h>
+#include <brex/rank.h>
+#include <brex/sample.h>
+#include <brex/sink.h>
+
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <utility>  // move
+
+namespace brex {
+
+BigUnsigned randomBelow(const BigUnsigned& bound, std::mt19937_64& generator) {
+    assert(!bound.isZero());
+
+    if (bound.fitsUint64()) {
+        std::uniform_int_distribution<std::uint64_t> distribution(
+            0, bound.toUint64() - 1);
+        return distribution(generator);
+    }
+
+    // Draw as many random bits as `bound` has, and try again if the result is
+    // too large.  Since the most significant bit of `bound` is set, each try
+    // succeeds with probability greater than one half.
+    const int           bits  = bound.bitLength();
+    const int           limbs = (bits + 31) / 32;
+    const BigUnsigned   radix = std::uint64_t(1) << 32;
+    const std::uint32_t topMask =
+        bits % 32 ? (std::uint32_t(1) << bits % 32) - 1 : ~std::uint32_t(0);
+
+    for (;;) {
+        BigUnsigned result;
+        for (int i = limbs - 1; i >= 0; --i) {
+            std::uint32_t limb = std::uint32_t(generator());
+            if (i == limbs - 1) {
+                limb &= topMask;
+            }
+            result *= radix;
+            result += limb;
+        }
+
+        if (result < bound) {
+            return result;
+        }
+    }
+}
+
+std::uint64_t expandSample(Sink&              sink,
+                           Odometer&          odometer,
+                           const Ranking&     ranking,
+                           std::size_t        count,
+                           bool               distinct,
+                           std::mt19937_64&   generator,
+                           const std::string& separator) {
+    const BigUnsigned& terms = ranking.terms();
+    assert(!terms.isZero());
+
+    if (!distinct) {
+        std::size_t i = 0;
+        for (; i < count && !sink.error(); ++i) {
+            if (i) {
+                sink.write(separator);
+            }
+            odometer.seek(ranking, randomBelow(terms, generator));
+            sink.write(odometer.current());
+        }
+        return i;
+    }
+
+    if (terms <= count) {
+        // Every term is chosen, so there's nothing to draw.
+        expand(sink, odometer, separator);
+        return terms.toUint64();
+    }
+
+    // For each `j` from `terms - count` up to `terms - 1`, add a random index
+    // up to and including `j`, or `j` itself if that index is already
+    // chosen.  Each set of `count` indices is equally likely.
+    std::set<BigUnsigned> chosen;
+    for (BigUnsigned j = terms - count; j < terms; j += 1) {
+        BigUnsigned index = randomBelow(j + 1, generator);
+        if (!chosen.insert(std::move(index)).second) {
+            chosen.insert(j);
+        }
+    }
+
+    std::uint64_t written = 0;
+    for (const BigUnsigned& index : chosen) {
+        if (sink.error()) {
+            break;
+        }
+        if (written++) {
+            sink.write(separator);
+        }
+        odometer.seek(ranking, index);
+        sink.write(odometer.current());
+    }
+    return written;
+}
+
+}  // namespace brex
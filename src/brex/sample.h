@@ -0,0 +1,51 @@
+#ifndef INCLUDED_BREX_SAMPLE
+#define INCLUDED_BREX_SAMPLE
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <random>
+#include <string>
+
+namespace brex {
+
+class BigUnsigned;
+class Odometer;
+class Ranking;
+class Sink;
+
+// Return an integer drawn uniformly from the range zero up to, but not
+// including, the specified `bound`, using the specified `generator`.  The
+// behavior is undefined if `bound` is zero.
+BigUnsigned randomBelow(const BigUnsigned& bound, std::mt19937_64& generator);
+
+// Append to the specified `sink` the specified `count` number of values of
+// the expansion drawn uniformly at random using the specified `generator`,
+// where each appended value is separated from the next by the specified
+// `separator`, and return the number of values appended.  If the specified
+// `distinct` is `false`, then the values are drawn independently, so they
+// may repeat, and are in the order drawn.  If `distinct` is `true`, then no
+// value repeats, the values are in the order of the expansion, and if
+// `count` is at least the number of terms, then the whole expansion is
+// appended.  Stop early if a write to `sink` fails.  Use the specified
+// `odometer` and the specified `ranking` of its program to find each value
+// directly (see `Odometer::seek`), so that the cost of each value depends on
+// the size of the program rather than on its index.  The behavior is
+// undefined unless `odometer` is at its first value, and unless `ranking`
+// was created from the same program as was `odometer`.
+//
+// Values drawn independently are written as they're drawn, so memory use
+// doesn't depend on `count`.  Distinct values fewer than the number of
+// terms are drawn using Robert Floyd's algorithm, which draws exactly
+// `count` random integers, however many of them collide, but must remember
+// each of them.
+std::uint64_t expandSample(Sink&              sink,
+                           Odometer&          odometer,
+                           const Ranking&     ranking,
+                           std::size_t        count,
+                           bool               distinct,
+                           std::mt19937_64&   generator,
+                           const std::string& separator);
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,105 @@
+#include <brex/scan.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BREX_SCAN_X86 1
+#include <immintrin.h>
+#else
+#define BREX_SCAN_X86 0
+#endif
+
+namespace brex {
+namespace {
+
+// `Finder` is the type of each implementation of `findNonLetter`.
+typedef const char* (*Finder)(const char* begin, const char* end);
+
+const char* findNonLetterScalar(const char* begin, const char* end) {
+    while (begin != end && isLetter(*begin)) {
+        ++begin;
+    }
+    return begin;
+}
+
+#if BREX_SCAN_X86
+
+// The vector implementations classify a block of bytes at once, as
+// `isLetter` does one byte at a time: after setting each byte's 0x20 bit,
+// the letters are exactly the bytes in the range ['a', 'z'].  There is no
+// unsigned byte comparison, so the bytes are shifted so that 'a' becomes the
+// smallest signed byte, -128.  Then a byte is a letter if and only if it is
+// less than -128 + 26.  Any bytes after the block are handled by the next
+// narrower implementation.
+
+__attribute__((target("sse2"))) const char* findNonLetterSse2(
+    const char* begin,
+    const char* end) {
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    const __m128i shift   = _mm_set1_epi8(char(128 - 'a'));
+    const __m128i bound   = _mm_set1_epi8(char(-128 + 26));
+
+    for (; end - begin >= 16; begin += 16) {
+        const __m128i bytes =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const __m128i shifted =
+            _mm_add_epi8(_mm_or_si128(bytes, caseBit), shift);
+        const unsigned letters =
+            _mm_movemask_epi8(_mm_cmplt_epi8(shifted, bound));
+
+        if (letters != 0xFFFF) {
+            return begin + __builtin_ctz(~letters);
+        }
+    }
+
+    return findNonLetterScalar(begin, end);
+}
+
+__attribute__((target("avx2"))) const char* findNonLetterAvx2(
+    const char* begin,
+    const char* end) {
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    const __m256i shift   = _mm256_set1_epi8(char(128 - 'a'));
+    const __m256i bound   = _mm256_set1_epi8(char(-128 + 26));
+
+    for (; end - begin >= 32; begin += 32) {
+        const __m256i bytes =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        const __m256i shifted =
+            _mm256_add_epi8(_mm256_or_si256(bytes, caseBit), shift);
+        // `cmpgt(bound, shifted)` is `shifted < bound`.
+        const unsigned letters =
+            _mm256_movemask_epi8(_mm256_cmpgt_epi8(bound, shifted));
+
+        if (letters != 0xFFFFFFFF) {
+            return begin + __builtin_ctz(~letters);
+        }
+    }
+
+    return findNonLetterSse2(begin, end);
+}
+
+#endif
+
+// Return the fastest implementation of `findNonLetter` that the processor
+// supports.
+Finder chooseFinder() {
+#if BREX_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return findNonLetterAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return findNonLetterSse2;
+    }
+#endif
+    return findNonLetterScalar;
+}
+
+const Finder finder = chooseFinder();
+
+}  // namespace
+
+const char* findNonLetter(const char* begin, const char* end) {
+    return finder(begin, end);
+}
+
+}  // namespace brex
@@ -0,0 +1,30 @@
+#ifndef INCLUDED_BREX_SCAN
+#define INCLUDED_BREX_SCAN
+
+namespace brex {
+
+// Return whether the specified `ch` is an upper or lower case English letter.
+// Unlike `std::isalpha`, the result does not depend on the locale.
+bool isLetter(char ch);
+
+// Return a pointer to the first character in the specified range
+// `[begin, end)` that is not an upper or lower case English letter, or return
+// `end` if there is no such character.
+//
+// Where the processor supports it, the range is examined 16 or 32 bytes at a
+// time using SIMD instructions.  The implementation is chosen at runtime: AVX2
+// if available, otherwise SSE2 on x86, otherwise portable scalar code.
+const char* findNonLetter(const char* begin, const char* end);
+
+// inline definitions
+// ------------------
+
+inline bool isLetter(char ch) {
+    // Setting the 0x20 bit maps upper case ASCII letters onto lower case, and
+    // maps nothing else onto a lower case letter.
+    return unsigned((ch | 0x20) - 'a') <= 'z' - 'a';
+}
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,436 @@
+#include <brex/arena.h>
+#include <brex/odometer.h>
+#include <brex/serve.h>
+#include <brex/sink.h>
+#include <brex/terms.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>  // memcpy
+#include <ostream>
+#include <system_error>
+#include <thread>
+#include <utility>  // move
+#include <vector>
+
+#include <signal.h>       // signal, SIGPIPE, SIG_IGN
+#include <sys/epoll.h>    // epoll_create1, epoll_ctl, epoll_wait
+#include <sys/eventfd.h>  // eventfd
+#include <sys/socket.h>   // accept4, bind, listen, recv, setsockopt, socket
+#include <sys/time.h>     // timeval
+#include <sys/stat.h>     // lstat, S_ISSOCK
+#include <sys/un.h>       // sockaddr_un
+#include <unistd.h>       // close, unlink, write
+
+namespace brex {
+namespace {
+
+// how many bytes a worker reads from a connection at a time
+const std::size_t READ_SIZE = 1 << 16;
+
+// how many seconds a write to a connection may wait for the client to make
+// room, after which the connection is dropped
+const int SEND_TIMEOUT = 10;
+
+}  // namespace
+
+// class ProgramCache
+// ------------------
+
+const std::size_t ProgramCache::DEFAULT_CAPACITY;
+
+ProgramCache::ProgramCache(std::size_t capacity)
+: capacity(capacity)
+, hitCount(0)
+, missCount(0) {
+}
+
+std::shared_ptr<const CompiledExpression> ProgramCache::find(
+    const std::string& expression) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto found = index.find(expression);
+    if (found == index.end()) {
+        ++missCount;
+        return nullptr;
+    }
+
+    ++hitCount;
+    recency.splice(recency.begin(), recency, found->second.position);
+    return found->second.value;
+}
+
+void ProgramCache::insert(const std::string&                        expression,
+                          std::shared_ptr<const CompiledExpression> value) {
+    if (capacity == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto inserted = index.emplace(expression, Entry());
+    Entry&     entry    = inserted.first->second;
+    entry.value         = std::move(value);
+    if (inserted.second) {
+        recency.push_front(&inserted.first->first);
+        entry.position = recency.begin();
+    }
+    else {
+        recency.splice(recency.begin(), recency, entry.position);
+    }
+
+    if (index.size() > capacity) {
+        index.erase(index.find(*recency.back()));
+        recency.pop_back();
+    }
+}
+
+std::uint64_t ProgramCache::hits() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hitCount;
+}
+
+std::uint64_t ProgramCache::misses() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return missCount;
+}
+
+// class Server
+// ------------
+
+const std::size_t Server::DEFAULT_BUFFER_SIZE;
+const std::size_t Server::MAX_LINE_SIZE;
+
+struct Server::Connection {
+    int         fileDescriptor;
+    Sink        sink;
+    std::string pending;  // bytes received since the last newline
+
+    Connection(int fileDescriptor, std::size_t bufferSize)
+    : fileDescriptor(fileDescriptor)
+    , sink(fileDescriptor, bufferSize) {
+    }
+};
+
+// `Scratch` is the storage that a worker reuses from one request to the next.
+struct Server::Scratch {
+    Arena                   arena;
+    ParseTreeNode           tree;
+    std::string             line;
+    std::unique_ptr<char[]> input;
+
+    Scratch()
+    : input(new char[READ_SIZE]) {
+    }
+};
+
+Server::Server(ProgramCache& cache,
+               std::uint64_t limit,
+               std::size_t   bufferSize)
+: cache(cache)
+, limit(limit)
+, bufferSize(bufferSize)
+, listener(-1)
+, poller(-1)
+, wakeup(-1) {
+    assert(limit > 0);
+    assert(bufferSize > 0);
+}
+
+Server::~Server() {
+    for (Connection* connection : connections) {
+        const int fileDescriptor = connection->fileDescriptor;
+        delete connection;
+        ::close(fileDescriptor);
+    }
+
+    for (const int fileDescriptor : {listener, poller, wakeup}) {
+        if (fileDescriptor != -1) {
+            ::close(fileDescriptor);
+        }
+    }
+
+    if (!path.empty()) {
+        ::unlink(path.c_str());
+    }
+}
+
+int Server::open(const std::string& socketPath, std::ostream* errors) {
+    // Return a nonzero value, having written a diagnostic mentioning the
+    // specified `what` and the current `errno`.
+    const auto fail = [&](const char* what) {
+        if (errors) {
+            *errors << "Unable to " << what << " for the socket "
+                    << socketPath << " (errno " << errno << ").\n";
+        }
+        return 1;
+    };
+
+    struct sockaddr_un address = {};
+    address.sun_family         = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof address.sun_path) {
+        errno = ENAMETOOLONG;
+        return fail("use the path");
+    }
+    std::memcpy(address.sun_path, socketPath.data(), socketPath.size());
+
+    listener =
+        ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listener == -1) {
+        return fail("create a socket");
+    }
+
+    // A socket left behind by a previous server would make `bind` fail.
+    struct stat status;
+    if (::lstat(socketPath.c_str(), &status) == 0 &&
+        S_ISSOCK(status.st_mode)) {
+        ::unlink(socketPath.c_str());
+    }
+
+    if (::bind(listener,
+               reinterpret_cast<const struct sockaddr*>(&address),
+               sizeof address)) {
+        return fail("bind");
+    }
+    path = socketPath;
+
+    if (::listen(listener, SOMAXCONN)) {
+        return fail("listen");
+    }
+
+    poller = ::epoll_create1(EPOLL_CLOEXEC);
+    if (poller == -1) {
+        return fail("create an epoll instance");
+    }
+
+    wakeup = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeup == -1) {
+        return fail("create an eventfd");
+    }
+
+    // `wakeup` is level triggered, so once signaled, it wakes every worker.
+    // `listener` is armed for one event at a time, and is rearmed by the
+    // worker that accepts its connections.
+    struct epoll_event event = {};
+    event.events             = EPOLLIN;
+    event.data.ptr           = &wakeup;
+    if (::epoll_ctl(poller, EPOLL_CTL_ADD, wakeup, &event)) {
+        return fail("watch the eventfd");
+    }
+
+    event.events   = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = &listener;
+    if (::epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event)) {
+        return fail("watch the socket");
+    }
+
+    ::signal(SIGPIPE, SIG_IGN);
+    return 0;
+}
+
+void Server::run(int threads) {
+    assert(threads > 0);
+
+    // If the system won't start as many workers as were asked for, those
+    // that it did start, if any, serve alongside the calling thread.
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) {
+        try {
+            workers.emplace_back(&Server::work, this);
+        }
+        catch (const std::system_error&) {
+            break;
+        }
+    }
+
+    // The calling thread is a worker, too.
+    work();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void Server::stop() {
+    const std::uint64_t one = 1;
+    const ssize_t       rc  = ::write(wakeup, &one, sizeof one);
+    (void)rc;  // The counter can't overflow from this alone.
+}
+
+void Server::accept() {
+    for (;;) {
+        const int fileDescriptor =
+            ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fileDescriptor == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return;  // e.g. `EAGAIN` when there are no more
+        }
+
+        // Connections are written to in blocking mode, but a client that
+        // stops reading mustn't keep a worker forever.
+        struct timeval timeout = {};
+        timeout.tv_sec         = SEND_TIMEOUT;
+        ::setsockopt(fileDescriptor,
+                     SOL_SOCKET,
+                     SO_SNDTIMEO,
+                     &timeout,
+                     sizeof timeout);
+
+        Connection* const connection =
+            new Connection(fileDescriptor, bufferSize);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            connections.insert(connection);
+        }
+
+        struct epoll_event event = {};
+        event.events             = EPOLLIN | EPOLLONESHOT;
+        event.data.ptr           = connection;
+        if (::epoll_ctl(poller, EPOLL_CTL_ADD, fileDescriptor, &event)) {
+            close(connection);
+        }
+    }
+}
+
+void Server::respond(Sink&              sink,
+                     const std::string& expression,
+                     Scratch&           scratch) {
+    std::shared_ptr<const CompiledExpression> compiled =
+        cache.find(expression);
+
+    if (!compiled) {
+        const std::shared_ptr<CompiledExpression> fresh =
+            std::make_shared<CompiledExpression>();
+
+        scratch.arena.reset();
+        fresh->result =
+            parse(scratch.tree, scratch.arena, expression, nullptr);
+        if (fresh->result == ParseResult::SUCCESS) {
+            compile(fresh->program, scratch.tree);
+        }
+
+        cache.insert(expression, fresh);
+        compiled = fresh;
+    }
+
+    // Each record is as written by `expandBatch`.
+    sink.write(std::to_string(int(compiled->result)));
+    sink.write("\n", 1);
+
+    if (compiled->result == ParseResult::SUCCESS) {
+        // Once a write fails, e.g. because the client has disconnected,
+        // `sink` discards everything, so stop expanding then rather than
+        // after the last term, which might never come.
+        Odometer      odometer(compiled->program);
+        std::uint64_t written = 0;
+        forEachTerm(odometer, [&](const char* data, std::size_t size) {
+            sink.write(data, size);
+            sink.write("\n", 1);
+            return ++written < limit && !sink.error();
+        });
+    }
+
+    sink.write("\n", 1);
+}
+
+bool Server::serve(Connection& connection, Scratch& scratch) {
+    ssize_t received;
+    do {
+        received = ::recv(connection.fileDescriptor,
+                          scratch.input.get(),
+                          READ_SIZE,
+                          MSG_DONTWAIT);
+    } while (received < 0 && errno == EINTR);
+
+    if (received < 0) {
+        // Nothing has arrived after all, or the connection failed.
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    // As with `std::getline`, the last line needn't end with a newline.
+    std::string& pending = connection.pending;
+    pending.append(scratch.input.get(), received);
+    if (received == 0 && !pending.empty()) {
+        pending.push_back('\n');
+    }
+
+    std::size_t begin = 0;
+    std::size_t end;
+    while ((end = pending.find('\n', begin)) != std::string::npos &&
+           !connection.sink.error()) {
+        scratch.line.assign(pending, begin, end - begin);
+        respond(connection.sink, scratch.line, scratch);
+        begin = end + 1;
+    }
+    pending.erase(0, begin);
+
+    // Rather than buffer a line without end, answer it as `expandBatch`
+    // would answer input too large to parse, and hang up.
+    if (pending.size() > MAX_LINE_SIZE && !connection.sink.error()) {
+        pending.clear();
+        connection.sink.write(
+            std::to_string(int(ParseResult::INPUT_TOO_LARGE)));
+        connection.sink.write("\n\n", 2);
+        connection.sink.flush();
+        return false;
+    }
+
+    // As in `expandBatch`, the output is flushed once the input runs out,
+    // which here is whenever a read has been answered.
+    return connection.sink.flush() == 0 && received != 0;
+}
+
+void Server::close(Connection* connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        connections.erase(connection);
+    }
+    // The connection's `Sink` flushes when it's destroyed, so the socket
+    // outlives it.
+    const int fileDescriptor = connection->fileDescriptor;
+    delete connection;
+    ::close(fileDescriptor);
+}
+
+void Server::work() {
+    Scratch scratch;
+
+    for (;;) {
+        struct epoll_event event;
+        const int          count = ::epoll_wait(poller, &event, 1, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        if (event.data.ptr == &wakeup) {
+            return;
+        }
+
+        if (event.data.ptr == &listener) {
+            accept();
+            event.events = EPOLLIN | EPOLLONESHOT;
+            ::epoll_ctl(poller, EPOLL_CTL_MOD, listener, &event);
+            continue;
+        }
+
+        Connection* const connection =
+            static_cast<Connection*>(event.data.ptr);
+        if (!serve(*connection, scratch)) {
+            close(connection);
+            continue;
+        }
+
+        event.events = EPOLLIN | EPOLLONESHOT;
+        if (::epoll_ctl(
+                poller, EPOLL_CTL_MOD, connection->fileDescriptor, &event)) {
+            close(connection);
+        }
+    }
+}
+
+}  // namespace brex
@@ -0,0 +1,179 @@
+#ifndef INCLUDED_BREX_SERVE
+#define INCLUDED_BREX_SERVE
+
+#include <brex/compile.h>
+#include <brex/parse.h>
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <iosfwd>   // ostream*
+#include <list>
+#include <memory>  // shared_ptr
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace brex {
+
+class Sink;
+
+// `CompiledExpression` is the outcome of parsing and compiling one
+// expression: its `ParseResult`, and if the expression is valid, its
+// `Program`.
+struct CompiledExpression {
+    ParseResult result;
+    Program     program;  // empty unless `result` is `SUCCESS`
+};
+
+// `ProgramCache` is a thread-safe cache of `CompiledExpression` objects keyed
+// by the text of the expression.  When it is full, the least recently used
+// entry is evicted to make room for a new one.  Entries are immutable and
+// shared, so an entry evicted while a thread is still expanding its program
+// lives on until that thread lets go of it.
+class ProgramCache {
+    // Each key appears once, in `index`.  `recency` points to the keys, most
+    // recently used first.
+    struct Entry {
+        std::shared_ptr<const CompiledExpression> value;
+        std::list<const std::string*>::iterator   position;
+    };
+
+    std::size_t                            capacity;
+    std::mutex                             mutex;
+    std::unordered_map<std::string, Entry> index;
+    std::list<const std::string*>          recency;
+    std::uint64_t                          hitCount;
+    std::uint64_t                          missCount;
+
+  public:
+    // the number of entries kept when no capacity is specified
+    static const std::size_t DEFAULT_CAPACITY = 4096;
+
+    // Create an empty cache that holds at most the specified `capacity`
+    // number of entries.  If `capacity` is zero, then nothing is cached.
+    explicit ProgramCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    // Return the entry for the specified `expression`, and mark it as the
+    // most recently used, or return null if there is no such entry.
+    std::shared_ptr<const CompiledExpression> find(
+        const std::string& expression);
+
+    // Add the specified `value` as the entry for the specified `expression`,
+    // replacing any existing entry, and evict the least recently used entry
+    // if there are then more than the capacity.
+    void insert(const std::string&                        expression,
+                std::shared_ptr<const CompiledExpression> value);
+
+    // Return how many calls to `find` returned an entry.
+    std::uint64_t hits();
+
+    // Return how many calls to `find` returned null.
+    std::uint64_t misses();
+};
+
+// `Server` answers requests to expand shell brace expressions that arrive on
+// a Unix domain socket.  A client connects, writes expressions one per line,
+// and reads back a record for each, in order, in the format of
+// `expandBatch` (see `batch.h`).  A client may write any number of
+// expressions before reading, and may keep its connection open for as long
+// as it likes.
+//
+// Connections are served by a pool of worker threads that wait together on
+// one `epoll` instance.  A worker that is woken by a connection reads what
+// has arrived, writes the records of the complete lines, and then returns
+// the connection to the pool, so an idle connection occupies no thread and a
+// few threads can serve many clients.  Each connection has a `Sink` of its
+// own, which is the only output buffered for it: a client that doesn't read
+// its records holds up the worker writing them, rather than growing a
+// buffer, but only for a few seconds, after which the connection is dropped.
+// A worker stops expanding as soon as a write to its client fails.  Input is
+// bounded, too: a line may be at most `MAX_LINE_SIZE` bytes long.
+//
+// Expressions are looked up in a `ProgramCache` before being parsed and
+// compiled, so an expression that was seen recently costs only its
+// expansion.
+class Server {
+    struct Connection;
+    struct Scratch;
+
+    ProgramCache& cache;
+    std::uint64_t limit;
+    std::size_t   bufferSize;
+    std::string   path;      // of the socket, once bound
+    int           listener;  // the listening socket, or -1
+    int           poller;    // the `epoll` instance, or -1
+    int           wakeup;    // an `eventfd` that `stop` signals, or -1
+
+    std::mutex                      mutex;
+    std::unordered_set<Connection*> connections;  // all that are open
+
+    // Accept every pending connection.
+    void accept();
+
+    // Append to the specified `sink` the record of the specified
+    // `expression`, using the specified `scratch` storage to compile it if
+    // it isn't in the cache.
+    void respond(Sink&              sink,
+                 const std::string& expression,
+                 Scratch&           scratch);
+
+    // Serve what has arrived on the specified `connection`, using the
+    // specified `scratch` storage.  Return whether the connection remains
+    // open.
+    bool serve(Connection& connection, Scratch& scratch);
+
+    // Close the specified `connection` and destroy it.
+    void close(Connection* connection);
+
+    // Wait for and serve events until `stop` is called.  This is the body of
+    // each worker thread.
+    void work();
+
+  public:
+    // the capacity of each connection's `Sink` when none is specified
+    static const std::size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+    // the most bytes of an incomplete line that are kept for a connection.
+    // A client whose line grows longer is sent a record with the status
+    // `ParseResult::INPUT_TOO_LARGE`, and is disconnected.
+    static const std::size_t MAX_LINE_SIZE = 1 << 24;
+
+    // Create a server that looks up expressions in the specified `cache`,
+    // writes at most the specified `limit` number of terms per expression,
+    // and buffers at most the specified `bufferSize` bytes of output per
+    // connection.  The behavior is undefined if `limit` or `bufferSize` is
+    // zero.
+    Server(ProgramCache& cache, std::uint64_t limit, std::size_t bufferSize);
+
+    // Close all connections and the socket, and remove the socket's file.
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // Create a Unix domain socket at the specified `path` and listen on it.
+    // If a socket already exists at `path`, it is replaced, but any other
+    // kind of file is left alone.  Writing to a client that has disconnected
+    // must not kill the process, so `SIGPIPE` is ignored from now on.  Return
+    // zero on success, or a nonzero value otherwise, in which case write a
+    // diagnostic to the specified `errors` if it is not null.
+    int open(const std::string& path, std::ostream* errors);
+
+    // Serve connections using the specified `threads` number of worker
+    // threads, counting the calling thread, or as many as the system will
+    // start, until `stop` is called, and then return.  The behavior is
+    // undefined unless `open` succeeded and `threads` is positive.
+    void run(int threads);
+
+    // Make `run` return once each worker has finished what it's doing.  This
+    // may be called from any thread, or from a signal handler.
+    void stop();
+};
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,126 @@
+#include <brex/sink.h>
+
+#include <cassert>
+#include <cerrno>
+
+#include <sys/uio.h>  // writev
+#include <unistd.h>   // write
+
+namespace brex {
+namespace {
+
+// Write to the specified `fileDescriptor` the specified `count` buffers
+// described by `vectors`, retrying after partial writes and interruptions.
+// Return zero on success or an `errno` value otherwise.  Note that `vectors`
+// is modified.
+int writeAll(int fileDescriptor, struct iovec* vectors, int count) {
+    while (count != 0) {
+        const ssize_t rc = ::writev(fileDescriptor, vectors, count);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+
+        // Skip past the buffers that were written completely, and then past
+        // whatever was written of the next one.
+        std::size_t written = rc;
+        while (count != 0 && written >= vectors->iov_len) {
+            written -= vectors->iov_len;
+            ++vectors;
+            --count;
+        }
+        if (count != 0) {
+            vectors->iov_base =
+                static_cast<char*>(vectors->iov_base) + written;
+            vectors->iov_len -= written;
+        }
+    }
+
+    return 0;
+}
+
+}  // namespace
+
+// class Sink
+// ----------
+
+const std::size_t Sink::DEFAULT_CAPACITY;
+
+void Sink::writeThrough(const char* data, std::size_t size) {
+    struct iovec vectors[2];
+    int          count = 0;
+
+    if (used != 0) {
+        vectors[count].iov_base = buffer.get();
+        vectors[count].iov_len  = used;
+        ++count;
+    }
+    if (size != 0) {
+        vectors[count].iov_base = const_cast<char*>(data);
+        vectors[count].iov_len  = size;
+        ++count;
+    }
+
+    const std::size_t total = used + size;
+    used                    = 0;
+    if (errorNumber == 0) {
+        errorNumber = writeAll(fileDescriptor, vectors, count);
+        if (errorNumber == 0) {
+            written += total;
+        }
+    }
+}
+
+void Sink::overflow(const char* data, std::size_t size) {
+    assert(size > capacity - used);
+
+    if (size >= capacity / 2) {
+        // Copying `data` would cost more than it saves.  Send it along with
+        // whatever is already buffered.
+        writeThrough(data, size);
+        return;
+    }
+
+    // Top off the buffer, write it, and buffer the rest.
+    const std::size_t room = capacity - used;
+    std::memcpy(buffer.get() + used, data, room);
+    used = capacity;
+    writeThrough(nullptr, 0);
+
+    std::memcpy(buffer.get(), data + room, size - room);
+    used = size - room;
+}
+
+Sink::Sink(int fileDescriptor, std::size_t capacity)
+: fileDescriptor(fileDescriptor)
+, buffer(new char[capacity])
+, capacity(capacity)
+, used(0)
+, errorNumber(0)
+, written(0) {
+    assert(capacity != 0);
+}
+
+Sink::~Sink() {
+    flush();
+}
+
+int Sink::flush() {
+    if (used != 0) {
+        writeThrough(nullptr, 0);
+    }
+
+    return errorNumber;
+}
+
+int Sink::error() const {
+    return errorNumber;
+}
+
+std::uint64_t Sink::bytesWritten() const {
+    return written;
+}
+
+}  // namespace brex
@@ -0,0 +1,89 @@
+#ifndef INCLUDED_BREX_SINK
+#define INCLUDED_BREX_SINK
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <cstring>  // memcpy
+#include <memory>   // unique_ptr
+#include <string>
+
+namespace brex {
+
+// `Sink` is an output buffer that writes directly to a file descriptor using
+// `write(2)` and `writev(2)`, bypassing iostreams altogether.  Small writes
+// are copied into a large user-space buffer, which is flushed when full.
+// Writes too large to be worth copying are sent to the file descriptor
+// together with the buffer's contents in a single `writev(2)` call.
+//
+// If a write to the file descriptor fails, then the error is remembered (see
+// `error()`) and subsequent output is discarded.
+class Sink {
+    int                     fileDescriptor;
+    std::unique_ptr<char[]> buffer;
+    std::size_t             capacity;
+    std::size_t             used;
+    int                     errorNumber;
+    std::uint64_t           written;  // see `bytesWritten()`
+
+    // Write to the file descriptor the contents of the buffer followed by the
+    // specified `size` bytes at the specified `data`, and empty the buffer.
+    void writeThrough(const char* data, std::size_t size);
+
+    // Append the specified `size` bytes at the specified `data`, where there
+    // is not room for them in the buffer.
+    void overflow(const char* data, std::size_t size);
+
+  public:
+    // the buffer capacity, in bytes, used when none is specified
+    static const std::size_t DEFAULT_CAPACITY = 1 << 20;
+
+    // Create an object that writes to the specified `fileDescriptor` using a
+    // buffer having the optionally specified `capacity` in bytes.  The
+    // behavior is undefined if `capacity` is zero.
+    explicit Sink(int fileDescriptor, std::size_t capacity = DEFAULT_CAPACITY);
+
+    // Flush this object and destroy it.
+    ~Sink();
+
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+
+    // Append the specified `size` bytes at the specified `data` to the output.
+    void write(const char* data, std::size_t size);
+
+    // Append the specified `data` to the output.
+    void write(const std::string& data);
+
+    // Write any buffered output to the file descriptor.  Return zero on
+    // success or the `errno` value of the first failed write otherwise.
+    int flush();
+
+    // Return zero if no write has failed, or the `errno` value of the first
+    // failed write otherwise.
+    int error() const;
+
+    // Return the number of bytes successfully written to the file descriptor
+    // so far, not counting any that are still buffered.
+    std::uint64_t bytesWritten() const;
+};
+
+// inline definitions
+// ------------------
+
+inline void Sink::write(const char* data, std::size_t size) {
+    if (size <= capacity - used) {
+        std::memcpy(buffer.get() + used, data, size);
+        used += size;
+    }
+    else {
+        overflow(data, size);
+    }
+}
+
+inline void Sink::write(const std::string& data) {
+    write(data.data(), data.size());
+}
+
+}  // namespace brex
+
+#endif
@@ -0,0 +1,170 @@
+#include <brex/parse.h>
+#include <brex/stats.h>
+
+#include <ostream>
+#include <utility>  // pair
+#include <vector>
+
+#include <sys/resource.h>  // getrusage
+
+namespace brex {
+namespace {
+
+// Insert into the specified `stream` a JSON object describing the specified
+// `phase`.
+void printPhase(std::ostream& stream, const Stats::Phase& phase) {
+    stream << "{\"wall\": " << phase.wallSeconds
+           << ", \"cpu\": " << phase.cpuSeconds << "}";
+}
+
+}  // namespace
+
+// struct Stats
+// ------------
+
+Stats::Stats()
+: read()
+, parse()
+, build()
+, expand()
+, strings(0)
+, sequences(0)
+, alternations(0)
+, ranges(0)
+, depth(0)
+, bytes(0)
+, arenaBlocks(0)
+, arenaBytes(0)
+, peakResidentKilobytes(0) {
+}
+
+// class Stopwatch
+// ---------------
+
+Stopwatch::Stopwatch()
+: wallStart(std::chrono::steady_clock::now())
+, cpuStart(std::clock()) {
+}
+
+void Stopwatch::lap(Stats::Phase& phase) {
+    const auto         wallNow = std::chrono::steady_clock::now();
+    const std::clock_t cpuNow  = std::clock();
+
+    const std::chrono::duration<double> wall = wallNow - wallStart;
+    phase.wallSeconds                        = wall.count();
+    phase.cpuSeconds = double(cpuNow - cpuStart) / CLOCKS_PER_SEC;
+
+    wallStart = wallNow;
+    cpuStart  = cpuNow;
+}
+
+// class CountingStreamBuffer
+// --------------------------
+
+CountingStreamBuffer::CountingStreamBuffer(std::streambuf* destination)
+: destination(destination)
+, count(0) {
+}
+
+CountingStreamBuffer::int_type CountingStreamBuffer::overflow(
+    int_type character) {
+    if (traits_type::eq_int_type(character, traits_type::eof())) {
+        return traits_type::not_eof(character);
+    }
+
+    const int_type result = destination->sputc(character);
+    if (!traits_type::eq_int_type(result, traits_type::eof())) {
+        ++count;
+    }
+    return result;
+}
+
+std::streamsize CountingStreamBuffer::xsputn(const char*     data,
+                                             std::streamsize size) {
+    const std::streamsize result = destination->sputn(data, size);
+    count += result;
+    return result;
+}
+
+int CountingStreamBuffer::sync() {
+    return destination->pubsync();
+}
+
+std::uint64_t CountingStreamBuffer::bytes() const {
+    return count;
+}
+
+// free functions
+// --------------
+
+void countNodes(Stats& stats, const ParseTreeNode& root) {
+    // As in `treeDepth`, walk the tree using an explicit stack.  Each element
+    // is a node and its depth.
+    std::vector<std::pair<const ParseTreeNode*, int>> stack;
+
+    stats.strings      = 0;
+    stats.sequences    = 0;
+    stats.alternations = 0;
+    stats.ranges       = 0;
+    stats.depth        = 0;
+
+    stack.emplace_back(&root, 1);
+    while (!stack.empty()) {
+        const ParseTreeNode& node  = *stack.back().first;
+        const int            depth = stack.back().second;
+        stack.pop_back();
+
+        switch (node.type) {
+            case ParseTreeNode::Type::STRING:
+                ++stats.strings;
+                break;
+            case ParseTreeNode::Type::SEQUENCE:
+                ++stats.sequences;
+                break;
+            case ParseTreeNode::Type::RANGE:
+                ++stats.ranges;
+                break;
+            default:
+                ++stats.alternations;
+        }
+
+        if (depth > stats.depth) {
+            stats.depth = depth;
+        }
+        for (int i = 0; i < node.childCount; ++i) {
+            stack.emplace_back(&node.children[i], depth + 1);
+        }
+    }
+}
+
+long peakResidentKilobytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return -1;
+    }
+    return usage.ru_maxrss;  // in kilobytes on Linux
+}
+
+void printStats(std::ostream& stream, const Stats& stats) {
+    stream << "{\"phases\": {\"read\": ";
+    printPhase(stream, stats.read);
+    stream << ", \"parse\": ";
+    printPhase(stream, stats.parse);
+    stream << ", \"build\": ";
+    printPhase(stream, stats.build);
+    stream << ", \"expand\": ";
+    printPhase(stream, stats.expand);
+
+    stream << "}, \"nodes\": {\"string\": " << stats.strings
+           << ", \"sequence\": " << stats.sequences
+           << ", \"alternation\": " << stats.alternations
+           << ", \"range\": " << stats.ranges
+           << "}, \"depth\": " << stats.depth << ", \"terms\": " << stats.terms
+           << ", \"bytes\": " << stats.bytes
+           << ", \"arena\": {\"blocks\": " << stats.arenaBlocks
+           << ", \"bytes\": " << stats.arenaBytes
+           << "}, \"peakRssKilobytes\": " << stats.peakResidentKilobytes
+           << "}\n";
+}
+
+}  // namespace brex
@@ -0,0 +1,101 @@
+#ifndef INCLUDED_BREX_STATS
+#define INCLUDED_BREX_STATS
+
+#include <brex/bigunsigned.h>
+
+#include <chrono>
+#include <cstdint>  // uint64_t
+#include <ctime>    // clock_t
+#include <iosfwd>   // ostream&
+#include <streambuf>
+
+namespace brex {
+
+struct ParseTreeNode;
+
+// `Stats` describes one run of brex: where the time went, what the parse
+// tree looked like, and how much was produced.  Nothing here is collected
+// unless asked for, so a program that doesn't want statistics pays nothing
+// for them.  The command line tool fills one in for `--stats`, but a program
+// that embeds brex can fill in whichever parts it likes.
+struct Stats {
+    // `Phase` is the time taken by one phase of a run.
+    struct Phase {
+        double wallSeconds;  // elapsed real time
+        double cpuSeconds;   // processor time used by every thread
+    };
+
+    Phase read;    // reading the expression
+    Phase parse;   // parsing it
+    Phase build;   // compiling it, or assembling the `Expander` tree
+    Phase expand;  // expanding it and writing the output
+
+    std::uint64_t strings;       // parse tree nodes of each type
+    std::uint64_t sequences;
+    std::uint64_t alternations;
+    std::uint64_t ranges;
+    int           depth;         // see `treeDepth` in `parse.h`
+
+    BigUnsigned   terms;         // how many terms were written
+    std::uint64_t bytes;         // how many bytes were written
+
+    std::uint64_t arenaBlocks;   // blocks allocated by the `Arena`
+    std::uint64_t arenaBytes;    // total size of those blocks
+    long          peakResidentKilobytes;  // the process's peak RSS
+
+    // Create an object having all zero values.
+    Stats();
+};
+
+// `Stopwatch` measures consecutive phases of a run.
+class Stopwatch {
+    std::chrono::steady_clock::time_point wallStart;
+    std::clock_t                          cpuStart;
+
+  public:
+    // Create a stopwatch that starts now.
+    Stopwatch();
+
+    // Store into the specified `phase` the time since this stopwatch started
+    // or last stopped a phase, whichever is more recent, and start timing
+    // the next phase.
+    void lap(Stats::Phase& phase);
+};
+
+// `CountingStreamBuffer` is a stream buffer that passes its output along to
+// another stream buffer, counting the bytes as it goes.  Since it buffers
+// nothing of its own, each insertion costs a virtual call, so install it
+// only when the count is wanted.
+class CountingStreamBuffer : public std::streambuf {
+    std::streambuf* destination;
+    std::uint64_t   count;
+
+  protected:
+    int_type        overflow(int_type character) override;
+    std::streamsize xsputn(const char* data, std::streamsize size) override;
+    int             sync() override;
+
+  public:
+    // Create an object that writes to the specified `destination`.  The
+    // behavior is undefined unless `destination` outlives this object.
+    explicit CountingStreamBuffer(std::streambuf* destination);
+
+    // Return the number of bytes passed along to the destination so far.
+    std::uint64_t bytes() const;
+};
+
+// Load into the node counts and depth of the specified `stats` those of the
+// parse tree rooted at the specified `root`.
+void countNodes(Stats& stats, const ParseTreeNode& root);
+
+// Return the peak resident set size of this process so far, in kilobytes, or
+// -1 if it's unknown.
+long peakResidentKilobytes();
+
+// Insert into the specified `stream` a JSON representation of the specified
+// `stats`, followed by a newline.
+void printStats(std::ostream& stream, const Stats& stats);
+
+}  // namespace brex
+
+#endif
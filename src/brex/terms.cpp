@@ -0,0 +1,33 @@
+#include <brex/terms.h>
+
+namespace brex {
+
+Expansion::Expansion()
+: valid(false) {
+}
+
+ParseResult Expansion::assign(const std::string& expression,
+                              std::ostream*      errors) {
+    // The parse tree refers to the input rather than copying it, so the
+    // input is kept alongside the tree.
+    input = expression;
+    arena.reset();
+
+    const ParseResult result = parse(tree, arena, input, errors);
+    valid                    = result == ParseResult::SUCCESS;
+    if (!valid) {
+        return result;
+    }
+
+    compile(program, tree);
+    if (cursor) {
+        cursor->reset();
+    }
+    else {
+        cursor.reset(new Odometer(program));
+    }
+
+    return result;
+}
+
+}  // namespace brex
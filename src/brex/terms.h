@@ -0,0 +1,210 @@
+#ifndef INCLUDED_BREX_TERMS
+#define INCLUDED_BREX_TERMS
+
+#include <brex/arena.h>
+#include <brex/compile.h>
+#include <brex/odometer.h>
+#include <brex/parse.h>
+
+#include <cstddef>   // size_t, ptrdiff_t
+#include <cstdint>   // uint64_t
+#include <iosfwd>    // ostream*
+#include <iterator>  // input_iterator_tag
+#include <memory>    // unique_ptr
+#include <string>
+#include <utility>   // forward
+
+namespace brex {
+
+// `Term` is a view of one term of an expansion.  It refers to storage within
+// the object that produced it, and so is invalidated when that object
+// advances to the next term.
+struct Term {
+    const char* data;
+    std::size_t size;
+};
+
+// `TermIterator` is an input iterator over the values of an `Odometer`,
+// beginning with its current value.  Incrementing an iterator advances the
+// odometer, so all iterators into the same odometer share one position.  An
+// iterator that is not at the end compares equal to any other that is not at
+// the end, and an iterator reaches the end when the odometer rolls over.
+class TermIterator {
+    Odometer* odometer;  // null if this iterator is at the end
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Term;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const Term*;
+    using reference         = Term;
+
+    // Create an iterator that is at the end.
+    TermIterator();
+
+    // Create an iterator whose first value is the current value of the
+    // specified `odometer`.
+    explicit TermIterator(Odometer& odometer);
+
+    // Return a view of the current value.  The behavior is undefined if this
+    // iterator is at the end.
+    Term operator*() const;
+
+    // Advance to the next value, or to the end if there are no more.  Return
+    // a reference providing modifiable access to this iterator.  The behavior
+    // is undefined if this iterator is at the end.
+    TermIterator& operator++();
+
+    // Return whether the specified iterators are both at the end, or both
+    // not at the end.
+    friend bool operator==(const TermIterator& left,
+                           const TermIterator& right);
+    friend bool operator!=(const TermIterator& left,
+                           const TermIterator& right);
+};
+
+// Invoke the specified `visitor` on the values produced by the specified
+// `odometer`, starting with its current value, as `visitor(data, size)`,
+// where `data` is a `const char*` pointing to the value's `size` bytes.  Stop
+// after the last value, or as soon as `visitor` returns `false`.  Return the
+// number of values visited.  If `visitor` stopped early, then `odometer` is
+// left at the last value visited.  Otherwise, it has rolled over to its
+// first value.
+template <typename Visitor>
+std::uint64_t forEachTerm(Odometer& odometer, Visitor&& visitor);
+
+// `Expansion` is the expansion of a shell brace expression, for use by
+// programs that embed brex.  It owns all of the storage needed to parse,
+// compile, and expand an expression, and reuses that storage when it is
+// assigned another.  Terms are produced one at a time, either through
+// iterators (`begin()` and `end()`) or through a callback (`forEach`), as
+// views of an internal buffer, so no memory is allocated per term and the
+// caller can stop at any point.  For example:
+//
+//     brex::Expansion expansion;
+//     if (expansion.assign("a{b,c}d") == brex::ParseResult::SUCCESS) {
+//         for (const brex::Term term : expansion) {
+//             std::fwrite(term.data, 1, term.size, stdout);
+//         }
+//     }
+class Expansion {
+    std::string               input;
+    Arena                     arena;
+    ParseTreeNode             tree;
+    Program                   program;
+    std::unique_ptr<Odometer> cursor;  // created by the first valid `assign`
+    bool                      valid;   // whether there is an expression
+
+  public:
+    // Create an object having no expression.
+    Expansion();
+
+    Expansion(const Expansion&) = delete;
+    Expansion& operator=(const Expansion&) = delete;
+
+    // Parse and compile the specified `expression`, and set this object to
+    // the first term of its expansion.  Return `ParseResult::SUCCESS` if
+    // `expression` is valid, or the reason that it isn't otherwise.  If
+    // `expression` is invalid and the optionally specified `errors` is not
+    // null, then write a diagnostic to `errors`.  If `expression` is invalid,
+    // then this object has no expression afterward.
+    ParseResult assign(const std::string& expression,
+                       std::ostream*      errors = nullptr);
+
+    // Return whether this object has an expression, i.e. whether the most
+    // recent call to `assign` succeeded.
+    bool hasExpression() const;
+
+    // Set this object to the first term of its expansion, and return an
+    // iterator beginning there.  The behavior is undefined unless this object
+    // has an expression.
+    TermIterator begin();
+
+    // Return an iterator that is at the end.
+    TermIterator end() const;
+
+    // Invoke the specified `visitor` on each term of the expansion, starting
+    // with the first, as described by `forEachTerm`.  Return the number of
+    // terms visited.  The behavior is undefined unless this object has an
+    // expression.
+    template <typename Visitor>
+    std::uint64_t forEach(Visitor&& visitor);
+
+    // Return a reference providing modifiable access to the odometer that
+    // produces the terms of the expansion.  The behavior is undefined unless
+    // this object has an expression.
+    Odometer& odometer();
+};
+
+// inline definitions
+// ------------------
+
+inline TermIterator::TermIterator()
+: odometer(nullptr) {
+}
+
+inline TermIterator::TermIterator(Odometer& odometer)
+: odometer(&odometer) {
+}
+
+inline Term TermIterator::operator*() const {
+    const std::string& value = odometer->current();
+    return Term{value.data(), value.size()};
+}
+
+inline TermIterator& TermIterator::operator++() {
+    if (odometer->advance() == AdvanceResult::CARRY) {
+        odometer = nullptr;
+    }
+    return *this;
+}
+
+inline bool operator==(const TermIterator& left, const TermIterator& right) {
+    return (left.odometer == nullptr) == (right.odometer == nullptr);
+}
+
+inline bool operator!=(const TermIterator& left, const TermIterator& right) {
+    return !(left == right);
+}
+
+template <typename Visitor>
+std::uint64_t forEachTerm(Odometer& odometer, Visitor&& visitor) {
+    std::uint64_t visited = 0;
+
+    do {
+        const std::string& value = odometer.current();
+        ++visited;
+        if (!visitor(value.data(), value.size())) {
+            break;
+        }
+    } while (odometer.advance() == AdvanceResult::NO_CARRY);
+
+    return visited;
+}
+
+inline bool Expansion::hasExpression() const {
+    return valid;
+}
+
+inline TermIterator Expansion::begin() {
+    cursor->reset();
+    return TermIterator(*cursor);
+}
+
+inline TermIterator Expansion::end() const {
+    return TermIterator();
+}
+
+template <typename Visitor>
+std::uint64_t Expansion::forEach(Visitor&& visitor) {
+    cursor->reset();
+    return forEachTerm(*cursor, std::forward<Visitor>(visitor));
+}
+
+inline Odometer& Expansion::odometer() {
+    return *cursor;
+}
+
+}  // namespace brex
+
+#endif
@@ -4,27 +4,78 @@
 import os
 import subprocess
 
-def brex(input, flags=[], executable_path=None):
+def brex_path():
+    """Return the path to the brex command line tool.  Use the value of the
+    "BREX" environment variable, if present, and otherwise use "./brex".
+    """
+    return os.environ.get('BREX', './brex')
+
+
+def brex(input, flags=[], executable_path=None, timeout=None):
     """Run the brex command line tool at the optionally specified
     `executable_path`, supplying the specified standard `input` and command
     line `flags`.  If `executable_path` is `None`, then use the value of the
     "BREX" environment variable.  If "BREX" is not in the environment, then
-    use "./brex".  Return a tuple having three elements:
+    use "./brex".  If the optionally specified `timeout` is not `None`, then
+    raise `subprocess.TimeoutExpired` if brex runs for longer than `timeout`
+    seconds.  Return a tuple having three elements:
 
     - the integer status code returned by the brex subprocess,
     - a string containing the contents of the subprocess's standard output,
     - a string containing the contents of the subprocess's standard error.
     """
-    if executable_path is not None:
-        path = executable_path
-    elif 'BREX' in os.environ:
-        path = os.environ['BREX']
-    else:
-        path = './brex'
+    path = executable_path or brex_path()
 
     result = subprocess.run([path] + flags,
                             input=input,
                             capture_output=True,
-                            encoding='utf8')
+                            encoding='utf8',
+                            timeout=timeout)
+
+    return result.returncode, result.stdout, result.stderr
+
 
+def brex_bytes(input, flags=[]):
+    """Run brex with the specified `input` bytes and command line `flags`.
+    Return a tuple of the status code, standard output bytes, and standard
+    error bytes.
+    """
+    result = subprocess.run([brex_path()] + flags,
+                            input=input,
+                            capture_output=True)
     return result.returncode, result.stdout, result.stderr
+
+
+def terms(expression):
+    """Return the list of terms of the expansion of the specified
+    `expression`, as printed by brex.
+    """
+    status, stdout, _ = brex(expression + '\n', ['--lines'])
+    assert status == 0, expression
+    return stdout.splitlines()
+
+
+def random_expression(rng, depth=0):
+    """Return a random valid brace expression generated using the specified
+    `rng`.  The specified `depth` is the alternation nesting depth at which
+    the expression will appear.
+    """
+    def string():
+        return ''.join(rng.choice('abcXYZ') for _ in range(rng.randint(1, 3)))
+
+    def alternation():
+        if depth > 2:
+            return '{' + string() + '}'
+        count = rng.randint(1, 3)
+        children = [random_expression(rng, depth + 1) for _ in range(count)]
+        return '{' + ','.join(children) + '}'
+
+    # A sequence of between one and three parts, where no two strings are
+    # adjacent (since adjacent strings would parse as one string).
+    parts = []
+    for _ in range(rng.randint(1, 3)):
+        if parts and not parts[-1].startswith('{'):
+            parts.append(alternation())
+        else:
+            parts.append(rng.choice([string, alternation])())
+    return ''.join(parts)
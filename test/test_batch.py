@@ -0,0 +1,89 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import subprocess
+import threading
+import unittest
+
+
+def single(expression, flags=[]):
+    """Return the record that `--batch` is expected to print for the
+    specified `expression`, judging by running brex on `expression` alone with
+    the specified `flags`.
+    """
+    status, stdout, _ = common.brex(expression + '\n', ['--lines'] + flags)
+    if status == 0:
+        return '0\n' + stdout + '\n'
+    return '%d\n\n' % status
+
+
+class TestBatch(unittest.TestCase):
+    def test_matches_single(self):
+        rng = random.Random(1111)
+        expressions = [common.random_expression(rng) for _ in range(30)]
+        expressions += ['{}', '', 'a,b', '{a', 'x{y}z', 'A{b,C}d']
+        rng.shuffle(expressions)
+
+        for flags in [[], ['--limit', '2']]:
+            status, stdout, stderr = common.brex(
+                ''.join(e + '\n' for e in expressions), ['--batch'] + flags)
+            self.assertEqual(status, 0)
+            self.assertEqual(stderr, '')
+            self.assertEqual(stdout,
+                             ''.join(single(e, flags) for e in expressions))
+
+    def test_last_line_without_newline(self):
+        status, stdout, _ = common.brex('a{b,c}\nd', ['--batch'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, '0\nab\nac\n\n0\nd\n\n')
+
+    def test_empty_input(self):
+        status, stdout, _ = common.brex('', ['--batch'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, '')
+
+    def test_diagnostics(self):
+        status, stdout, stderr = common.brex('a\n{}\nb\n',
+                                             ['--batch', '--verbose'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, '0\na\n\n3\n\n0\nb\n\n')
+        self.assertTrue(stderr.startswith('Line 2: '), stderr)
+
+    def test_interactive(self):
+        # A record is written as soon as its expression is read, without
+        # waiting for the end of input.
+        process = subprocess.Popen([common.brex_path(), '--batch'],
+                                   stdin=subprocess.PIPE,
+                                   stdout=subprocess.PIPE,
+                                   encoding='utf8')
+        timer = threading.Timer(10, process.kill)
+        timer.start()
+        try:
+            for expression, record in [('a{b,c}', ['0', 'ab', 'ac', '']),
+                                       ('{', ['4', ''])]:
+                process.stdin.write(expression + '\n')
+                process.stdin.flush()
+                lines = [process.stdout.readline().rstrip('\n')
+                         for _ in record]
+                self.assertEqual(lines, record)
+            process.stdin.close()
+            self.assertEqual(process.stdout.read(), '')
+            self.assertEqual(process.wait(), 0)
+        finally:
+            timer.cancel()
+            process.kill()
+            process.stdout.close()
+
+    def test_incompatible_options(self):
+        for flags in [['--parse'], ['--count'], ['--nth', '1'],
+                      ['--offset', '1'], ['--threads', '2'], ['--tree'],
+                      ['--ostream']]:
+            status, stdout, _ = common.brex('a\n', ['--batch'] + flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
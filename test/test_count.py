@@ -0,0 +1,63 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import json
+import random
+import unittest
+
+
+class TestCount(unittest.TestCase):
+    def count(self, input, flags=[]):
+        status, stdout, stderr = common.brex(input, ['--count'] + flags)
+        self.assertEqual(status, 0)
+        self.assertEqual(stderr, '')
+        return json.loads(stdout)
+
+    def assert_count_matches_expansion(self, input):
+        for flags in [[], ['--lines']]:
+            status, stdout, _ = common.brex(input, flags)
+            self.assertEqual(status, 0)
+
+            separator = '\n' if flags else ' '
+            expected = {
+                'terms': len(stdout[:-1].split(separator)),
+                'bytes': len(stdout.encode('utf8'))
+            }
+            self.assertEqual(self.count(input, flags), expected, input)
+
+    def test_examples(self):
+        for input in ['ha{x,foo{bar,baz{zy,z}}}{a,b}',
+                      '{A,B,C}',
+                      '{A,B}{C,D}',
+                      '{A,B{C,D}}',
+                      'ABC']:
+            self.assert_count_matches_expansion(input + '\n')
+
+    def test_random_expressions(self):
+        rng = random.Random(4321)
+        for _ in range(50):
+            self.assert_count_matches_expansion(
+                common.random_expression(rng) + '\n')
+
+    def test_beyond_64_bits(self):
+        # 2**100 terms, each 100 bytes long, each followed by a delimiter
+        terms = 2**100
+        self.assertEqual(self.count('{a,b}' * 100 + '\n'),
+                         {'terms': terms, 'bytes': terms * 101})
+
+        # 3**50 * 2 terms, each 52 or 54 bytes long
+        terms = 3**50
+        input = 'x' + '{a,b,c}' * 50 + '{y,zzz}\n'
+        self.assertEqual(self.count(input),
+                         {'terms': terms * 2,
+                          'bytes': terms * (52 + 1) + terms * (54 + 1)})
+
+    def test_parse_error(self):
+        status, stdout, _ = common.brex('{a,}\n', ['--count'])
+        self.assertNotEqual(status, 0)
+        self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,65 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import json
+import unittest
+
+
+# Nesting this deep would overflow the call stack of a recursive parser.
+DEPTH = 300000
+
+
+class TestDeepNesting(unittest.TestCase):
+    def test_expand(self):
+        # "{a{a{a}}}" has the single term "aaa".
+        input = '{a' * DEPTH + '}' * DEPTH + '\n'
+        for flags in [[], ['--nth', '0'], ['--threads', '2']]:
+            status, stdout, stderr = common.brex(input, flags)
+            self.assertEqual(status, 0, flags)
+            self.assertEqual(stderr, '')
+            self.assertEqual(stdout, 'a' * DEPTH + '\n', flags)
+
+    def test_count(self):
+        # "{a,{a,{a,b}}}" has the terms "a", "a", "a", and "b".
+        input = '{a,' * DEPTH + 'b' + '}' * DEPTH + '\n'
+        status, stdout, _ = common.brex(input, ['--count'])
+        self.assertEqual(status, 0)
+        self.assertEqual(json.loads(stdout),
+                         {'terms': DEPTH + 1, 'bytes': 2 * (DEPTH + 1)})
+
+    def test_parse(self):
+        # The JSON repeats the source of every node, so its size is
+        # quadratic in the depth.  Keep the depth modest.
+        depth = 3000
+        input = '{' * depth + 'a' + '}' * depth
+        status, stdout, _ = common.brex(input + '\n', ['--parse'])
+        self.assertEqual(status, 0)
+
+        parts = []
+        for i in range(depth):
+            parts.append('{"type": "ALTERNATION", "byteOffset": %d, '
+                         '"source": "%s", "children": [' %
+                         (i, input[i:len(input) - i]))
+        parts.append('{"type": "STRING", "byteOffset": %d, "source": "a"}' %
+                     depth)
+        parts.append(']}' * depth)
+        self.assertEqual(stdout, ''.join(parts) + '\n')
+
+    def test_unclosed(self):
+        input = '{a' * DEPTH + '}' * (DEPTH - 1) + '\n'
+        status, stdout, stderr = common.brex(input, ['--verbose'])
+        self.assertEqual(status, 4)  # UNCLOSED_ALTERNATION
+        self.assertEqual(stdout, '')
+        self.assertIn('The alternation began at byte offset 0.', stderr)
+
+    def test_tree_rejected(self):
+        input = '{a' * DEPTH + '}' * DEPTH + '\n'
+        status, stdout, stderr = common.brex(input, ['--tree', '--verbose'])
+        self.assertEqual(status, 1)
+        self.assertEqual(stdout, '')
+        self.assertIn('nested too deeply', stderr)
+
+
+if __name__ == '__main__':
+    unittest.main()
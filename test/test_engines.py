@@ -0,0 +1,66 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import unittest
+
+
+class TestEngines(unittest.TestCase):
+    """The compiled engine (the default) must produce exactly the same output
+    as the original tree of expanders (`--tree`).
+    """
+    def assert_same_output(self, input, flags=[]):
+        tree_status, tree_stdout, _ = common.brex(input, ['--tree'] + flags)
+        status, stdout, _ = common.brex(input, flags)
+
+        self.assertEqual(status, 0)
+        self.assertEqual(tree_status, 0)
+        self.assertEqual(stdout, tree_stdout, input)
+
+    def test_examples(self):
+        for input in ['ha{x,foo{bar,baz{zy,z}}}{a,b}',
+                      '{A,B,C}',
+                      '{A,B}{C,D}',
+                      '{A,B{C,D}}',
+                      '{ABC}',
+                      'ABC',
+                      '{{{{a}}}}',
+                      '{a,{b,{c,{d}}}}x{y,{z,w}v}']:
+            self.assert_same_output(input + '\n')
+            self.assert_same_output(input + '\n', ['--lines'])
+
+    def test_output_paths(self):
+        input = '{a,b,c,d,e,f,g,h}{a,b,c,d,e,f,g,h}{a,b,c,d}x{yy,zzz}\n'
+        for flags in [['--ostream'],
+                      ['--buffer-size', '1'],
+                      ['--buffer-size', '7'],
+                      ['--buffer-size', '4096', '--lines']]:
+            self.assert_same_output(input, flags)
+
+    def test_invalid_buffer_size(self):
+        for value in ['0', '-1', 'x', '']:
+            status, stdout, _ = common.brex('a\n', ['--buffer-size', value])
+            self.assertNotEqual(status, 0)
+            self.assertEqual(stdout, '')
+
+    def test_repeated_subexpressions(self):
+        # Identical parts of an expression are compiled only once, but each
+        # occurrence still iterates independently.
+        for input in ['{a,b}{a,b}{a,b}',
+                      'x{a,b}y{a,b}x{a,b}',
+                      '{ab,ab,{ab}}',
+                      '{a{c,d},b}{c,d}',
+                      '{c,d}{a{c,d},b}',
+                      '{a,b{a,b{a,b}}}{a,b{a,b}}',
+                      '{x{a,b},y{a,b}}{x{a,b},y}']:
+            self.assert_same_output(input + '\n')
+
+    def test_random_expressions(self):
+        rng = random.Random(1234)
+        for _ in range(100):
+            self.assert_same_output(common.random_expression(rng) + '\n')
+
+
+if __name__ == '__main__':
+    unittest.main()
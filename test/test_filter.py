@@ -0,0 +1,158 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import fnmatch
+import random
+import unittest
+
+
+def random_glob(rng):
+    """Return a random glob pattern over the letters of
+    `common.random_expression`, generated using the specified `rng`.
+    """
+    def element():
+        kind = rng.randrange(6)
+        if kind == 0:
+            return '*'
+        if kind == 1:
+            return '?'
+        if kind == 2:
+            letters = ''.join(rng.sample('abcXYZ', rng.randint(1, 3)))
+            return '[' + rng.choice(['', '!']) + letters + ']'
+        return rng.choice('abcXYZ')
+
+    return ''.join(element() for _ in range(rng.randint(0, 6)))
+
+
+class TestFilter(unittest.TestCase):
+    def assert_filters(self, expression, flags, expected):
+        status, stdout, stderr = common.brex(expression + '\n',
+                                             ['--lines'] + flags)
+        self.assertEqual(status, 0)
+        self.assertEqual(stderr, '')
+        self.assertEqual(stdout,
+                         ''.join(term + '\n' for term in expected),
+                         (expression, flags))
+
+    def assert_prefix(self, expression, prefix):
+        self.assert_filters(expression,
+                            ['--prefix', prefix],
+                            [term for term in common.terms(expression)
+                             if term.startswith(prefix)])
+
+    def assert_glob(self, expression, glob):
+        self.assert_filters(expression,
+                            ['--glob', glob],
+                            [term for term in common.terms(expression)
+                             if fnmatch.fnmatchcase(term, glob)])
+
+    def test_examples(self):
+        expression = 'ha{x,foo{bar,baz{zy,z}}}{a,b}'
+        self.assert_prefix(expression, 'hafoob')
+        self.assert_prefix(expression, 'hax')
+        self.assert_prefix(expression, '')
+        self.assert_glob(expression, 'ha*z*')
+        self.assert_glob(expression, 'ha???a')
+        self.assert_glob(expression, 'hafoo[!b]*')
+        self.assert_glob(expression, '*[a-c]')
+
+    def test_random_expressions(self):
+        rng = random.Random(1616)
+        for _ in range(50):
+            expression = common.random_expression(rng)
+            all_terms = common.terms(expression)
+            term = rng.choice(all_terms)
+            self.assert_prefix(expression, term[:rng.randint(0, len(term))])
+            self.assert_glob(expression, random_glob(rng))
+
+    def test_ranges(self):
+        rng = random.Random(2121)
+        for _ in range(200):
+            start = rng.randint(-1200, 1200)
+            end = rng.randint(-1200, 1200)
+            step = rng.randint(1, 40)
+            width = rng.choice([0, 0, 3, 5])
+            expression = '{%0*d..%d..%d}%s' % (
+                width, start, end, step, rng.choice(['', 'x', '{x,y}']))
+            all_terms = common.terms(expression)
+            term = rng.choice(all_terms)
+            self.assert_prefix(expression, term[:rng.randint(1, len(term))])
+            glob = ''.join(rng.choice(['*', '?', '-', '0', '1', '[2-5]'])
+                           for _ in range(rng.randint(1, 4)))
+            self.assert_glob(expression, glob)
+
+    def test_huge_ranges(self):
+        # Each of these would take minutes if every value of the range were
+        # tried in turn.
+        def assert_quick(expression, flags, expected):
+            self.assertEqual(common.brex(expression + '\n',
+                                         ['--lines'] + flags,
+                                         timeout=10),
+                             (0, ''.join(term + '\n' for term in expected),
+                              ''))
+
+        assert_quick('{1..2000000000}', ['--prefix', '1999999999'],
+                     ['1999999999'])
+        assert_quick('{a,b}{1..2000000000}', ['--prefix', 'b123456789'],
+                     ['b123456789'] +
+                     ['b12345678%d' % i for i in range(90, 100)])
+        assert_quick('{-2000000000..0}', ['--glob', '-1?00000000'],
+                     ['-1%d00000000' % i for i in range(9, -1, -1)])
+        assert_quick('{2000000000..1..7}', ['--glob', '77777777*'],
+                     [str(value)
+                      for value in list(range(777777779, 777777769, -1)) +
+                      [77777777]
+                      if (2000000000 - value) % 7 == 0])
+
+    def test_no_match(self):
+        for flags in [['--prefix', 'q'], ['--glob', 'a'], ['--glob', '?']]:
+            self.assert_filters('{a,b}{c,d}', flags, [])
+
+    def test_limit(self):
+        expression = '{a,b}{a,b}{a,b}{a,b}'
+        self.assert_filters(expression,
+                            ['--glob', '*b*b*', '--limit', '3'],
+                            ['aabb', 'abab', 'abba'])
+        self.assert_filters(expression,
+                            ['--prefix', 'bbb', '--limit', '5'],
+                            ['bbba', 'bbbb'])
+
+    def test_glob_syntax(self):
+        # Expressions contain only letters, so these are the cases that
+        # `fnmatch` doesn't cover.
+        expression = '{a,b,c,X,Y,Z}{x,y}'
+        self.assert_filters(expression, ['--glob', '\\ax'], ['ax'])
+        self.assert_filters(expression, ['--glob', '[]a]x'], ['ax'])
+        self.assert_filters(expression, ['--glob', '[^a-c]y'],
+                            ['Xy', 'Yy', 'Zy'])
+        self.assert_filters(expression, ['--glob', '[!X-Z]x'],
+                            ['ax', 'bx', 'cx'])
+        self.assert_filters(expression, ['--glob', '[Z-Z]?'], ['Zx', 'Zy'])
+
+    def test_invalid_glob(self):
+        for glob in ['[a', '[]', 'a\\']:
+            status, stdout, stderr = common.brex('a\n',
+                                                 ['--glob', glob,
+                                                  '--verbose'])
+            self.assertEqual(status, 1, glob)
+            self.assertEqual(stdout, '')
+            self.assertNotEqual(stderr, '')
+
+    def test_incompatible_options(self):
+        for flags in [['--prefix', 'a', '--glob', 'a'],
+                      ['--prefix', 'a', '--count'],
+                      ['--prefix', 'a', '--nth', '1'],
+                      ['--glob', 'a', '--offset', '1'],
+                      ['--glob', 'a', '--threads', '2'],
+                      ['--glob', 'a', '--tree'],
+                      ['--prefix', 'a', '--match'],
+                      ['--prefix', 'a', '--front-code'],
+                      ['--prefix']]:
+            status, stdout, _ = common.brex('a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import unittest
+
+
+def varint(value):
+    """Return the LEB128 encoding of the specified `value`."""
+    result = bytearray()
+    while value >= 0x80:
+        result.append((value & 0x7f) | 0x80)
+        value >>= 7
+    result.append(value)
+    return bytes(result)
+
+
+def front_code(terms):
+    """Return the front coding of the specified `terms`, computed naively,
+    where each term shares with the previous as long a prefix as possible.
+    """
+    result = bytearray()
+    previous = b''
+    for term in terms:
+        shared = 0
+        while (shared < min(len(term), len(previous)) and
+               term[shared] == previous[shared]):
+            shared += 1
+        result += varint(shared) + varint(len(term) - shared) + term[shared:]
+        previous = term
+    return bytes(result)
+
+
+class TestFrontCode(unittest.TestCase):
+    def assert_round_trip(self, expression, flags=[]):
+        input = (expression + '\n').encode()
+        status, plain, _ = common.brex_bytes(input, ['--lines'] + flags)
+        self.assertEqual(status, 0)
+
+        status, encoded, _ = common.brex_bytes(input,
+                                               ['--front-code'] + flags)
+        self.assertEqual(status, 0)
+
+        terms = plain.splitlines()
+        for separator, lines in [(b' ', []), (b'\n', ['--lines'])]:
+            status, decoded, stderr = common.brex_bytes(
+                encoded, ['--decode'] + lines)
+            self.assertEqual(status, 0)
+            self.assertEqual(stderr, b'')
+            self.assertEqual(decoded, separator.join(terms) + b'\n',
+                             expression)
+
+        # The shared prefixes come from the odometer rather than from
+        # comparing terms, so they may be shorter than the longest possible,
+        # but never longer.
+        self.assertGreaterEqual(len(encoded),
+                                len(front_code(terms)))
+        return encoded
+
+    def test_example(self):
+        encoded = self.assert_round_trip('a{b,c{d,e}}f')
+        self.assertEqual(encoded,
+                         b'\x00\x03abf' b'\x01\x03cdf' b'\x02\x02ef')
+
+    def test_random_expressions(self):
+        rng = random.Random(1515)
+        for _ in range(50):
+            self.assert_round_trip(common.random_expression(rng))
+
+    def test_limit_and_offset(self):
+        expression = '{a,b,c}x{d,e{f,g}}{h,i}'
+        for flags in [['--limit', '1'], ['--limit', '5'], ['--offset', '3'],
+                      ['--offset', '7', '--limit', '4'], ['--nth', '11']]:
+            self.assert_round_trip(expression, flags)
+
+    def test_long_terms(self):
+        # Lengths of 128 bytes or more take more than one byte to encode.
+        long = 'x' * 200
+        self.assert_round_trip('{a,' + long + '}{' + long + ',b}')
+
+    def test_empty_input(self):
+        status, stdout, _ = common.brex_bytes(b'', ['--decode'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, b'')
+
+    def test_invalid_input(self):
+        for input in [b'\x01\x01a',         # shares more than there is
+                      b'\x00\x03ab',        # ends within a term
+                      b'\x00\x01a\x00',     # ends within a length
+                      b'\x00\x81',          # ends within a length
+                      b'\x80' * 11 + b'\x00',  # too many length bytes
+                      # a length of 5, but with a bit beyond the 64th
+                      b'\x00\x85' + b'\x80' * 8 + b'\x02hello',
+                      # a length of 4 GiB, but only two bytes
+                      b'\x00\xff\xff\xff\xff\x0fab']:
+            status, _, stderr = common.brex_bytes(input,
+                                                  ['--decode', '--verbose'])
+            self.assertNotEqual(status, 0, input)
+            self.assertNotEqual(stderr, b'', input)
+
+    def test_incompatible_options(self):
+        for flags in [['--front-code', '--threads', '2'],
+                      ['--front-code', '--tree'],
+                      ['--front-code', '--ostream'],
+                      ['--front-code', '--count'],
+                      ['--decode', '--limit', '1'],
+                      ['--decode', '--front-code']]:
+            status, stdout, _ = common.brex_bytes(b'a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, b'')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import os
+import random
+import struct
+import subprocess
+import tempfile
+import unittest
+
+
+def run(input, flags):
+    """Return the status and the standard output, as bytes, of brex with the
+    specified command line `flags` given the specified `input` string.
+    """
+    result = subprocess.run([common.brex_path()] + flags,
+                            input=input.encode(),
+                            capture_output=True)
+    return result.returncode, result.stdout
+
+
+def checksum(data):
+    """Return the checksum that brex computes of the specified `data` bytes,
+    whose length is a multiple of 8.  See `image.cpp`.
+    """
+    mask = (1 << 64) - 1
+    result = 14695981039346656037
+    for (word,) in struct.iter_unpack('<Q', data):
+        result = ((result ^ word) * 1099511628211) & mask
+        result ^= result >> 29
+    return result
+
+
+def reseal(image):
+    """Return the specified `image` bytes with its checksum recomputed, so
+    that only its structure is checked when it's loaded.
+    """
+    return image[:16] + struct.pack('<Q', checksum(image[24:])) + image[24:]
+
+
+class TestImage(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory(prefix='brex-test-')
+        self.path = os.path.join(self.directory.name, 'image.brex')
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def compile(self, expression):
+        """Compile the specified `expression` into the image at `self.path`,
+        and return the image's bytes.
+        """
+        status, stdout, stderr = common.brex(
+            expression + '\n', ['--compile', self.path, '--verbose'])
+        self.assertEqual((status, stdout, stderr), (0, '', ''), expression)
+        with open(self.path, 'rb') as file:
+            return file.read()
+
+    def load(self, image, flags=[]):
+        """Write the specified `image` bytes to `self.path`, and return the
+        status, standard output, and standard error of loading it with the
+        specified command line `flags`.
+        """
+        with open(self.path, 'wb') as file:
+            file.write(image)
+        return common.brex('', ['--load', self.path, '--verbose'] + flags)
+
+    def test_same_as_expression(self):
+        rng = random.Random(23)
+        expressions = [common.random_expression(rng) for _ in range(100)]
+        expressions += ['a', '{1..20..3}x{a..e}', '{-5..5}{A,{Z..X}}']
+        for expression in expressions:
+            self.compile(expression)
+            for flags in [[],
+                          ['--lines'],
+                          ['--count'],
+                          ['--offset', '2'],
+                          ['--nth', '1'],
+                          ['--limit', '3'],
+                          ['--threads', '3'],
+                          ['--prefix', 'a'],
+                          ['--glob', '*b*'],
+                          ['--sample', '5', '--seed', '7'],
+                          ['--front-code'],
+                          ['--length-prefixed'],
+                          ['-0'],
+                          ['--ostream']]:
+                self.assertEqual(
+                    run('', ['--load', self.path] + flags),
+                    run(expression + '\n', flags),
+                    (expression, flags))
+
+    def test_standard_input_is_ignored(self):
+        self.compile('a{b,c}')
+        status, stdout, _ = common.brex('x{y,z}\nmore\n',
+                                        ['--load', self.path])
+        self.assertEqual((status, stdout), (0, 'ab ac\n'))
+
+    def test_invalid_expression(self):
+        status, stdout, _ = common.brex('a{b\n', ['--compile', self.path])
+        self.assertNotEqual(status, 0)
+        self.assertEqual(stdout, '')
+        self.assertFalse(os.path.exists(self.path))
+
+    def test_unwritable_path(self):
+        status, stdout, stderr = common.brex(
+            'a\n', ['--compile', '/nonexistent/image.brex', '--verbose'])
+        self.assertEqual((status, stdout), (1, ''))
+        self.assertIn('errno', stderr)
+
+    def test_missing_file(self):
+        status, stdout, stderr = common.brex(
+            '', ['--load', '/nonexistent/image.brex', '--verbose'])
+        self.assertEqual((status, stdout), (1, ''))
+        self.assertIn('errno', stderr)
+
+    def test_damaged(self):
+        image = self.compile('a{b,{c,d}e}{1..30}')
+        damaged = [b'',
+                   image[:7],
+                   image[:len(image) // 2],
+                   image[:-8],
+                   image + bytes(8),
+                   b'X' + image[1:],
+                   image[:8] + struct.pack('<I', 2) + image[12:],
+                   image[:12] + struct.pack('>I', 0x01020304) + image[16:]]
+        for i in range(16, len(image)):
+            flipped = bytearray(image)
+            flipped[i] ^= 0x10
+            damaged.append(bytes(flipped))
+
+        for image in damaged:
+            status, stdout, stderr = self.load(image)
+            self.assertEqual((status, stdout), (1, ''), image)
+            self.assertIn('Invalid compiled expression image', stderr)
+
+    def test_version(self):
+        image = self.compile('a{b,c}')
+        status, _, stderr = self.load(
+            image[:8] + struct.pack('<I', 99) + image[12:])
+        self.assertEqual(status, 1)
+        self.assertIn('version 99', stderr)
+
+    def test_malformed_program(self):
+        # Each of these images has a valid checksum, but a program that
+        # `compile` could not have produced.
+        image = self.compile('a{b,c}')
+        root, = struct.unpack_from('<i', image, 32)
+        offset, count = struct.unpack_from('<QQ', image, 40)  # instructions
+        branches, _ = struct.unpack_from('<QQ', image, 56)
+
+        def instruction(index, opcode, first, count):
+            at = offset + index * 12
+            return (image[:at] + struct.pack('<iii', opcode, first, count) +
+                    image[at + 12:])
+
+        malformed = [
+            image[:32] + struct.pack('<i', count) + image[36:],
+            image[:32] + struct.pack('<i', -1) + image[36:],
+            # a branch to the slot's own chain
+            image[:branches] + struct.pack('<i', root) +
+            image[branches + 4:],
+            # a literal past the end of the literals
+            instruction(0, 0, 0, 1000),
+            # an unknown opcode
+            instruction(0, 7, 0, 0),
+            # a chain without a `RETURN`
+            instruction(count - 1, 0, 0, 1),
+            # a range that doesn't exist
+            instruction(0, 2, 0, 1)]
+        for image in malformed:
+            status, stdout, stderr = self.load(reseal(image))
+            self.assertEqual((status, stdout), (1, ''))
+            self.assertIn('Invalid compiled expression image', stderr)
+
+    def test_wrong_cardinality(self):
+        # These images have a valid checksum and a valid program, but record
+        # a different size of expansion than the program's.  Only `--output`
+        # relies on the size, and it checks the size first.
+        image = self.compile('a{b,cd}{1..30}')
+        terms, _ = struct.unpack_from('<QQ', image, 104)
+        size, _ = struct.unpack_from('<QQ', image, 120)
+
+        def limb(offset, value):
+            return (image[:offset] + struct.pack('<I', value) +
+                    image[offset + 4:])
+
+        expected = run('a{b,cd}{1..30}\n', [])
+        for wrong in [limb(terms, 59), limb(terms, 61), limb(size, 1)]:
+            status, stdout, _ = self.load(reseal(wrong))
+            self.assertEqual((status, stdout.encode()), expected)
+
+            output = self.path + '.out'
+            status, stdout, stderr = self.load(reseal(wrong),
+                                               ['--output', output])
+            self.assertEqual((status, stdout), (1, ''))
+            self.assertIn('bytes were expected', stderr)
+            self.assertFalse(os.path.exists(output))
+
+    def test_incompatible_options(self):
+        for flags in [['--compile', 'x', '--load', 'y'],
+                      ['--compile', 'x', '--count'],
+                      ['--compile', 'x', '--lines'],
+                      ['--compile', 'x', '--threads', '2'],
+                      ['--load', 'x', '--parse'],
+                      ['--load', 'x', '--tree'],
+                      ['--load', 'x', '--batch'],
+                      ['--load', 'x', '--match'],
+                      ['--load', 'x', '--decode'],
+                      ['--load', 'x', '--stats'],
+                      ['--load', 'x', '--serve', 'y'],
+                      ['--compile'],
+                      ['--load']]:
+            status, stdout, _ = common.brex('a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
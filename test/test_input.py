@@ -0,0 +1,100 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import os
+import random
+import tempfile
+import unittest
+
+
+class TestInput(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory(prefix='brex-test-')
+        self.path = os.path.join(self.directory.name, 'expression')
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def input(self, contents, flags=[]):
+        """Write the specified `contents` string to `self.path`, and return
+        the status, standard output, and standard error of brex reading it
+        with `--input` and the specified command line `flags`.
+        """
+        with open(self.path, 'w') as file:
+            file.write(contents)
+        return common.brex('', ['--input', self.path] + flags)
+
+    def test_same_as_stdin(self):
+        rng = random.Random(25)
+        expressions = [common.random_expression(rng) for _ in range(100)]
+        expressions += ['a', '{1..20..3}x{a..e}', '{-5..5}{A,{Z..X}}']
+        for expression in expressions:
+            for flags in [[],
+                          ['--lines'],
+                          ['--count'],
+                          ['--nth', '1'],
+                          ['--limit', '3'],
+                          ['--threads', '3'],
+                          ['--glob', '*b*'],
+                          ['--parse'],
+                          ['--tree']]:
+                self.assertEqual(self.input(expression + '\n', flags),
+                                 common.brex(expression + '\n', flags),
+                                 (expression, flags))
+
+    def test_no_newline(self):
+        self.assertEqual(self.input('a{b,c}'), (0, 'ab ac\n', ''))
+
+    def test_standard_input_is_ignored(self):
+        with open(self.path, 'w') as file:
+            file.write('a{b,c}\n')
+        status, stdout, _ = common.brex('x{y,z}\n', ['--input', self.path])
+        self.assertEqual((status, stdout), (0, 'ab ac\n'))
+
+    def test_trailing_input(self):
+        status, stdout, _ = self.input('a{b,c}\nmore\n')
+        self.assertEqual((status, stdout), (2, ''))
+
+    def test_empty_file(self):
+        status, stdout, _ = self.input('')
+        self.assertEqual((status, stdout),
+                         common.brex('', [])[:2])
+
+    def test_invalid_expression(self):
+        self.assertEqual(self.input('a{b\n', ['--verbose']),
+                         common.brex('a{b\n', ['--verbose']))
+
+    def test_missing_file(self):
+        status, stdout, stderr = common.brex(
+            'a\n', ['--input', '/nonexistent/expression', '--verbose'])
+        self.assertEqual((status, stdout), (1, ''))
+        self.assertIn('errno', stderr)
+
+    def test_compile_and_output(self):
+        image = os.path.join(self.directory.name, 'image.brex')
+        status, _, _ = self.input('a{b,c}{1..3}\n', ['--compile', image])
+        self.assertEqual(status, 0)
+        self.assertEqual(common.brex('', ['--load', image]),
+                         common.brex('a{b,c}{1..3}\n', []))
+
+        output = os.path.join(self.directory.name, 'expansion')
+        status, _, _ = self.input('a{b,c}\n', ['--output', output])
+        self.assertEqual(status, 0)
+        with open(output) as file:
+            self.assertEqual(file.read(), 'ab ac\n')
+
+    def test_incompatible_options(self):
+        for flags in [['--input', 'x', '--batch'],
+                      ['--input', 'x', '--match'],
+                      ['--input', 'x', '--decode'],
+                      ['--input', 'x', '--serve', 'y'],
+                      ['--input', 'x', '--load', 'y'],
+                      ['--input']]:
+            status, stdout, _ = common.brex('a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import unittest
+
+
+def candidates(rng, words):
+    """Return a list of strings near the specified `words`, generated using
+    the specified `rng`: the words themselves, and the words with a letter
+    removed, added, or changed.
+    """
+    result = list(words)
+    for word in words:
+        i = rng.randrange(len(word) + 1)
+        result.append(word[:i] + word[i + 1:])
+        result.append(word[:i] + rng.choice('abcXYZ') + word[i:])
+        result.append(word[:i] + rng.choice('abcXYZ') + word[i + 1:])
+    rng.shuffle(result)
+    return result
+
+
+class TestMatch(unittest.TestCase):
+    def assert_matches(self, expression, lines):
+        status, stdout, stderr = common.brex(
+            expression + '\n' + ''.join(line + '\n' for line in lines),
+            ['--match'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stderr, '')
+
+        expected = set(common.terms(expression))
+        self.assertEqual(stdout,
+                         ''.join(line + '\n' for line in lines
+                                 if line in expected),
+                         expression)
+
+    def test_examples(self):
+        self.assert_matches('ha{x,foo{bar,baz{zy,z}}}{a,b}',
+                            ['haxa', 'hafoobazzb', 'hafoobazb', 'ha', '',
+                             'hafoobazzyb ', 'HAXA', 'haxab', 'haxa'])
+
+    def test_overlapping_options(self):
+        # Options that are prefixes of one another, and options that end the
+        # same way, are where a deterministic automaton differs most from the
+        # expression.
+        for expression in ['{a,ab,abc}{c,bc,abc}',
+                           '{a,aa,aaa}{a,aa}',
+                           '{x,y}{a,b}{x,y}{a,b}',
+                           '{ab,ab,{ab}}{b,ab}']:
+            self.assert_matches(expression,
+                                candidates(random.Random(expression),
+                                           common.terms(expression)))
+
+    def test_random_expressions(self):
+        rng = random.Random(4321)
+        for _ in range(100):
+            expression = common.random_expression(rng)
+            self.assert_matches(expression,
+                                candidates(rng, common.terms(expression)))
+
+    def test_characters_outside_expression(self):
+        lines = ['ab', 'a-b', 'a\tb', 'ab\r', 'Ab', 'a' + chr(0xe9) + 'b']
+        self.assert_matches('{a,b}{a,b}', lines)
+
+    def test_no_candidates(self):
+        status, stdout, _ = common.brex('a{b,c}\n', ['--match'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, '')
+
+    def test_invalid_expression(self):
+        status, stdout, _ = common.brex('a{b,c\nab\n', ['--match'])
+        self.assertEqual(status, 4)  # UNCLOSED_ALTERNATION
+        self.assertEqual(stdout, '')
+
+    def test_incompatible_options(self):
+        for flags in [['--parse'], ['--count'], ['--nth', '1'],
+                      ['--offset', '1'], ['--limit', '1'], ['--batch'],
+                      ['--threads', '2'], ['--tree'], ['--ostream']]:
+            status, stdout, _ = common.brex('a\na\n', ['--match'] + flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
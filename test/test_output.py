@@ -0,0 +1,109 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import os
+import random
+import subprocess
+import tempfile
+import unittest
+
+
+def stdout(input, flags=[]):
+    """Return the standard output, as bytes, of brex with the specified
+    command line `flags` given the specified `input` string.
+    """
+    return subprocess.run([common.brex_path()] + flags,
+                          input=input.encode(),
+                          capture_output=True,
+                          check=True).stdout
+
+
+class TestOutput(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory(prefix='brex-test-')
+        self.path = os.path.join(self.directory.name, 'expansion')
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def check(self, expression, flags=[]):
+        """Assert that brex writes the same expansion of the specified
+        `expression` to a file with `--output` and the specified command line
+        `flags` as it does to standard output.
+        """
+        status, out, err = common.brex(expression + '\n',
+                                       ['--output', self.path] + flags)
+        self.assertEqual((status, out, err), (0, '', ''), expression)
+        with open(self.path, 'rb') as file:
+            self.assertEqual(file.read(), stdout(expression + '\n', flags),
+                             (expression, flags))
+
+    def test_same_as_stdout(self):
+        rng = random.Random(24)
+        expressions = [common.random_expression(rng) for _ in range(50)]
+        expressions += ['a', '{1..20..3}x{a..e}', '{-5..5}{A,{Z..X}}']
+        for expression in expressions:
+            for flags in [[], ['--lines'], ['-0'], ['--threads', '3']]:
+                self.check(expression, flags)
+
+    def test_many_chunks(self):
+        # Each of these is several megabytes, so that the expansion is
+        # divided into chunks, and each chunk must find where it begins.
+        expressions = [
+            '{a,b{c,d{e,f}}}' * 10,
+            'x{1..200000..7}y{-03..4}{A..Z..3}',
+            '{a,{1..999}b{9..-9}}{d,c}{x,{007..-12..3}}' + '{a,b}' * 6,
+            '{ab,c}{d,{e,fgh}ij{k,lm}}' * 5 + '{1..40}',
+            '{a,' + 'b' * 10000 + '}x{1..300}']
+        for expression in expressions:
+            for threads in ['1', '4']:
+                self.check(expression, ['--threads', threads])
+
+    def test_replaces_file(self):
+        with open(self.path, 'w') as file:
+            file.write('x' * 10000)
+        self.check('a{b,c}')
+
+    def test_load(self):
+        image = os.path.join(self.directory.name, 'image.brex')
+        status, _, _ = common.brex('a{b,c}{1..3}\n', ['--compile', image])
+        self.assertEqual(status, 0)
+        status, _, _ = common.brex('', ['--load', image, '--output',
+                                        self.path])
+        self.assertEqual(status, 0)
+        with open(self.path, 'rb') as file:
+            self.assertEqual(file.read(), stdout('a{b,c}{1..3}\n'))
+
+    def test_too_large(self):
+        status, out, err = common.brex(
+            '{a,b}' * 70 + '\n', ['--output', self.path, '--verbose'])
+        self.assertEqual((status, out), (1, ''))
+        self.assertIn('too large', err)
+        self.assertFalse(os.path.exists(self.path))
+
+    def test_unwritable_path(self):
+        status, out, err = common.brex(
+            'a\n', ['--output', '/nonexistent/expansion', '--verbose'])
+        self.assertEqual((status, out), (1, ''))
+        self.assertIn('errno', err)
+
+    def test_incompatible_options(self):
+        for flags in [['--output', 'x', '--count'],
+                      ['--output', 'x', '--offset', '1'],
+                      ['--output', 'x', '--limit', '1'],
+                      ['--output', 'x', '--prefix', 'a'],
+                      ['--output', 'x', '--sample', '1'],
+                      ['--output', 'x', '--front-code'],
+                      ['--output', 'x', '--length-prefixed'],
+                      ['--output', 'x', '--tree'],
+                      ['--output', 'x', '--batch'],
+                      ['--output', 'x', '--compile', 'y'],
+                      ['--output']]:
+            status, out, _ = common.brex('a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(out, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -53,6 +53,25 @@ class TestParsing(unittest.TestCase):
 
                 self.assert_parse_error(Errors.INVALID_CHARACTER, bad_input)
 
+    def test_invalid_character_in_long_string(self):
+        # Letters are scanned many bytes at a time, so put the invalid
+        # character at every position within and around a few blocks.  The
+        # letters on either side of the invalid character include those at
+        # the edges of the alphabet.
+        letters = 'azAZ' * 20
+        for char in ['@', '[', '`', '~', '0', '\x7f']:
+            for i in range(len(letters)):
+                input = letters[:i] + char + letters[i:]
+                status, stdout, stderr = common.brex(input + '\n',
+                                                     ['--verbose'])
+                self.assertEqual(status, Errors.INVALID_CHARACTER)
+                self.assertEqual(stdout, '')
+                self.assertIn('Error occurred at byte offset %d:' % i, stderr)
+
+        status, stdout, _ = common.brex(letters + '\n')
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, letters + '\n')
+
     def test_empty_alternation(self):
         self.assert_parse_error(Errors.EMPTY_ALTERNATION, 'foo{}bar')
 
@@ -0,0 +1,251 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import json
+import random
+import subprocess
+import unittest
+
+
+def range_terms(first, last, step=None):
+    """Return the list of terms of the range `{first..last}`, or of
+    `{first..last..step}` if `step` is not `None`, where the specified
+    `first`, `last`, and `step` are the strings that appear in the range,
+    following the rules of bash.
+    """
+    stride = abs(int(step)) if step is not None else 1
+    if first.isalpha():
+        begin, end = ord(first), ord(last)
+        if begin > end:
+            stride = -stride
+        return [chr(code) for code in range(begin, end + stride // abs(stride),
+                                            stride)]
+
+    def padded(bound):
+        digits = bound.lstrip('-')
+        return len(digits) > 1 and digits.startswith('0')
+
+    width = max(len(first), len(last)) if padded(first) or padded(last) else 0
+    begin, end = int(first), int(last)
+    if begin > end:
+        stride = -stride
+    return [str(value).zfill(width)
+            for value in range(begin, end + stride // abs(stride), stride)]
+
+
+def random_range(rng, magnitude=120):
+    """Return a tuple of a random range expression generated using the
+    specified `rng`, and the list of its terms.  The bounds of an integer
+    range are at most the specified `magnitude` in absolute value.
+    """
+    step = None
+    if rng.randrange(3) == 0:
+        step = str(rng.choice([-1, 1]) * rng.randint(1, 12))
+
+    if rng.randrange(4) == 0:
+        letters = rng.choice(['abcdefghijklmnopqrstuvwxyz',
+                              'ABCDEFGHIJKLMNOPQRSTUVWXYZ'])
+        first, last = rng.choice(letters), rng.choice(letters)
+    else:
+        def bound():
+            text = str(rng.randint(-magnitude, magnitude))
+            if rng.randrange(4) == 0:
+                sign = '-' if text.startswith('-') else ''
+                text = sign + '0' * rng.randint(1, 2) + text.lstrip('-')
+            return text
+
+        first, last = bound(), bound()
+
+    expression = '{' + first + '..' + last
+    if step is not None:
+        expression += '..' + step
+    return expression + '}', range_terms(first, last, step)
+
+
+def random_expression(rng, depth=0):
+    """Return a tuple of a random brace expression, which may contain ranges,
+    generated using the specified `rng`, and the list of its terms.  The
+    specified `depth` is the alternation nesting depth at which the expression
+    will appear.
+    """
+    def string():
+        text = ''.join(rng.choice('abcXYZ') for _ in range(rng.randint(1, 3)))
+        return text, [text]
+
+    def brace():
+        if depth > 1 or rng.randrange(3) == 0:
+            return random_range(rng, 6)
+        expression, terms = '{', []
+        for i in range(rng.randint(1, 3)):
+            child, child_terms = random_expression(rng, depth + 1)
+            expression += (',' if i else '') + child
+            terms += child_terms
+        return expression + '}', terms
+
+    # As in `common.random_expression`, no two strings are adjacent.
+    expression, terms = '', ['']
+    for _ in range(rng.randint(1, 3)):
+        if expression and not expression.endswith('}'):
+            part, part_terms = brace()
+        else:
+            part, part_terms = rng.choice([string, brace])()
+        expression += part
+        terms = [prefix + suffix for prefix in terms for suffix in part_terms]
+    return expression, terms
+
+
+def expand(expression, flags=[]):
+    """Return the list of terms of the expansion of the specified
+    `expression`, as printed by brex with the specified command line `flags`.
+    """
+    status, stdout, stderr = common.brex(expression + '\n',
+                                         ['--lines'] + flags)
+    assert status == 0, (expression, flags, stderr)
+    return stdout.splitlines()
+
+
+class TestRanges(unittest.TestCase):
+    def test_examples(self):
+        # These are the expansions printed by bash.
+        for expression, expected in [
+                ('{1..5}', '1 2 3 4 5'),
+                ('{5..1}', '5 4 3 2 1'),
+                ('{1..10..3}', '1 4 7 10'),
+                ('{10..1..3}', '10 7 4 1'),
+                ('{1..10..-3}', '1 4 7 10'),
+                ('{-2..2}', '-2 -1 0 1 2'),
+                ('{8..12}', '8 9 10 11 12'),
+                ('{12..8}', '12 11 10 9 8'),
+                ('{08..11}', '08 09 10 11'),
+                ('{1..010..4}', '001 005 009'),
+                ('{-05..3..3}', '-05 -02 001'),
+                ('{98..102..2}', '98 100 102'),
+                ('{102..98..2}', '102 100 98'),
+                ('{7..7}', '7'),
+                ('{a..e}', 'a b c d e'),
+                ('{Z..V..2}', 'Z X V'),
+                ('x{1..3}y', 'x1y x2y x3y'),
+                ('{a,{1..3}}b', 'ab 1b 2b 3b'),
+                ('{a..b}{1..2}', 'a1 a2 b1 b2')]:
+            status, stdout, stderr = common.brex(expression + '\n')
+            self.assertEqual((status, stdout, stderr),
+                             (0, expected + '\n', ''), expression)
+
+    def test_random_ranges(self):
+        rng = random.Random(2021)
+        for _ in range(200):
+            expression, expected = random_range(rng)
+            self.assertEqual(expand(expression), expected, expression)
+
+    def test_engines(self):
+        rng = random.Random(2022)
+        for _ in range(50):
+            expression, expected = random_expression(rng)
+            input = expression + '\n'
+            self.assertEqual(expand(expression), expected, expression)
+            for flags in [['--tree'], ['--ostream'], ['--threads', '3']]:
+                self.assertEqual(expand(expression, flags), expected,
+                                 (expression, flags))
+
+            status, stdout, _ = common.brex(input, ['--count'])
+            self.assertEqual(status, 0)
+            self.assertEqual(json.loads(stdout),
+                             {'terms': len(expected),
+                              'bytes': sum(len(term) + 1
+                                           for term in expected)})
+
+            offset = rng.randrange(len(expected))
+            self.assertEqual(expand(expression, ['--offset', str(offset)]),
+                             expected[offset:], expression)
+            self.assertEqual(expand(expression, ['--nth', str(offset)]),
+                             [expected[offset]], expression)
+
+            prefix = expected[offset][:rng.randint(1, 3)]
+            self.assertEqual(expand(expression, ['--prefix', prefix]),
+                             [term for term in expected
+                              if term.startswith(prefix)],
+                             (expression, prefix))
+            self.assertEqual(expand(expression, ['--glob', '*1*']),
+                             [term for term in expected if '1' in term],
+                             expression)
+
+            # Front coding is binary, so it's passed along as bytes.
+            coded = subprocess.run([common.brex_path(), '--front-code'],
+                                   input=input.encode(),
+                                   capture_output=True,
+                                   check=True).stdout
+            decoded = subprocess.run([common.brex_path(), '--decode'],
+                                     input=coded,
+                                     capture_output=True,
+                                     check=True).stdout
+            self.assertEqual(decoded.decode().split(), expected, expression)
+
+            sampled = expand(expression, ['--sample', '5', '--seed', '7'])
+            self.assertEqual(len(sampled), 5)
+            self.assertTrue(set(sampled) <= set(expected), expression)
+
+            candidates = expected[:20] + [term + '0' for term in expected[:5]]
+            status, stdout, _ = common.brex(
+                input + ''.join(term + '\n' for term in candidates),
+                ['--match'])
+            self.assertEqual(status, 0)
+            self.assertEqual(stdout.splitlines(),
+                             [term for term in candidates
+                              if term in set(expected)], expression)
+
+    def test_large_ranges(self):
+        status, stdout, _ = common.brex('{1..2000000000}x\n', ['--count'])
+        self.assertEqual(status, 0)
+        digits = sum(d * (min(10**d - 1, 2000000000) - 10**(d - 1) + 1)
+                     for d in range(1, 11))
+        self.assertEqual(json.loads(stdout),
+                         {'terms': 2000000000,
+                          'bytes': digits + 2 * 2000000000})
+
+        self.assertEqual(expand('{1..2000000000}x', ['--nth', '1234567889']),
+                         ['1234567890x'])
+        self.assertEqual(
+            expand('{-999999999999999999..999999999999999999..'
+                   '999999999999999999}'),
+            ['-999999999999999999', '0', '999999999999999999'])
+        self.assertEqual(expand('{0001..1000000}', ['--offset', '999998']),
+                         ['0999999', '1000000'])
+
+    def test_parse(self):
+        status, stdout, _ = common.brex('a{1..3}\n', ['--parse'])
+        self.assertEqual(status, 0)
+        self.assertEqual(json.loads(stdout)['children'][1],
+                         {'type': 'RANGE', 'byteOffset': 1,
+                          'source': '{1..3}'})
+
+    def test_invalid_ranges(self):
+        for expression in ['{1..}',
+                           '{1..a}',
+                           '{a..Z}',
+                           '{1..3..0}',
+                           '{1..3..x}',
+                           '{1..2..}',
+                           '{a..c..}',
+                           '{1..3',
+                           '{1..1000000000000000000}',
+                           '{-1000000000000000000..1}',
+                           '{9999999999999999999..9999999999999999999}',
+                           'x{9300000000000000000..9300000000000000001}',
+                           '{1..99999999999999999999}',
+                           '{1..3..99999999999999999999}',
+                           '{0..3000000000}']:
+            status, stdout, stderr = common.brex(expression + '\n',
+                                                 ['--verbose'])
+            self.assertEqual(status, 9, expression)
+            self.assertEqual(stdout, '')
+            self.assertIn('range', stderr)
+
+        # Outside of a range, digits and dots are invalid characters.
+        for expression in ['1', '{1}', '{..}', 'a..b', '{+1..3}', '{1.3}']:
+            status, _, _ = common.brex(expression + '\n')
+            self.assertEqual(status, 1, expression)
+
+
+if __name__ == '__main__':
+    unittest.main()
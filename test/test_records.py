@@ -0,0 +1,135 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import unittest
+
+
+def terms(expression, flags=[]):
+    """Return the list of terms, as bytes, of the expansion of the specified
+    `expression`, as printed by brex with the specified command line `flags`.
+    """
+    status, stdout, _ = common.brex_bytes((expression + '\n').encode(),
+                                          ['--lines'] + flags)
+    assert status == 0, expression
+    return stdout.splitlines()
+
+
+def null_terminated(expression, flags=[]):
+    """Return the list of terms, as bytes, printed by brex with `-0` for the
+    specified `expression` and additional command line `flags`, checking
+    that every term is terminated by a null byte.
+    """
+    status, stdout, stderr = common.brex_bytes(
+        (expression + '\n').encode(), ['-0'] + flags)
+    assert status == 0, (expression, stderr)
+    if not stdout:
+        return []
+    assert stdout.endswith(b'\0'), stdout
+    return stdout[:-1].split(b'\0')
+
+
+def length_prefixed(expression, flags=[]):
+    """Return the list of terms, as bytes, decoded from the records printed by
+    brex with `--length-prefixed` for the specified `expression` and
+    additional command line `flags`.
+    """
+    status, stdout, stderr = common.brex_bytes(
+        (expression + '\n').encode(), ['--length-prefixed'] + flags)
+    assert status == 0, (expression, stderr)
+
+    result = []
+    position = 0
+    while position < len(stdout):
+        size = 0
+        shift = 0
+        while True:
+            byte = stdout[position]
+            position += 1
+            size |= (byte & 0x7f) << shift
+            shift += 7
+            if byte < 0x80:
+                break
+        result.append(stdout[position:position + size])
+        position += size
+    assert position == len(stdout)
+    return result
+
+
+class TestRecords(unittest.TestCase):
+    def test_random_expressions(self):
+        rng = random.Random(2020)
+        for _ in range(100):
+            expression = common.random_expression(rng)
+            expected = terms(expression)
+            self.assertEqual(null_terminated(expression), expected)
+            self.assertEqual(length_prefixed(expression), expected)
+
+    def test_output_paths(self):
+        expression = '{a,b,c}{d,e{f,g}}h'
+        expected = terms(expression)
+        for flags in [['--tree'],
+                      ['--ostream'],
+                      ['--threads', '3'],
+                      ['--buffer-size', '1']]:
+            self.assertEqual(null_terminated(expression, flags), expected,
+                             flags)
+
+    def test_ranges(self):
+        expression = '{a,b,c,d,e}{f,g,h,i,j}'
+        expected = terms(expression)
+        for flags in [[], ['--ostream'], ['--threads', '2']]:
+            self.assertEqual(
+                null_terminated(expression,
+                                ['--offset', '3', '--limit', '7'] + flags),
+                expected[3:10])
+        self.assertEqual(
+            length_prefixed(expression, ['--offset', '3', '--limit', '7']),
+            expected[3:10])
+        self.assertEqual(length_prefixed(expression, ['--nth', '24']),
+                         expected[24:])
+        self.assertEqual(null_terminated(expression, ['--offset', '25']), [])
+        self.assertEqual(length_prefixed(expression, ['--offset', '25']), [])
+
+    def test_filters_and_samples(self):
+        expression = '{a,b}{c,d}{e,f}'
+        self.assertEqual(null_terminated(expression, ['--prefix', 'ad']),
+                         [b'ade', b'adf'])
+        self.assertEqual(null_terminated(expression, ['--prefix', 'x']), [])
+        sampled = null_terminated(expression, ['--sample', '3', '--seed', '1'])
+        self.assertEqual(len(sampled), 3)
+        self.assertTrue(set(sampled) <= set(terms(expression)))
+
+    def test_long_terms(self):
+        # Terms of 128 bytes or more need a length of more than one byte.
+        expression = ('{' + 'a' * 127 + ',' + 'b' * 128 + ',' + 'c' * 20000 +
+                      '}')
+        status, stdout, _ = common.brex_bytes(
+            (expression + '\n').encode(), ['--length-prefixed'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout[:128], b'\x7f' + b'a' * 127)
+        self.assertEqual(stdout[128:131], b'\x80\x01' + b'b')
+        self.assertEqual(stdout[258:262], b'\xa0\x9c\x01' + b'c')
+        self.assertEqual(length_prefixed(expression), terms(expression))
+
+    def test_incompatible_options(self):
+        for flags in [['-0', '--count'],
+                      ['-0', '--parse'],
+                      ['-0', '--lines'],
+                      ['-0', '--front-code'],
+                      ['-0', '--decode'],
+                      ['-0', '--length-prefixed'],
+                      ['--length-prefixed', '--threads', '2'],
+                      ['--length-prefixed', '--tree'],
+                      ['--length-prefixed', '--ostream'],
+                      ['--length-prefixed', '--prefix', 'a'],
+                      ['--length-prefixed', '--sample', '1'],
+                      ['--length-prefixed', '--front-code']]:
+            status, stdout, _ = common.brex_bytes(b'a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, b'')
+
+
+if __name__ == '__main__':
+    unittest.main()
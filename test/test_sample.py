@@ -0,0 +1,124 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import collections
+import random
+import subprocess
+import unittest
+
+
+def sample(expression, count, seed, flags=[]):
+    """Return the list of terms that brex samples from the specified
+    `expression`, given the specified `count`, `seed`, and additional command
+    line `flags`.
+    """
+    status, stdout, stderr = common.brex(
+        expression + '\n',
+        ['--lines', '--sample', str(count), '--seed', str(seed)] + flags)
+    assert status == 0, (expression, stderr)
+    return stdout.splitlines()
+
+
+class TestSample(unittest.TestCase):
+    def test_random_expressions(self):
+        rng = random.Random(1717)
+        for _ in range(50):
+            expression = common.random_expression(rng)
+            all_terms = common.terms(expression)
+            count = rng.randint(1, 2 * len(all_terms))
+            seed = rng.randrange(2**64)
+
+            sampled = sample(expression, count, seed)
+            self.assertEqual(len(sampled), count)
+            self.assertTrue(set(sampled) <= set(all_terms), expression)
+
+            # Without replacement, the terms are in expansion order.
+            # Expansions can contain duplicate terms, so compare indices.
+            distinct = sample(expression, count, seed, ['--distinct'])
+            self.assertEqual(len(distinct), min(count, len(all_terms)))
+            positions = []
+            for term in distinct:
+                start = positions[-1] + 1 if positions else 0
+                positions.append(all_terms.index(term, start))
+            if count >= len(all_terms):
+                self.assertEqual(distinct, all_terms)
+
+    def test_seed(self):
+        expression = '{a,b,c,d}' * 10
+        first = sample(expression, 100, 42)
+        self.assertEqual(first, sample(expression, 100, 42))
+        self.assertNotEqual(first, sample(expression, 100, 43))
+        self.assertEqual(sample(expression, 5, 0), sample(expression, 5, 0))
+
+    def test_uniform(self):
+        # The alternation's second option has eight times as many terms as
+        # its first, so it must be chosen eight times as often.
+        expression = '{a,{b,c,d,e,f,g,h,i}}'
+        with_replacement = sample(expression, 9000, 1)
+        without_replacement = [term
+                               for seed in range(100)
+                               for term in sample(expression, 4, seed,
+                                                  ['--distinct'])]
+
+        for sampled in [with_replacement, without_replacement]:
+            counts = collections.Counter(sampled)
+            for term in 'abcdefghi':
+                self.assertAlmostEqual(counts[term] / len(sampled), 1 / 9,
+                                       delta=0.05)
+
+    def test_huge_expansion(self):
+        # There are 10**200 terms, more than could ever be expanded.
+        expression = '{a,b,c,d,e,f,g,h,i,j}' * 200
+        for flags in [[], ['--distinct']]:
+            sampled = sample(expression, 1000, 7, flags)
+            self.assertEqual(len(sampled), 1000)
+            self.assertEqual(len(set(sampled)), 1000)
+            self.assertTrue(all(len(term) == 200 for term in sampled))
+        self.assertEqual(sampled, sorted(sampled))
+
+    def test_huge_count(self):
+        # The sample is written as it's drawn, rather than collected first,
+        # so it can be larger than would fit in memory.  A distinct sample
+        # of at least every term is the whole expansion.
+        for expression, flags in [('{a,b}{c,d}', []),
+                                  ('{a,b}' * 40, ['--distinct'])]:
+            process = subprocess.Popen(
+                [common.brex_path(), '--lines', '--sample', str(10**14)] +
+                flags,
+                stdin=subprocess.PIPE,
+                stdout=subprocess.PIPE)
+            process.stdin.write((expression + '\n').encode())
+            process.stdin.close()
+            head = process.stdout.read(1 << 20).decode().splitlines()[:-1]
+            process.kill()
+            process.wait()
+            process.stdout.close()
+
+            self.assertGreater(len(head), 10000, flags)
+            if flags:
+                _, stdout, _ = common.brex(
+                    expression + '\n',
+                    ['--lines', '--limit', str(len(head))])
+                self.assertEqual(head, stdout.splitlines())
+            else:
+                self.assertEqual(set(head), set(common.terms(expression)))
+
+    def test_incompatible_options(self):
+        for flags in [['--sample', '1', '--count'],
+                      ['--sample', '1', '--limit', '1'],
+                      ['--sample', '1', '--offset', '1'],
+                      ['--sample', '1', '--threads', '2'],
+                      ['--sample', '1', '--tree'],
+                      ['--sample', '1', '--prefix', 'a'],
+                      ['--sample', '0'],
+                      ['--sample', '1', '--seed', '-1'],
+                      ['--distinct'],
+                      ['--seed', '1']]:
+            status, stdout, _ = common.brex('a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import os
+import random
+import signal
+import socket
+import subprocess
+import tempfile
+import threading
+import time
+import unittest
+
+
+def batch(input, flags=[]):
+    """Return the output, as bytes, of brex with `--batch` and the specified
+    command line `flags` given the specified `input` bytes.
+    """
+    return subprocess.run([common.brex_path(), '--batch'] + flags,
+                          input=input,
+                          capture_output=True,
+                          check=True).stdout
+
+
+class Server:
+    """A `brex --serve` process listening on a socket in a temporary
+    directory, for use in a `with` statement.
+    """
+
+    def __init__(self, flags=[]):
+        self.directory = tempfile.TemporaryDirectory(prefix='brex-test-')
+        self.path = os.path.join(self.directory.name, 'brex.sock')
+        self.process = subprocess.Popen(
+            [common.brex_path(), '--serve', self.path, '--verbose'] + flags,
+            stderr=subprocess.PIPE)
+
+        deadline = time.monotonic() + 10
+        while not os.path.exists(self.path):
+            assert self.process.poll() is None, self.process.stderr.read()
+            assert time.monotonic() < deadline
+            time.sleep(0.01)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exception):
+        if self.process.poll() is None:
+            self.process.terminate()
+        self.process.wait()
+        self.process.stderr.close()
+        self.directory.cleanup()
+
+    def connect(self):
+        """Return a new socket connected to the server.  A test fails,
+        rather than hanging, if the server stops answering.
+        """
+        client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        client.settimeout(60)
+        client.connect(self.path)
+        return client
+
+    def request(self, input):
+        """Send the specified `input` bytes on a new connection, close the
+        connection for writing, and return everything the server writes back.
+        """
+        with self.connect() as client:
+            client.sendall(input)
+            client.shutdown(socket.SHUT_WR)
+            return receive_all(client)
+
+
+def receive_all(client):
+    """Return all of the bytes received on the specified `client` socket until
+    the server closes it.
+    """
+    chunks = []
+    while True:
+        chunk = client.recv(1 << 16)
+        if not chunk:
+            return b''.join(chunks)
+        chunks.append(chunk)
+
+
+def receive_record(client):
+    """Return the next record, as bytes, received on the specified `client`
+    socket, reading one byte at a time so as not to read past it.
+    """
+    record = b''
+    while not (record.endswith(b'\n\n') and
+               (record.count(b'\n') > 2 or record[:1] != b'0')):
+        byte = client.recv(1)
+        assert byte, record
+        record += byte
+    return record
+
+
+class TestServe(unittest.TestCase):
+    def test_same_as_batch(self):
+        rng = random.Random(2022)
+        expressions = [common.random_expression(rng) for _ in range(200)]
+        expressions += ['{', 'a}', '', '{1..20}x', '{a,b}{1..3}']
+        input = ''.join(e + '\n' for e in expressions).encode()
+
+        with Server(['--threads', '2']) as server:
+            self.assertEqual(server.request(input), batch(input))
+            # The second time, every expression is in the cache.
+            self.assertEqual(server.request(input), batch(input))
+
+    def test_last_line_without_newline(self):
+        with Server() as server:
+            self.assertEqual(server.request(b'a{b,c}\nd{e,f}'),
+                             batch(b'a{b,c}\nd{e,f}'))
+            self.assertEqual(server.request(b''), b'')
+
+    def test_conversation(self):
+        # A client can wait for each record before sending the next
+        # expression, even if the expression arrives in pieces.
+        with Server() as server, server.connect() as client:
+            for expression in [b'a{b,c}', b'{1..3}', b'{', b'x{y,z}w']:
+                for i in range(len(expression)):
+                    client.sendall(expression[i:i + 1])
+                client.sendall(b'\n')
+                self.assertEqual(receive_record(client),
+                                 batch(expression + b'\n'))
+
+    def test_many_clients(self):
+        rng = random.Random(2023)
+        templates = [common.random_expression(rng) for _ in range(20)]
+        failures = []
+
+        def client(seed):
+            rng = random.Random(seed)
+            expressions = [rng.choice(templates) for _ in range(50)]
+            input = ''.join(e + '\n' for e in expressions).encode()
+            if server.request(input) != batch(input):
+                failures.append(seed)
+
+        with Server(['--threads', '3', '--cache-size', '5']) as server:
+            threads = [threading.Thread(target=client, args=(seed,))
+                       for seed in range(16)]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+        self.assertEqual(failures, [])
+
+    def test_limit_and_buffer_size(self):
+        input = b'{a,b,c}{d,e,f}{g,h}\n{1..100000}\n'
+        with Server(['--limit', '4', '--buffer-size', '7']) as server:
+            self.assertEqual(server.request(input),
+                             batch(input, ['--limit', '4']))
+        with Server(['--buffer-size', '1']) as server:
+            self.assertEqual(server.request(input), batch(input))
+
+    def test_slow_reader(self):
+        # A client that stops reading holds up only its own records.
+        with Server(['--threads', '2', '--buffer-size', '4096']) as server:
+            with server.connect() as stalled:
+                stalled.sendall(b'{1..1000000}\n')
+                time.sleep(0.1)
+                self.assertEqual(server.request(b'a{b,c}\n'),
+                                 batch(b'a{b,c}\n'))
+                stalled.shutdown(socket.SHUT_WR)
+                self.assertEqual(receive_all(stalled),
+                                 batch(b'{1..1000000}\n'))
+
+    def test_disconnecting_client(self):
+        # The worker stops expanding once the client is gone, even in the
+        # middle of an expansion that would otherwise never end.
+        for expression in [b'{1..1000000}\n', b'{a,b}' * 80 + b'\n']:
+            with Server(['--threads', '1']) as server:
+                with server.connect() as client:
+                    client.sendall(expression)
+                    client.recv(1)
+                self.assertEqual(server.request(b'a{b,c}\n'),
+                                 batch(b'a{b,c}\n'))
+
+    def test_stalled_clients(self):
+        # Clients that stop reading are dropped after a while, rather than
+        # holding up every worker for good.
+        with Server(['--threads', '2']) as server:
+            stalled = [server.connect() for _ in range(2)]
+            for client in stalled:
+                client.sendall(b'{a,b}' * 80 + b'\n')
+            self.assertEqual(server.request(b'a{b,c}\n'),
+                             batch(b'a{b,c}\n'))
+            for client in stalled:
+                client.close()
+
+    def test_endless_line(self):
+        # A line too long to buffer is answered with an error record, after
+        # which the client is disconnected.
+        with Server() as server:
+            with server.connect() as client:
+                client.sendall(b'a\n')
+                try:
+                    line = b'a' * (1 << 20)
+                    for _ in range(32):
+                        client.sendall(line)
+                except (BrokenPipeError, ConnectionResetError):
+                    pass
+                self.assertEqual(receive_record(client) +
+                                 receive_record(client),
+                                 batch(b'a\n') + b'7\n\n')
+                # The server hangs up on unread input, which resets the
+                # connection.
+                try:
+                    self.assertEqual(client.recv(1), b'')
+                except ConnectionResetError:
+                    pass
+            self.assertEqual(server.request(b'a{b,c}\n'),
+                             batch(b'a{b,c}\n'))
+
+    def test_termination(self):
+        with Server() as server:
+            server.process.send_signal(signal.SIGINT)
+            self.assertEqual(server.process.wait(timeout=10), 0)
+            self.assertFalse(os.path.exists(server.path))
+
+    def test_invalid_path(self):
+        for path in ['', '/nonexistent/brex.sock', 'x' * 200]:
+            status, stdout, stderr = common.brex('', ['--serve', path,
+                                                      '--verbose'])
+            self.assertEqual(status, 1, path)
+            self.assertEqual(stdout, '')
+            self.assertIn('socket', stderr)
+
+    def test_incompatible_options(self):
+        for flags in [['--serve', 'x', '--batch'],
+                      ['--serve', 'x', '--lines'],
+                      ['--serve', 'x', '--count'],
+                      ['--serve', 'x', '--offset', '1'],
+                      ['--serve', 'x', '--prefix', 'a'],
+                      ['--serve', 'x', '--stats'],
+                      ['--serve', 'x', '-0'],
+                      ['--serve'],
+                      ['--cache-size', '10'],
+                      ['--serve', 'x', '--cache-size', '0']]:
+            status, stdout, _ = common.brex('a\n', flags)
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import collections
+import json
+import random
+import unittest
+
+
+def node_counts(expression):
+    """Return a tuple of a `collections.Counter` of the types of the nodes in
+    the parse tree of the specified `expression`, and the tree's depth,
+    according to `brex --parse`.
+    """
+    status, stdout, _ = common.brex(expression + '\n', ['--parse'])
+    assert status == 0, expression
+
+    counts = collections.Counter()
+
+    def visit(node, depth):
+        counts[node['type']] += 1
+        return max([depth] + [visit(child, depth + 1)
+                              for child in node.get('children', [])])
+
+    depth = visit(json.loads(stdout), 1)
+    return counts, depth
+
+
+class TestStats(unittest.TestCase):
+    def assert_stats(self, expression, flags=[]):
+        """Check that `--stats` doesn't change the output of brex given the
+        specified `expression` and command line `flags`, and that the
+        statistics it prints agree with the output and the parse tree.
+        Return the statistics.
+        """
+        input = expression + '\n'
+        expected = common.brex(input, flags)
+        status, stdout, stderr = common.brex(input, flags + ['--stats'])
+        self.assertEqual(status, expected[0])
+        self.assertEqual(stdout, expected[1], (expression, flags))
+
+        stats = json.loads(stderr)
+        self.assertEqual(stats['bytes'], len(stdout.encode()))
+        if '--front-code' not in flags:
+            self.assertEqual(stats['terms'], len(stdout.split()))
+
+        counts, depth = node_counts(expression)
+        self.assertEqual(stats['nodes'], {'string': counts['STRING'],
+                                          'sequence': counts['SEQUENCE'],
+                                          'alternation':
+                                              counts['ALTERNATION'],
+                                          'range': counts['RANGE']})
+        self.assertEqual(stats['depth'], depth)
+
+        for phase in ['read', 'parse', 'build', 'expand']:
+            self.assertGreaterEqual(stats['phases'][phase]['wall'], 0)
+            self.assertGreaterEqual(stats['phases'][phase]['cpu'], 0)
+        # A tree having only one node needs no memory beyond its root.
+        self.assertGreaterEqual(stats['arena']['blocks'], 0)
+        self.assertGreaterEqual(stats['arena']['bytes'],
+                                stats['arena']['blocks'])
+        self.assertGreater(stats['peakRssKilobytes'], 0)
+        return stats
+
+    def test_random_expressions(self):
+        rng = random.Random(1919)
+        for _ in range(30):
+            self.assert_stats(common.random_expression(rng))
+
+    def test_modes(self):
+        expression = '{a,b,c}x{d,e{f,g}}{h,i}'
+        for flags in [[], ['--lines'], ['--tree'], ['--ostream'],
+                      ['--threads', '2'], ['--offset', '3'],
+                      ['--limit', '4'], ['--offset', '2', '--limit', '3'],
+                      ['--nth', '5'], ['--offset', '100'], ['--front-code'],
+                      ['--prefix', 'bx'], ['--glob', '*h'],
+                      ['--glob', 'q'], ['--sample', '7', '--seed', '1'],
+                      ['--tree', '--limit', '2']]:
+            self.assert_stats(expression, flags)
+
+    def test_large(self):
+        stats = self.assert_stats('{a,b,c,d,e,f,g,h,i,j}' * 5)
+        self.assertEqual(stats['terms'], 10**5)
+        self.assertEqual(stats['bytes'], 6 * 10**5)
+
+    def test_incompatible_options(self):
+        for flags in [['--parse'], ['--count'], ['--batch'], ['--match'],
+                      ['--decode']]:
+            status, stdout, _ = common.brex('a\n', flags + ['--stats'])
+            self.assertNotEqual(status, 0, flags)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import unittest
+
+
+class TestThreads(unittest.TestCase):
+    """Expanding with multiple threads must produce exactly the same output
+    as expanding with one.
+    """
+    def assert_same_output(self, input, flags=[]):
+        status, expected, _ = common.brex(input, flags)
+        self.assertEqual(status, 0)
+
+        for threads in [2, 3, 8]:
+            status, stdout, _ = common.brex(
+                input, ['--threads', str(threads)] + flags)
+            self.assertEqual(status, 0)
+            self.assertEqual(stdout, expected, (input, threads, flags))
+
+    def test_many_chunks(self):
+        # about seven megabytes of output, which is several chunks
+        input = '{a,b,c,d,e,f,g,h,i,j}' * 6 + '\n'
+        self.assert_same_output(input)
+        self.assert_same_output(input, ['--lines'])
+        self.assert_same_output(input, ['--offset', '12345'])
+        self.assert_same_output(input, ['--offset', '999990'])
+        self.assert_same_output(input,
+                                ['--offset', '100', '--limit', '543210'])
+
+    def test_uneven_terms(self):
+        # The first term is short, but most are long, so chunks must be
+        # sized by the longest term, which makes many more of them.
+        input = '{a,' + 'b' * 10000 + '}x{1..300}\n'
+        self.assert_same_output(input)
+        self.assert_same_output(input, ['--offset', '7', '--limit', '400'])
+
+    def test_random_expressions(self):
+        rng = random.Random(77)
+        for _ in range(20):
+            self.assert_same_output(common.random_expression(rng) + '\n')
+
+    def test_single_term(self):
+        self.assert_same_output('abc\n')
+        self.assert_same_output('{a,b}\n', ['--nth', '1'])
+
+    def test_most_threads(self):
+        status, stdout, _ = common.brex('{a,b}{1..3}\n', ['--threads', '1024'])
+        self.assertEqual((status, stdout), (0, 'a1 a2 a3 b1 b2 b3\n'))
+
+    def test_incompatible_options(self):
+        for flags in [['--tree'], ['--ostream']]:
+            status, stdout, stderr = common.brex(
+                '{a,b}\n', ['--threads', '2', '--verbose'] + flags)
+            self.assertEqual((status, stdout), (1, ''), flags)
+            self.assertIn('cannot be used', stderr)
+
+        # One thread is what these use anyway.
+        for flags in [['--tree'], ['--ostream']]:
+            self.assertEqual(
+                common.brex('{a,b}\n', ['--threads', '1'] + flags),
+                (0, 'a b\n', ''))
+
+    def test_invalid_count(self):
+        for count in ['0', '-1', '1025', '1000000', '5000000000',
+                      '99999999999999999999', 'x']:
+            status, stdout, stderr = common.brex(
+                '{a,b}\n', ['--threads', count, '--verbose'])
+            self.assertEqual((status, stdout), (1, ''), count)
+            self.assertIn('Invalid value for command line option --threads',
+                          stderr)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3.7
+
+import common
+
+import random
+import unittest
+
+
+class TestUnrank(unittest.TestCase):
+    def terms(self, input, flags=[]):
+        status, stdout, stderr = common.brex(input, ['--lines'] + flags)
+        self.assertEqual(status, 0)
+        self.assertEqual(stderr, '')
+        return stdout.split('\n')[:-1]
+
+    def assert_random_access_matches(self, input):
+        terms = self.terms(input)
+
+        for index, term in enumerate(terms):
+            self.assertEqual(self.terms(input, ['--nth', str(index)]), [term])
+
+        for offset in range(len(terms) + 1):
+            for limit in [1, 2, 5]:
+                flags = ['--offset', str(offset), '--limit', str(limit)]
+                self.assertEqual(self.terms(input, flags),
+                                 terms[offset:offset + limit])
+
+    def test_examples(self):
+        for input in ['ha{x,foo{bar,baz{zy,z}}}{a,b}',
+                      '{A,B{C,D}}',
+                      'ABC',
+                      '{a{c,d},b}{c,d}',
+                      '{ab,ab}{x,{x,y}}x{x,y}']:
+            self.assert_random_access_matches(input + '\n')
+
+    def test_random_expressions(self):
+        rng = random.Random(99)
+        for _ in range(10):
+            input = common.random_expression(rng) + '\n'
+            terms = self.terms(input)
+            for index in rng.sample(range(len(terms)), min(5, len(terms))):
+                self.assertEqual(self.terms(input, ['--nth', str(index)]),
+                                 [terms[index]])
+
+    def test_beyond_64_bits(self):
+        input = '{a,b}' * 100 + '{c,d,e}\n'
+        last = 2**100 * 3 - 1
+        self.assertEqual(self.terms(input, ['--nth', str(last)]),
+                         ['b' * 100 + 'e'])
+
+        # Index 2**99 + 2**98 + 1 selects "b" in the first two positions and
+        # "d" in the last.  Count the remaining positions in binary.
+        index = (2**99 + 2**98) * 3 + 1
+        self.assertEqual(self.terms(input, ['--nth', str(index)]),
+                         ['bb' + 'a' * 98 + 'd'])
+
+        self.assertEqual(
+            self.terms(input, ['--offset', str(last - 1), '--limit', '5']),
+            ['b' * 100 + 'd', 'b' * 100 + 'e'])
+
+    def test_out_of_range(self):
+        status, stdout, stderr = common.brex('{a,b}\n', ['--nth', '2'])
+        self.assertNotEqual(status, 0)
+        self.assertEqual(stdout, '')
+
+        status, stdout, stderr = common.brex('{a,b}\n', ['--offset', '2'])
+        self.assertEqual(status, 0)
+        self.assertEqual(stdout, '')
+
+    def test_invalid_values(self):
+        for flags in [['--nth', '-1'], ['--offset', 'x'], ['--limit', '0'],
+                      ['--nth'], ['--tree', '--nth', '1'],
+                      ['--nth', '1', '--limit', '2'],
+                      ['--limit', '2', '--nth', '1'],
+                      ['--nth', '1', '--offset', '0'],
+                      ['--offset', '0', '--nth', '1']]:
+            status, stdout, _ = common.brex('{a,b}\n', flags)
+            self.assertNotEqual(status, 0)
+            self.assertEqual(stdout, '')
+
+
+if __name__ == '__main__':
+    unittest.main()